@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - configuration dialog                                                *
  *                                                                              *
- * modified: 2025-03-13                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -25,6 +25,7 @@
 #include "../appsettings.h"
 #include "../palettefactory.h"
 #include <fitsip/core/db/database.h>
+#include <fitsip/core/io/iofactory.h>
 #include <QFileDialog>
 #include <QStyleFactory>
 #include <QSettings>
@@ -68,6 +69,14 @@ void ConfigurationDialog::commitFields(AppSettings &settings)
   settings.setPalette(ui->paletteBox->currentText());
   settings.setAlwaysSaveFits(ui->alwaysSaveFitsBox->isChecked());
   settings.setWriteMetadataFile(ui->saveMetadataBox->isChecked());
+  if (settings.isRawCFAImport() != ui->rawCFABox->isChecked())
+  {
+    /* cached raw images were decoded in the other mode */
+    settings.setRawCFAImport(ui->rawCFABox->isChecked());
+    IOFactory::getInstance()->getImageCache()->clear();
+  }
+  settings.setImageCacheSize(ui->imageCacheBox->value());
+  IOFactory::getInstance()->getImageCache()->setBudget(static_cast<uint64_t>(ui->imageCacheBox->value())*1024*1024);
   if (ui->fitsDoubleButton->isChecked())
 
     settings.setFitsImageFormat(0);
@@ -101,6 +110,8 @@ void ConfigurationDialog::updateFields(const AppSettings &settings)
   ui->paletteBox->setCurrentText(settings.getPalette());
   ui->alwaysSaveFitsBox->setChecked(settings.isAlwaysSaveFits());
   ui->saveMetadataBox->setChecked(settings.isWriteMetadataFile());
+  ui->rawCFABox->setChecked(settings.isRawCFAImport());
+  ui->imageCacheBox->setValue(settings.getImageCacheSize());
   switch (settings.getFitsImageFormat())
   {
     case 0:
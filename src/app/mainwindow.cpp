@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - main application window                                             *
  *                                                                              *
- * modified: 2025-11-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -53,10 +53,13 @@
 #include <fitsip/core/pixellist.h>
 #include <fitsip/core/dialogs/pluginfilelistreturndialog.h>
 #include <fitsip/core/dialogs/plugininfodialog.h>
+#include <fitsip/core/dialogs/progressdialog.h>
 #include <fitsip/core/dialogs/twovaluedialog.h>
 #include <fitsip/core/io/iofactory.h>
+#include <fitsip/core/io/imageloader.h>
 #include <fitsip/core/logbook/logbookutils.h>
 #include <fitsip/core/opplugin.h>
+#include <fitsip/core/pipeline.h>
 #include <fitsip/core/psf/psffactory.h>
 #include "fitsip/core/psf/psfmanagerdialog.h"
 #include <fitsip/core/pluginfactory.h>
@@ -84,7 +87,9 @@ MainWindow::MainWindow(QWidget *parent):QMainWindow(parent),
   editMetadataDialog(nullptr),
   selectionMode(None),
   psfManager(nullptr),
-  sysinfoDialog(nullptr)
+  sysinfoDialog(nullptr),
+  loadProgress(nullptr),
+  loadErrors(0)
 {
   ui->setupUi(this);
   AppSettings settings;
@@ -238,6 +243,12 @@ MainWindow::MainWindow(QWidget *parent):QMainWindow(parent),
 
   connect(IOFactory::getInstance(),&IOFactory::logProfilerResult,profilerWidget->getModel(),&ProfilerTableModel::addProfilerResult);
 
+  imageLoader = new ImageLoader(this);
+  connect(imageLoader,&ImageLoader::imageLoaded,this,&MainWindow::imageLoaded);
+  connect(imageLoader,&ImageLoader::loadFailed,this,&MainWindow::imageLoadFailed);
+  connect(imageLoader,&ImageLoader::progress,this,&MainWindow::imageLoadProgress);
+  connect(imageLoader,&ImageLoader::finished,this,&MainWindow::imageLoadFinished);
+
   QActionGroup* grp = new QActionGroup(this);
   ui->actionTable->setActionGroup(grp);
   ui->actionBy_Date->setActionGroup(grp);
@@ -309,6 +320,7 @@ void MainWindow::initialize(PluginFactory* factory)
   {
     ui->actionRun_Script->setEnabled(true);
     connect(consoleWidget,&ConsoleWidget::consoleCommand,this,&MainWindow::runScriptCmd);
+    connect(script.get(),&Script::finished,this,&MainWindow::scriptFinished);
     setScriptOutput();
   }
 }
@@ -530,7 +542,7 @@ void MainWindow::executeOpPlugin(OpPlugin *op)
   {
     qDebug() << "Executing: " << op->getMenuEntry();
     activeFile->pushUndo();
-    ui->actionUndo->setEnabled(activeFile->isUndoAvailable());
+    ui->actionUndo->setEnabled(activeFile->isUndoAvailable() && !(script && script->isRunning()));
     executeOpPlugin(op,activeFile,data);
   }
   else if (!op->requiresImage())
@@ -809,12 +821,109 @@ void MainWindow::openImage(const QFileInfo &fileinfo)
   }
 }
 
+void MainWindow::openImages(const std::vector<QFileInfo>& files)
+{
+  if (files.size() == 1)
+  {
+    openImage(files.front());
+    return;
+  }
+  int loaded = 0;
+  for (const QFileInfo& file : files)
+  {
+    if (imageCollection->getFile(file.absoluteFilePath())) ++loaded;
+  }
+  bool reload = true;
+  if (loaded > 0)
+  {
+    reload = QMessageBox::question(this,QApplication::applicationDisplayName(),
+                                   QString("%1 of the images are already open!\nLoad them again?").arg(loaded)) == QMessageBox::Yes;
+  }
+  std::vector<QFileInfo> list;
+  for (const QFileInfo& file : files)
+  {
+    if (reload || !imageCollection->getFile(file.absoluteFilePath())) list.push_back(file);
+  }
+  if (list.empty()) return;
+  QSettings settings;
+  settings.setValue(AppSettings::PATH_IMAGE,list.front().absolutePath());
+  if (!loadProgress)
+  {
+    loadProgress = new ProgressDialog(this);
+    loadProgress->setTitle("Opening images");
+    connect(loadProgress,&ProgressDialog::cancelRequested,imageLoader,&ImageLoader::cancel);
+    loadProgress->show();
+    loadErrors = 0;
+  }
+  ui->openFileList->selectionModel()->clearSelection();
+  imageLoader->setMemoryBudget(static_cast<uint64_t>(AppSettings().getLoaderMemoryBudget())*1024*1024);
+  imageLoader->load(list);
+}
+
+void MainWindow::imageLoaded(const QString& filename, const std::vector<std::shared_ptr<FitsObject>>& images)
+{
+  for (const std::shared_ptr<FitsObject>& obj : images)
+  {
+    imageCollection->addFile(obj);
+    if (AppSettings().isLogbookLogOpen())
+      logbook.add(LogbookEntry::Op,obj->getImage().getName(),"Loaded from file "+filename);
+  }
+  if (loadProgress) loadProgress->appendMessage(QFileInfo(filename).fileName()+(images.empty()?" - no images":" - Success"));
+}
+
+void MainWindow::imageLoadFailed(const QString& filename, const QString& error)
+{
+  if (loadProgress) loadProgress->appendMessage(QFileInfo(filename).fileName()+" - Error: "+error);
+  ++loadErrors;
+  qCritical() << filename << error;
+}
+
+void MainWindow::imageLoadProgress(int done, int total)
+{
+  if (loadProgress)
+  {
+    loadProgress->setMaximum(total);
+    loadProgress->setProgress(done);
+  }
+}
+
+void MainWindow::imageLoadFinished()
+{
+  if (loadProgress)
+  {
+    if (loadErrors > 0)
+    {
+      /* the dialog stays open until the errors have been read */
+      loadProgress->appendMessage(QString("%1 file(s) could not be opened").arg(loadErrors));
+      connect(loadProgress,&QDialog::finished,loadProgress,&QObject::deleteLater);
+      loadProgress->setFinished();
+    }
+    else
+    {
+      loadProgress->deleteLater();
+    }
+    loadProgress = nullptr;
+  }
+  if (imageCollection->rowCount() > 0)
+  {
+    ui->openFileList->selectionModel()->setCurrentIndex(imageCollection->index(imageCollection->rowCount()-1,0),QItemSelectionModel::SelectCurrent);
+    imageCollection->setActiveFile(imageCollection->rowCount()-1);
+    display(imageCollection->getActiveFile());
+  }
+}
+
 void MainWindow::openSelection()
 {
+  std::vector<QFileInfo> images;
   for (const QString& file : filesystemView->getSelectedFiles())
   {
-    open(QFileInfo(file));
+    QFileInfo info(file);
+    if (IOFactory::getInstance()->isImage(info.absoluteFilePath()))
+      images.push_back(info);
+    else
+      openExternal(info);
   }
+  if (!images.empty()) openImages(images);
 }
 
 void MainWindow::copySelectionToList()
@@ -848,7 +957,7 @@ void MainWindow::fileListDoubleClicked(int index)
 void MainWindow::fileListOpenSelected()
 {
   std::vector<QFileInfo> list = filelistWidget->getSelection();
-  for (const QFileInfo& file : list) openImage(file);
+  if (!list.empty()) openImages(list);
 }
 
 void MainWindow::openLogbook(const QString &name)
@@ -951,32 +1060,40 @@ void MainWindow::runScriptCmd(const QString& cmd)
   try
   {
     script->runCmd(cmd);
+    setBusy(true);
   }
   catch (std::exception &ex)
   {
     QMessageBox::warning(this,QApplication::applicationDisplayName(),ex.what());
     qCritical() << ex.what();
+    if (!script->isRunning()) consoleWidget->setMode(QConsoleWidget::Input);
   }
-  consoleWidget->setMode(QConsoleWidget::Input);
-  std::shared_ptr<FitsObject> activeFile = imageCollection->getActiveFile();
-  if (activeFile) activeFile->updateHistogram();
-  updateDisplay();
 }
 
 void MainWindow::runScriptFile(const QFileInfo& fileinfo)
 {
+  if (fileinfo.suffix() != "py") return;
   consoleWidget->setMode(QConsoleWidget::Output);
   try
   {
-    if (fileinfo.suffix() == "py")
-    {
-      script->runFile(fileinfo.absoluteFilePath());
-    }
+    script->runFile(fileinfo.absoluteFilePath());
+    setBusy(true);
   }
   catch (std::exception &ex)
   {
     QMessageBox::warning(this,QApplication::applicationDisplayName(),ex.what());
     qCritical() << ex.what();
+    if (!script->isRunning()) consoleWidget->setMode(QConsoleWidget::Input);
+  }
+}
+
+void MainWindow::scriptFinished(bool ok, const QString& error)
+{
+  setBusy(false);
+  if (!ok)
+  {
+    QMessageBox::warning(this,QApplication::applicationDisplayName(),error);
+    qCritical() << error;
   }
   consoleWidget->setMode(QConsoleWidget::Input);
   std::shared_ptr<FitsObject> activeFile = imageCollection->getActiveFile();
@@ -984,6 +1101,31 @@ void MainWindow::runScriptFile(const QFileInfo& fileinfo)
   updateDisplay();
 }
 
+/*
+ * A running script works on the open images from its own thread without
+ * any lock, a running pipeline uses the plugins from its worker threads.
+ * Everything in the GUI reading or modifying the images or starting a
+ * plugin is disabled until the script or pipeline has finished; the
+ * display is updated then.
+ */
+void MainWindow::setBusy(bool busy)
+{
+  bool enabled = !busy;
+  for (const PluginMenuEntry& entry : pluginMenus) entry.action->setEnabled(enabled);
+  for (QAction* action : {ui->actionRun_Script,ui->actionRun_Pipeline,ui->actionSave,ui->actionSave_As,ui->actionSave_As_PSF,
+                          ui->actionExport_Image,ui->actionClose_Image,ui->actionClose_All_Images,ui->actionNext_Image,
+                          ui->actionPrevious_Image,ui->actionAdd_Current_Image_to_List,ui->actionProperties,ui->actionMetadata,
+                          ui->actionClear_AOI,ui->actionSelect_Pixel})
+  {
+    action->setEnabled(enabled);
+  }
+  /* undo is enabled again by updateDisplay() if available */
+  if (busy) ui->actionUndo->setEnabled(false);
+  ui->openFileList->setEnabled(enabled);
+  imageWidget->setEnabled(enabled);
+  histogramWidget->setEnabled(enabled);
+}
+
 void MainWindow::setScriptOutput()
 {
   if (scriptOutConnection) disconnect(scriptOutConnection);
@@ -1035,23 +1177,14 @@ std::shared_ptr<FitsObject> MainWindow::load(const std::string& filename)
   {
     fileinfo = QFileInfo(filesystemView->getRoot()+"/"+QString::fromStdString(filename));
   }
-  IOHandler* handler = IOFactory::getInstance()->getHandler(fileinfo.absoluteFilePath());
-  if (handler)
+  try
   {
-    try
-    {
-      auto images = handler->read(fileinfo.absoluteFilePath());
-      /* TODO: Handle multiple images loaded from a single file */
-      return images.front();
-    }
-    catch (std::exception& ex)
-    {
-      qCritical() << ex.what();
-    }
+    /* TODO: Handle multiple images loaded from a single file */
+    return std::make_shared<FitsObject>(IOFactory::getInstance()->loadImage(fileinfo.absoluteFilePath()),fileinfo.absoluteFilePath());
   }
-  else
+  catch (std::exception& ex)
   {
-    qWarning() << "No IOHandler for " << fileinfo.absoluteFilePath();
+    qCritical() << ex.what();
   }
   return std::shared_ptr<FitsObject>();
 }
@@ -1231,7 +1364,7 @@ void MainWindow::on_actionUndo_triggered()
     activeFile->popUndo();
     logbook.add(LogbookEntry::Op,activeFile->getImage().getName(),"Undo last operation");
     updateDisplay();
-    ui->actionUndo->setEnabled(activeFile->isUndoAvailable());
+    ui->actionUndo->setEnabled(activeFile->isUndoAvailable() && !(script && script->isRunning()));
   }
 }
 
@@ -1455,6 +1588,58 @@ void MainWindow::on_actionRun_Script_triggered()
   }
 }
 
+void MainWindow::on_actionRun_Pipeline_triggered()
+{
+  AppSettings settings;
+  QString fn = settings.getOpenFilename(this,AppSettings::PATH_SCRIPT,"Pipeline Recipe (*.json)");
+  if (fn.isNull()) return;
+  std::vector<QFileInfo> files = getFileList();
+  if (files.empty())
+  {
+    QMessageBox::warning(this,QApplication::applicationDisplayName(),"Pipeline requires a list of files!");
+    return;
+  }
+  Pipeline pipeline(pluginFactory);
+  try
+  {
+    pipeline.load(fn);
+  }
+  catch (const std::exception& ex)
+  {
+    QMessageBox::warning(this,QApplication::applicationDisplayName(),ex.what());
+    return;
+  }
+  ProgressDialog* prog = new ProgressDialog(this);
+  prog->setTitle(pipeline.getName());
+  prog->show();
+  connect(&pipeline,&Pipeline::message,prog,&ProgressDialog::appendMessage);
+  connect(&pipeline,&Pipeline::progress,prog,[&pipeline,prog](int done, int total){
+    prog->setMaximum(total);
+    prog->setProgress(done);
+    if (prog->isCancelled()) pipeline.cancel();
+  });
+  /* the run processes events while it waits for its workers */
+  setBusy(true);
+  bool ok = pipeline.run(files);
+  setBusy(false);
+  prog->deleteLater();
+  if (!ok)
+  {
+    QMessageBox::warning(this,QApplication::applicationDisplayName(),"Pipeline execution error!\n"+pipeline.getError());
+  }
+  for (const QFileInfo& info : pipeline.getWrittenFiles()) qInfo() << "Pipeline wrote" << info.absoluteFilePath();
+  if (!pipeline.getResults().empty())
+  {
+    for (const auto& obj : pipeline.getResults()) imageCollection->addFile(obj);
+    imageCollection->setActiveFile(imageCollection->rowCount()-1);
+    display(imageCollection->getActiveFile());
+  }
+  else if (imageCollection->getActiveFile())
+  {
+    ui->actionUndo->setEnabled(imageCollection->getActiveFile()->isUndoAvailable());
+  }
+}
+
 void MainWindow::on_actionSave_As_PSF_triggered()
 {
   std::shared_ptr<FitsObject> activeFile = imageCollection->getActiveFile();
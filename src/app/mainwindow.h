@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - main application window                                             *
  *                                                                              *
- * modified: 2025-11-01                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -52,11 +52,13 @@ class FileListWidget;
 class FileSystemView;
 class HistogramView;
 class HistoryTableWidget;
+class ImageLoader;
 class LogbookWidget;
 class LogWidget;
 class MetadataTableWidget;
 class PSFManagerDialog;
 class PixelListWidget;
+class ProgressDialog;
 class ProfilerWidget;
 class ProfileView;
 class StarListWidget;
@@ -177,6 +179,8 @@ private slots:
 
   void on_actionRun_Script_triggered();
 
+  void on_actionRun_Pipeline_triggered();
+
   void on_actionSave_As_PSF_triggered();
 
   void on_actionPSF_Manager_triggered();
@@ -201,6 +205,11 @@ private:
   void openExternal(const QFileInfo& fileinfo);
   void copyImage();
   void openImage(const QFileInfo& fileinfo);
+  void openImages(const std::vector<QFileInfo>& files);
+  void imageLoaded(const QString& filename, const std::vector<std::shared_ptr<FitsObject>>& images);
+  void imageLoadFailed(const QString& filename, const QString& error);
+  void imageLoadProgress(int done, int total);
+  void imageLoadFinished();
   void openSelection();
   void copySelectionToList();
   void fileListDoubleClicked(int index);
@@ -208,6 +217,8 @@ private:
   void openLogbook(const QString& name);
   void runScriptCmd(const QString& cmd);
   void runScriptFile(const QFileInfo& fileinfo);
+  void scriptFinished(bool ok, const QString& error);
+  void setBusy(bool busy);
   void setScriptOutput();
   void getStarlistFromPixellist();
   void toggleXYChartDisplay(bool flag);
@@ -245,6 +256,9 @@ private:
   PSFManagerDialog* psfManager;
   SysInfoDialog* sysinfoDialog;
   std::unique_ptr<Script> script;
+  ImageLoader* imageLoader;
+  ProgressDialog* loadProgress;
+  int loadErrors;
   QMetaObject::Connection scriptOutConnection;
   QMetaObject::Connection scriptErrConnection;
 };
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - python scripting                                                    *
  *                                                                              *
- * modified: 2025-05-30                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -28,43 +28,134 @@
 #include <fitsip/core/kernel.h>
 #include <fitsip/core/kernelrepository.h>
 #include <fitsip/core/opplugin.h>
+#include <fitsip/core/pipeline.h>
 #include <fitsip/core/pluginfactory.h>
 #include <fitsip/core/scriptutilities.h>
 #include <iostream>
 #include <functional>
-#include <QApplication>
+#include <QCoreApplication>
+#include <QDir>
 #include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <pybind11/numpy.h>
 #include <pybind11/stl.h>
 
 PYBIND11_EMBEDDED_MODULE(fits, m) {
   m.attr("scriptpath") = "";
 }
 
+using ValueArray = py::array_t<ValueType,py::array::c_style|py::array::forcecast>;
+
+/*
+ * NumPy view of a layer sharing the memory of the layer. The array holds
+ * a reference to the pixel data, so the memory stays valid when the image
+ * is replaced; the array is then no longer connected to the image.
+ */
+static py::array layerArray(Layer& layer)
+{
+  py::capsule base(new std::shared_ptr<void>(layer.shareData()),[](void* p){ delete static_cast<std::shared_ptr<void>*>(p); });
+  return py::array_t<ValueType>({layer.getHeight(),layer.getWidth()},
+                                {static_cast<py::ssize_t>(layer.getWidth()*sizeof(ValueType)),static_cast<py::ssize_t>(sizeof(ValueType))},
+                                layer.getData(),base);
+}
+
+/*
+ * Create an image from an array of shape (height,width) or
+ * (depth,height,width). C contiguous, writeable arrays of the ValueType
+ * dtype are used without copying; all others are converted.
+ */
+static FitsImage arrayImage(const std::string& name, py::array array)
+{
+  if (array.ndim() != 2 && array.ndim() != 3)
+  {
+    throw std::invalid_argument("array must have the shape (height,width) or (depth,height,width)");
+  }
+  ValueArray values = ValueArray::ensure(array);
+  if (!values) throw py::error_already_set();
+  if (!values.writeable()) values = ValueArray(values.attr("copy")());
+  int depth = values.ndim() == 3 ? static_cast<int>(values.shape(0)) : 1;
+  int height = static_cast<int>(values.shape(values.ndim()-2));
+  int width = static_cast<int>(values.shape(values.ndim()-1));
+  /* the array may outlive the interpreter inside an image; it is only released while python is alive */
+  std::shared_ptr<void> owner(new py::object(values),[](void* p){
+    if (Py_IsInitialized())
+    {
+      py::gil_scoped_acquire gil;
+      delete static_cast<py::object*>(p);
+    }
+  });
+  std::vector<Layer> layers;
+  layers.reserve(depth);
+  for (int d=0;d<depth;++d)
+  {
+    layers.emplace_back(width,height,values.mutable_data()+static_cast<size_t>(d)*width*height,owner);
+  }
+  return FitsImage(QString::fromStdString(name),std::move(layers));
+}
+
+/*
+ * Hand an object created by a script over to the GUI thread; objects which
+ * belong to another thread already are left alone.
+ */
+static void adoptObject(const std::shared_ptr<FitsObject>& obj, QThread* thread)
+{
+  if (obj && obj->getPixelList()->thread() == QThread::currentThread()) obj->moveToThread(thread);
+}
+
 
 
 void PythonScript::runCmd(const QString& cmd)
 {
 //  std::cout << "python: " << cmd.toStdString() << std::endl;
-  auto fits_module = py::module_::import("fits");
-  fits_module.attr("scriptpath") = "";
-  py::exec(cmd.toStdString());
+  std::string command = cmd.toStdString();
+  start([command](){
+    auto fits_module = py::module_::import("fits");
+    fits_module.attr("scriptpath") = "";
+    py::exec(command);
+  });
 }
 
 void PythonScript::runFile(const QString& filename)
 {
   QFileInfo info(filename);
-  auto fits_module = py::module_::import("fits");
-  fits_module.attr("scriptpath") = info.absolutePath().toStdString();
-  py::eval_file(filename.toStdString());
+  std::string path = info.absolutePath().toStdString();
+  std::string file = filename.toStdString();
+  start([path,file](){
+    auto fits_module = py::module_::import("fits");
+    fits_module.attr("scriptpath") = path;
+    py::eval_file(file);
+  });
 }
 
-PythonScript::PythonScript(ScriptInterface *intf, PluginFactory* plugins)
+bool PythonScript::isRunning() const
 {
-  init(intf,plugins);
+  return running;
+}
+
+PythonScript::PythonScript(ScriptInterface *intf, PluginFactory* plugins):
+  interpreterContext(new QObject),
+  running(false)
+{
+  interpreterThread.setObjectName("python");
+  interpreterContext->moveToThread(&interpreterThread);
+  connect(&interpreterThread,&QThread::finished,interpreterContext,&QObject::deleteLater);
+  interpreterThread.start();
+  try
+  {
+    invokeInterpreter([=](){ init(intf,plugins); });
+  }
+  catch (...)
+  {
+    shutdown();
+    throw;
+  }
 }
 
 PythonScript::~PythonScript()
 {
+  shutdown();
 }
 
 void PythonScript::init(ScriptInterface* intf, PluginFactory* plugins)
@@ -75,20 +166,110 @@ void PythonScript::init(ScriptInterface* intf, PluginFactory* plugins)
   redirect(pybind11::cpp_function([this](const char* s){streamStderr(s);}),"stderr");
   auto m = py::module_::import("fits");
   bind(m,intf);
+  bindBatch(m,intf,plugins);
   plugins->setPythonBinding(&m);
   py::exec("import fits");
+  idle.reset(new py::gil_scoped_release);
+}
+
+void PythonScript::shutdown()
+{
+  /* interrupt a running script; the GUI calls it makes until it stops
+     must still be served */
+  while (running)
+  {
+    PyErr_SetInterrupt();
+    QCoreApplication::processEvents(QEventLoop::AllEvents,50);
+    QThread::msleep(10);
+  }
+  invokeInterpreter([this](){
+    idle.reset();
+    terp.reset();
+  });
+  interpreterThread.quit();
+  interpreterThread.wait();
+}
+
+void PythonScript::start(std::function<void()> job)
+{
+  if (running.exchange(true)) throw std::runtime_error("a script is already running");
+  QMetaObject::invokeMethod(interpreterContext,[this,job](){
+    bool ok = true;
+    QString error;
+    idle.reset();
+    try
+    {
+      job();
+    }
+    catch (const std::exception& ex)
+    {
+      ok = false;
+      error = ex.what();
+    }
+    idle.reset(new py::gil_scoped_release);
+    running = false;
+    emit finished(ok,error);
+  },Qt::QueuedConnection);
+}
+
+void PythonScript::invokeInterpreter(std::function<void()> job)
+{
+  /* exceptions are passed as plain messages, python errors must not
+     leave the interpreter thread */
+  std::string error;
+  QMetaObject::invokeMethod(interpreterContext,[&](){
+    try
+    {
+      job();
+    }
+    catch (const std::exception& ex)
+    {
+      error = ex.what();
+      if (error.empty()) error = "python error";
+    }
+  },Qt::BlockingQueuedConnection);
+  if (!error.empty()) throw std::runtime_error(error);
+}
+
+void PythonScript::invokeGui(std::function<void()> f)
+{
+  if (QThread::currentThread() == thread())
+  {
+    f();
+    return;
+  }
+  std::exception_ptr error;
+  {
+    py::gil_scoped_release release;
+    QMetaObject::invokeMethod(this,[&](){
+      try
+      {
+        f();
+      }
+      catch (...)
+      {
+        error = std::current_exception();
+      }
+    },Qt::BlockingQueuedConnection);
+  }
+  if (error) std::rethrow_exception(error);
+}
+
+template <typename T> T PythonScript::invokeGui(std::function<T()> f)
+{
+  T result{};
+  invokeGui(std::function<void()>([&](){ result = f(); }));
+  return result;
 }
 
 void PythonScript::streamStdout(const char* s)
 {
   emit stdoutAvailable(s);
-  QApplication::processEvents();
 }
 
 void PythonScript::streamStderr(const char* s)
 {
   emit stderrAvailable(s);
-  QApplication::processEvents();
 }
 
 
@@ -119,25 +300,30 @@ sys.") + pipe + std::string(" = type(\"\",(object,),{\"write\":lambda self, txt:
 
 void PythonScript::bind(py::module_& m, ScriptInterface* intf)
 {
-  m.def("display",[intf](std::shared_ptr<FitsObject> obj){intf->display(obj);},
+  /* the interface belongs to the GUI, calls are executed there */
+  m.def("display",[this,intf](std::shared_ptr<FitsObject> obj){
+      adoptObject(obj,thread());
+      invokeGui([=](){intf->display(obj);});
+    },
     "Display an image",py::arg("obj"));
-  m.def("get_cwd",[intf](){return intf->getWorkingDir();},
+  m.def("get_cwd",[this,intf](){return invokeGui<std::string>([=](){return intf->getWorkingDir();});},
     "Get the current working directory");
-  m.def("get",[intf](const std::string& filename){return intf->get(filename);},
+  m.def("get",[this,intf](const std::string& filename){return invokeGui<std::shared_ptr<FitsObject>>([=](){return intf->get(filename);});},
       "Get an already opened image from the display list",py::arg("filename"));
-  m.def("get_open",[intf](){return intf->getOpen();},
+  m.def("get_open",[this,intf](){return invokeGui<std::vector<std::shared_ptr<FitsObject>>>([=](){return intf->getOpen();});},
       "Get an already opened image from the display list");
-  m.def("get_selected",[intf](){return intf->getSelectedFileList();},
+  m.def("get_selected",[this,intf](){return invokeGui<FileList*>([=](){return intf->getSelectedFileList();});},
       "Get the list ocontainer of selected files");
-  m.def("load",[intf](const std::string& filename){return intf->load(filename);},
+  m.def("load",[this,intf](const std::string& filename){return invokeGui<std::shared_ptr<FitsObject>>([=](){return intf->load(filename);});},
       "Load an image from disk",py::arg("filename"));
-  m.def("save",[intf](std::shared_ptr<FitsObject> obj){return intf->save(obj,obj->getFilename().toStdString());},
+  m.def("save",[this,intf](std::shared_ptr<FitsObject> obj){return invokeGui<bool>([=](){return intf->save(obj,obj->getFilename().toStdString());});},
     "Save an image under the name it was loaded with",py::arg("obj"));
-  m.def("save",[intf](std::shared_ptr<FitsObject> obj, const std::string& filename){return intf->save(obj,filename);},
+  m.def("save",[this,intf](std::shared_ptr<FitsObject> obj, const std::string& filename){return invokeGui<bool>([=](){return intf->save(obj,filename);});},
     "Save an image under a new name",py::arg("obj"),py::arg("filename"));
-  m.def("set_cwd",[intf](const std::string& dir){intf->setWorkingDir(dir);},
+  m.def("set_cwd",[this,intf](const std::string& dir){invokeGui([=](){intf->setWorkingDir(dir);});},
     "Set the current working directory");
 
+  bindImage(m);
   bindFitsObject(m);
   bindLists(m,intf);
   bindKernel(m);
@@ -152,7 +338,7 @@ void PythonScript::bind(py::module_& m, ScriptInterface* intf)
       ;
 
   m.def("copy",[](std::shared_ptr<FitsObject> obj, const std::string& filename){return obj->copy(filename);},
-      "Copy an image",py::arg("obj"),py::arg("filename"));
+      "Copy an image",py::arg("obj"),py::arg("filename"),py::call_guard<py::gil_scoped_release>());
 }
 
 void PythonScript::bindLists(py::module_& m, ScriptInterface* intf)
@@ -165,18 +351,145 @@ void PythonScript::bindLists(py::module_& m, ScriptInterface* intf)
           for (const QFileInfo& i : list.getFiles()) l.push_back(i.absoluteFilePath().toStdString());
           return l;
         },"Return list of files")
-      .def("add",[intf](FileList& list, const std::string& file){
+      .def("add",[this,intf](FileList& list, const std::string& file){
           QFileInfo info(QString::fromStdString(file));
-          if (!info.isAbsolute()) info = QFileInfo(QString::fromStdString(intf->getWorkingDir()+"/"+file));
+          if (!info.isAbsolute()) info = QFileInfo(QString::fromStdString(invokeGui<std::string>([=](){return intf->getWorkingDir();})+"/"+file));
           list.addFile(info);},
           "Add a file to the list",py::arg("file"))
       ;
 }
 
+void PythonScript::bindBatch(py::module_& m, ScriptInterface* intf, PluginFactory* plugins)
+{
+  m.def("map_files",[this,intf,plugins](const std::vector<std::string>& files, py::list ops, const std::string& outputDir,
+                                       int threads, const std::string& suffix, const std::string& format){
+      /* the operations are run as a recipe of the processing pipeline */
+      QJsonArray steps;
+      for (py::handle op : ops)
+      {
+        QJsonObject step;
+        if (py::isinstance<py::str>(op))
+        {
+          step["op"] = QString::fromStdString(op.cast<std::string>());
+        }
+        else
+        {
+          py::sequence entry = op.cast<py::sequence>();
+          if (entry.size() != 2) throw py::value_error("operations must be given as name or (name,params)");
+          step["op"] = QString::fromStdString(entry[0].cast<std::string>());
+          QJsonObject params;
+          for (auto item : entry[1].cast<py::dict>())
+          {
+            QString key = QString::fromStdString(py::str(item.first).cast<std::string>());
+            if (py::isinstance<py::bool_>(item.second))
+              params[key] = item.second.cast<bool>();
+            else if (py::isinstance<py::int_>(item.second) || py::isinstance<py::float_>(item.second))
+              params[key] = item.second.cast<double>();
+            else
+              params[key] = QString::fromStdString(py::str(item.second).cast<std::string>());
+          }
+          step["params"] = params;
+        }
+        steps.append(step);
+      }
+      QJsonObject recipe;
+      recipe["steps"] = steps;
+      Pipeline pipeline(plugins);
+      pipeline.parse(QJsonDocument(recipe).toJson());
+      QDir cwd(QString::fromStdString(invokeGui<std::string>([=](){return intf->getWorkingDir();})));
+      pipeline.setOutputDir(cwd.absoluteFilePath(QString::fromStdString(outputDir)));
+      pipeline.setOutputSuffix(QString::fromStdString(suffix));
+      pipeline.setOutputFormat(QString::fromStdString(format));
+      pipeline.setThreadCount(threads);
+      std::vector<QFileInfo> list;
+      for (const std::string& file : files)
+      {
+        list.push_back(QFileInfo(cwd.absoluteFilePath(QString::fromStdString(file))));
+        if (suffix.empty() && list.back().absoluteDir() == QDir(pipeline.getOutputDir()))
+        {
+          throw py::value_error("a suffix is required when writing to the directory of the input files");
+        }
+      }
+      bool ok;
+      {
+        py::gil_scoped_release release;
+        ok = pipeline.run(list);
+      }
+      if (!ok) throw std::runtime_error(pipeline.getError().toStdString());
+      py::list result;
+      for (const Pipeline::FrameReport& report : pipeline.getFrameReports())
+      {
+        std::vector<std::string> outputs;
+        for (const QString& fn : report.outputs) outputs.push_back(fn.toStdString());
+        py::dict d;
+        d["file"] = report.name.toStdString();
+        d["ok"] = report.ok;
+        d["error"] = report.error.toStdString();
+        d["time"] = report.time*1.0e-6;
+        d["outputs"] = py::cast(outputs);
+        result.append(d);
+      }
+      return result;
+    },
+    "Apply a list of operations, each given as class name or (class name,parameters), to files in parallel and write the results to a directory;"
+    " returns a dict with file, ok, error, time [s] and outputs per file",
+    py::arg("files"),py::arg("ops"),py::arg("output_dir"),py::arg("threads")=0,py::arg("suffix")="",py::arg("format")="fts");
+}
+
+void PythonScript::bindImage(py::module_& m)
+{
+  py::class_<FitsImage>(m,"FitsImage","Image")
+      .def(py::init([](py::array array, const std::string& name){ return new FitsImage(arrayImage(name,array)); }),
+          "Create an image from an array of shape (height,width) or (depth,height,width); the memory is shared if possible",
+          py::arg("array"),py::arg("name")="")
+      .def_property_readonly("name",[](const FitsImage& img){ return img.getName().toStdString(); })
+      .def_property_readonly("width",&FitsImage::getWidth)
+      .def_property_readonly("height",&FitsImage::getHeight)
+      .def_property_readonly("depth",&FitsImage::getDepth)
+      .def("layer",[](FitsImage& img, int index){
+            if (index < 0 || index >= img.getDepth()) throw py::index_error("layer index out of range");
+            return layerArray(img.getLayer(index));
+          },
+          "Get a layer as 2D array sharing the memory of the image; after the image has been replaced the array keeps the old pixels",
+          py::arg("index"))
+      ;
+}
+
 void PythonScript::bindFitsObject(py::module_& m)
 {
   py::class_<FitsObject, std::shared_ptr<FitsObject>>(m,"FitsObject","Fits Object")
       .def(py::init<const FitsImage&, const std::string&>())
+      .def(py::init([](py::array array, const std::string& filename){
+            QString fn = QString::fromStdString(filename);
+            return std::make_shared<FitsObject>(arrayImage(QFileInfo(fn).fileName().toStdString(),array),fn);
+          }),
+          "Create an image from an array of shape (height,width) or (depth,height,width); the memory is shared if possible",
+          py::arg("array"),py::arg("filename")="")
+      .def("layer",[](FitsObject& obj, int index){
+            if (index < 0 || index >= obj.getImage().getDepth()) throw py::index_error("layer index out of range");
+            return layerArray(obj.getImage().getLayer(index));
+          },
+          "Get a layer as 2D array sharing the memory of the image; after the image has been replaced the array keeps the old pixels",
+          py::arg("index")=0)
+      .def_property_readonly("layers",[](FitsObject& obj){
+            py::list list;
+            for (int i=0;i<obj.getImage().getDepth();++i) list.append(layerArray(obj.getImage().getLayer(i)));
+            return list;
+          },
+          "Arrays of all layers sharing the memory of the image")
+      .def("to_array",[](const FitsObject& obj){
+            const FitsImage& img = obj.getImage();
+            ValueArray array({img.getDepth(),img.getHeight(),img.getWidth()});
+            size_t n = static_cast<size_t>(img.getWidth())*img.getHeight();
+            for (int i=0;i<img.getDepth();++i) std::copy_n(img.getLayer(i).getData(),n,array.mutable_data()+i*n);
+            return array;
+          },
+          "Copy the image to an array of shape (depth,height,width)")
+      .def("set_array",[](FitsObject& obj, py::array array){
+            obj.setImage(arrayImage(obj.getImage().getName().toStdString(),array));
+          },
+          "Replace the image by an array of shape (height,width) or (depth,height,width)",py::arg("array"))
+      .def_property_readonly("image",[](FitsObject& obj){ return &obj.getImage(); },py::return_value_policy::reference_internal)
       .def_property_readonly("id",&FitsObject::getId)
       .def_property_readonly("name",[](const FitsObject& obj){return obj.getName().toStdString();})
       .def_property_readonly("filename",[](const FitsObject& obj){return obj.getFilename().toStdString();})
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - python scripting                                                    *
  *                                                                              *
- * modified: 2025-02-19                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -24,7 +24,10 @@
 #define PYTHONSCRIPT_H
 
 #include "script.h"
+#include <atomic>
+#include <functional>
 #include <memory>
+#include <QThread>
 
 class PluginFactory;
 class ScriptInterface;
@@ -47,18 +50,33 @@ public:
 
   virtual void runFile(const QString& filename) override;
 
+  virtual bool isRunning() const override;
+
 private:
   void init(ScriptInterface* intf, PluginFactory* plugins);
+  void shutdown();
+  void start(std::function<void()> job);
+  void invokeInterpreter(std::function<void()> job);
+  void invokeGui(std::function<void()> f);
+  template <typename T> T invokeGui(std::function<T()> f);
   void streamStdout(const char* s);
   void streamStderr(const char* s);
   void redirect(py::object, const char* pipe);
   void bind(py::module_& m, ScriptInterface* intf);
+  void bindImage(py::module_& m);
   void bindFitsObject(py::module_& m);
   void bindLists(py::module_& m, ScriptInterface* intf);
+  void bindBatch(py::module_& m, ScriptInterface* intf, PluginFactory* plugins);
   void bindKernel(py::module_& m);
   void bindStatistics(py::module_& m);
 
+  /* the interpreter lives on its own thread; between jobs that thread does
+     not hold the GIL so that threads started by scripts keep running */
+  QThread interpreterThread;
+  QObject* interpreterContext;
+  std::atomic<bool> running;
   std::unique_ptr<py::scoped_interpreter> terp;
+  std::unique_ptr<py::gil_scoped_release> idle;
 
 };
 
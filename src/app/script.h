@@ -10,13 +10,22 @@ class Script: public QObject
 public:
   Script();
 
+  /**
+   * @brief Start executing a command; finished() is emitted when done.
+   */
   virtual void runCmd(const QString& cmd) = 0;
 
+  /**
+   * @brief Start executing a script file; finished() is emitted when done.
+   */
   virtual void runFile(const QString& filename) = 0;
 
+  virtual bool isRunning() const = 0;
+
 signals:
   void stdoutAvailable(QString s);
   void stderrAvailable(QString s);
+  void finished(bool ok, QString error);
 
 };
 
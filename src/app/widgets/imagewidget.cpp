@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - widget to display the actual image                                  *
  *                                                                              *
- * modified: 2025-10-23                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -133,7 +133,7 @@ QRect ImageWidget::getAOI() const
   return aoi;
 }
 
-void ImageWidget::paintEvent(QPaintEvent* /*event*/)
+void ImageWidget::paintEvent(QPaintEvent* event)
 {
   AppSettings settings;
   QPainter p(this);
@@ -148,8 +148,8 @@ void ImageWidget::paintEvent(QPaintEvent* /*event*/)
     p.drawImage(imageRect,image);
 //    drawRectangle(p,dragStart,dragStop);
     drawAOI(p);
-    if (pixellist && settings.isShowPixellist()) drawPixelList(p);
-    if (starlist && settings.isShowStarlist()) drawStarList(p);
+    if (pixellist && settings.isShowPixellist()) drawPixelList(p,event->rect());
+    if (starlist && settings.isShowStarlist()) drawStarList(p,event->rect());
   }
 }
 
@@ -238,13 +238,27 @@ void ImageWidget::drawAOI(QPainter &p)
   p.restore();
 }
 
-void ImageWidget::drawPixelList(QPainter& p)
+/*
+ * Maps a region of the widget, enlarged by a margin in widget pixels, to
+ * image coordinates. Only markers inside this area need to be drawn.
+ */
+QRectF ImageWidget::toImage(const QRect& region, int margin) const
+{
+  double scale = static_cast<double>(image.width()) / static_cast<double>(imageRect.width());
+  QRectF r = QRectF(region.adjusted(-margin,-margin,margin,margin));
+  r.translate(-imageRect.topLeft());
+  return QRectF(r.topLeft()*scale/zoomFactor,r.bottomRight()*scale/zoomFactor);
+}
+
+void ImageWidget::drawPixelList(QPainter& p, const QRect& region)
 {
   p.save();
   p.setPen(Qt::red);
   double scale = static_cast<double>(image.width()) / static_cast<double>(imageRect.width());
-  for (const Pixel& pixel : pixellist->getPixels())
+  const std::vector<Pixel>& pixels = pixellist->getPixels();
+  for (size_t i : pixellist->getIndex().findInRect(toImage(region,6)))
   {
+    const Pixel& pixel = pixels[i];
     QPoint pt = QPoint(pixel.x,pixel.y) / scale * zoomFactor + imageRect.topLeft();
     p.drawLine(pt-QPoint(5,0),pt+QPoint(5,0));
     p.drawLine(pt-QPoint(0,5),pt+QPoint(0,5));
@@ -252,13 +266,16 @@ void ImageWidget::drawPixelList(QPainter& p)
   p.restore();
 }
 
-void ImageWidget::drawStarList(QPainter& p)
+void ImageWidget::drawStarList(QPainter& p, const QRect& region)
 {
   p.save();
   p.setPen(Qt::green);
   double scale = static_cast<double>(image.width()) / static_cast<double>(imageRect.width());
-  for (const Star& star :starlist->getStars())
+  const std::vector<Star>& stars = starlist->getStars();
+  /* the margin covers the circles of stars centered outside the region */
+  for (size_t i : starlist->getIndex().findInRect(toImage(region,64)))
   {
+    const Star& star = stars[i];
     QPointF pt = QPointF(star.getX(),star.getY()) / scale * zoomFactor + imageRect.topLeft();
     double r = star.getFWHM() / 2 / scale;
     if (r < 1) r = 2;
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - widget to display the actual image                                  *
  *                                                                              *
- * modified: 2025-03-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -72,8 +72,9 @@ protected:
 private:
 //  void drawRectangle(QPainter& p, QPoint start, QPoint stop);
   void drawAOI(QPainter& p);
-  void drawPixelList(QPainter& p);
-  void drawStarList(QPainter& p);
+  void drawPixelList(QPainter& p, const QRect& region);
+  void drawStarList(QPainter& p, const QRect& region);
+  QRectF toImage(const QRect& region, int margin) const;
 
   QCursor cursor;
   QImage image;
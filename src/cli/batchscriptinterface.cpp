@@ -0,0 +1,111 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - headless script interface                                           *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "batchscriptinterface.h"
+#include <fitsip/core/io/iofactory.h>
+#include <QDebug>
+#include <QDir>
+#include <QFileInfo>
+#include <algorithm>
+
+BatchScriptInterface::BatchScriptInterface():
+  workingDir(QDir::currentPath()),
+  fileList(std::make_unique<FileList>())
+{
+}
+
+BatchScriptInterface::~BatchScriptInterface()
+{
+}
+
+void BatchScriptInterface::setWorkingDir(const std::string& dir)
+{
+  workingDir = absolutePath(dir);
+}
+
+std::string BatchScriptInterface::getWorkingDir() const
+{
+  return workingDir.toStdString();
+}
+
+std::shared_ptr<FitsObject> BatchScriptInterface::get(const std::string& filename)
+{
+  QString fn = absolutePath(filename);
+  for (const auto& obj : open)
+  {
+    if (obj->getFilename() == fn) return obj;
+  }
+  return std::shared_ptr<FitsObject>();
+}
+
+const std::vector<std::shared_ptr<FitsObject>>& BatchScriptInterface::getOpen() const
+{
+  return open;
+}
+
+std::shared_ptr<FitsObject> BatchScriptInterface::load(const std::string& filename)
+{
+  QString fn = absolutePath(filename);
+  try
+  {
+    return std::make_shared<FitsObject>(IOFactory::getInstance()->loadImage(fn),fn);
+  }
+  catch (std::exception& ex)
+  {
+    qCritical() << ex.what();
+  }
+  return std::shared_ptr<FitsObject>();
+}
+
+bool BatchScriptInterface::save(std::shared_ptr<FitsObject> obj, const std::string& filename)
+{
+  try
+  {
+    obj->save(absolutePath(filename));
+  }
+  catch (std::exception& ex)
+  {
+    qCritical() << ex.what();
+    return false;
+  }
+  return true;
+}
+
+void BatchScriptInterface::display(std::shared_ptr<FitsObject> obj)
+{
+  if (obj && std::find(open.begin(),open.end(),obj) == open.end()) open.push_back(obj);
+}
+
+FileList* BatchScriptInterface::getSelectedFileList() const
+{
+  return fileList.get();
+}
+
+QString BatchScriptInterface::absolutePath(const std::string& filename) const
+{
+  QFileInfo fileinfo(QString::fromStdString(filename));
+  if (!fileinfo.isAbsolute())
+  {
+    fileinfo = QFileInfo(workingDir+"/"+QString::fromStdString(filename));
+  }
+  return fileinfo.absoluteFilePath();
+}
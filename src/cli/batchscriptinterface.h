@@ -0,0 +1,67 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - headless script interface                                           *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef BATCHSCRIPTINTERFACE_H
+#define BATCHSCRIPTINTERFACE_H
+
+#include <app/scriptinterface.h>
+#include <QString>
+#include <memory>
+
+/**
+ * @brief Script interface used by the command line runner.
+ *
+ * Images are loaded and saved relative to the working directory; there is no
+ * display, so display() just keeps a reference to the image in the list of
+ * open images.
+ */
+class BatchScriptInterface: public ScriptInterface
+{
+public:
+  BatchScriptInterface();
+  virtual ~BatchScriptInterface();
+
+  virtual void setWorkingDir(const std::string& dir) override;
+
+  virtual std::string getWorkingDir() const override;
+
+  virtual std::shared_ptr<FitsObject> get(const std::string& filename) override;
+
+  virtual const std::vector<std::shared_ptr<FitsObject>>& getOpen() const override;
+
+  virtual std::shared_ptr<FitsObject> load(const std::string& filename) override;
+
+  virtual bool save(std::shared_ptr<FitsObject> obj, const std::string& filename) override;
+
+  virtual void display(std::shared_ptr<FitsObject> obj) override;
+
+  virtual FileList* getSelectedFileList() const override;
+
+private:
+  QString absolutePath(const std::string& filename) const;
+
+  QString workingDir;
+  std::vector<std::shared_ptr<FitsObject>> open;
+  std::unique_ptr<FileList> fileList;
+};
+
+#endif // BATCHSCRIPTINTERFACE_H
@@ -0,0 +1,360 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - command line batch runner                                           *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "batchscriptinterface.h"
+#include <fitsip/core/fitsobject.h>
+#include <fitsip/core/opplugin.h>
+#include <fitsip/core/pipeline.h>
+#include <fitsip/core/pluginfactory.h>
+#include <fitsip/core/io/iofactory.h>
+#include <fitsip/core/io/iohandler.h>
+#ifdef USE_PYTHON
+#include <app/pythonscript.h>
+#endif
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QEventLoop>
+#include <QFile>
+#include <QFileInfo>
+#include <QTextStream>
+#include <QThreadPool>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+static bool verbose = false;
+
+static void msgHandler(const QtMsgType type, const QMessageLogContext& /*context*/, const QString &message)
+{
+  if (type == QtDebugMsg && !verbose) return;
+  std::cerr << message.toStdString() << std::endl;
+}
+
+/*
+ * Parse "key=value" pairs into the parameter map; returns false on a
+ * malformed entry.
+ */
+static bool addParameter(QVariantMap& params, const QString& s)
+{
+  int i = s.indexOf('=');
+  if (i <= 0)
+  {
+    std::cerr << "invalid parameter '" << s.toStdString() << "' (expected key=value)" << std::endl;
+    return false;
+  }
+  params[s.left(i).trimmed().toLower()] = s.mid(i+1).trimmed();
+  return true;
+}
+
+static bool readParameterFile(QVariantMap& params, const QString& filename)
+{
+  QFile file(filename);
+  if (!file.open(QFile::ReadOnly|QFile::Text))
+  {
+    std::cerr << "cannot read parameter file " << filename.toStdString() << std::endl;
+    return false;
+  }
+  QTextStream s(&file);
+  while (!s.atEnd())
+  {
+    QString line = s.readLine().trimmed();
+    if (line.isEmpty() || line.startsWith('#')) continue;
+    if (!addParameter(params,line)) return false;
+  }
+  return true;
+}
+
+static void listPlugins(PluginFactory* plugins)
+{
+  for (OpPlugin* p : plugins->getOpPlugins())
+  {
+    if (!p->supportsBatch()) continue;
+    std::cout << p->metaObject()->className() << "  (" << p->getMenuEntry().remove("...").toStdString() << ")"
+              << (p->requiresFileList() ? "  [file list]" : "") << std::endl;
+    for (const QString& s : p->getBatchParameters())
+    {
+      std::cout << "    " << s.toStdString() << std::endl;
+    }
+  }
+}
+
+static OpPlugin* findPlugin(PluginFactory* plugins, const QString& name)
+{
+  for (OpPlugin* p : plugins->getOpPlugins())
+  {
+    if (name.compare(p->metaObject()->className(),Qt::CaseInsensitive) == 0) return p;
+  }
+  return nullptr;
+}
+
+/*
+ * Build the output file name for an input file. The output may be a
+ * directory (default: directory of the input) or, for a single result, a
+ * file name.
+ */
+static QString outputFilename(const QString& output, bool single, const QFileInfo& input, const QString& suffix, const QString& format)
+{
+  if (single && !output.isEmpty() && !QFileInfo(output).isDir()) return QFileInfo(output).absoluteFilePath();
+  QDir dir(output.isEmpty() ? input.absolutePath() : output);
+  return dir.absoluteFilePath(input.completeBaseName()+suffix+"."+format);
+}
+
+static bool write(const FitsObject& obj, const QString& filename)
+{
+  IOHandler* handler = IOFactory::getInstance()->getHandler(filename);
+  if (!handler)
+  {
+    std::cerr << "no writer for " << filename.toStdString() << std::endl;
+    return false;
+  }
+  try
+  {
+    if (handler->write(filename,obj))
+    {
+      std::cout << filename.toStdString() << std::endl;
+      return true;
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << ex.what() << std::endl;
+  }
+  std::cerr << "failed to write " << filename.toStdString() << std::endl;
+  return false;
+}
+
+static int runPlugin(OpPlugin* plugin, const std::vector<QFileInfo>& files, const QVariantMap& params,
+                     const QString& output, const QString& suffix, const QString& format)
+{
+  if (!plugin->supportsBatch())
+  {
+    std::cerr << plugin->metaObject()->className() << " cannot be run without user interaction" << std::endl;
+    return 1;
+  }
+  if (plugin->requiresFileList())
+  {
+    if (plugin->executeBatch(files,params) != OpPlugin::OK)
+    {
+      std::cerr << plugin->getError().toStdString() << std::endl;
+      return 1;
+    }
+    auto created = plugin->getCreatedImages();
+    int ret = 0;
+    for (const auto& obj : created)
+    {
+      QFileInfo info(files.empty() ? obj->getName() : files.front().absoluteFilePath());
+      if (created.size() > 1 || files.empty()) info = QFileInfo(info.absolutePath()+"/"+obj->getName());
+      if (!write(*obj,outputFilename(output,created.size() == 1,info,suffix,format))) ret = 1;
+    }
+    return ret;
+  }
+  int ret = 0;
+  for (const QFileInfo& info : files)
+  {
+    QString fn = outputFilename(output,files.size() == 1,info,suffix,format);
+    if (fn == info.absoluteFilePath())
+    {
+      std::cerr << "refusing to overwrite " << fn.toStdString() << " (use --output or --suffix)" << std::endl;
+      ret = 1;
+      continue;
+    }
+    try
+    {
+      /* every file is processed once */
+      auto obj = std::make_shared<FitsObject>(IOFactory::getInstance()->loadImage(info.absoluteFilePath(),IOFactory::ReadOnce),info.absoluteFilePath());
+      if (plugin->executeBatch(obj,params) != OpPlugin::OK)
+      {
+        std::cerr << info.fileName().toStdString() << ": " << plugin->getError().toStdString() << std::endl;
+        ret = 1;
+        continue;
+      }
+      if (!write(*obj,fn)) ret = 1;
+    }
+    catch (const std::exception& ex)
+    {
+      std::cerr << info.fileName().toStdString() << ": " << ex.what() << std::endl;
+      ret = 1;
+    }
+  }
+  return ret;
+}
+
+static int runPipeline(PluginFactory* plugins, const QCommandLineParser& parser, const std::vector<QFileInfo>& files)
+{
+  Pipeline pipeline(plugins);
+  try
+  {
+    pipeline.load(parser.value("pipeline"));
+  }
+  catch (const std::exception& ex)
+  {
+    std::cerr << ex.what() << std::endl;
+    return 1;
+  }
+  if (parser.isSet("output")) pipeline.setOutputDir(parser.value("output"));
+  if (pipeline.getOutputDir().isEmpty()) pipeline.setOutputDir(QDir::currentPath());
+  if (parser.isSet("suffix")) pipeline.setOutputSuffix(parser.value("suffix"));
+  if (parser.isSet("format")) pipeline.setOutputFormat(parser.value("format"));
+  if (parser.isSet("checkpoint")) pipeline.setCheckpointDir(parser.value("checkpoint"));
+  QObject::connect(&pipeline,&Pipeline::message,[](QString msg){ std::cerr << msg.toStdString() << std::endl; });
+  bool ok = pipeline.run(files);
+  for (const QFileInfo& info : pipeline.getWrittenFiles()) std::cout << info.absoluteFilePath().toStdString() << std::endl;
+  if (!ok)
+  {
+    std::cerr << pipeline.getError().toStdString() << std::endl;
+    return 1;
+  }
+  return 0;
+}
+
+#ifdef USE_PYTHON
+static int runScript(PluginFactory* plugins, const QString& filename, const std::vector<QFileInfo>& files)
+{
+  BatchScriptInterface intf;
+  intf.getSelectedFileList()->setFiles(files);
+  PythonScript script(&intf,plugins);
+  QObject::connect(&script,&Script::stdoutAvailable,[](QString s){ std::cout << s.toStdString() << std::flush; });
+  QObject::connect(&script,&Script::stderrAvailable,[](QString s){ std::cerr << s.toStdString() << std::flush; });
+  /* the script runs on the interpreter thread, output and completion are
+     delivered through the event loop */
+  QEventLoop loop;
+  bool ok = false;
+  QObject::connect(&script,&Script::finished,&loop,[&](bool success, QString error){
+    ok = success;
+    if (!ok) std::cerr << error.toStdString() << std::endl;
+    loop.quit();
+  });
+  script.runFile(QFileInfo(filename).absoluteFilePath());
+  loop.exec();
+  return ok ? 0 : 1;
+}
+#endif
+
+int main(int argc, char* argv[])
+{
+  /* plugins create their (unused) dialogs on construction, so a QApplication
+     is needed; the offscreen platform makes it work without a display */
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM","offscreen");
+  QCoreApplication::setOrganizationName("hbr");
+  QCoreApplication::setApplicationName("fits");
+  QCoreApplication::setApplicationVersion(QString("%1.%2.%3").arg(FITS_VERSION_MAJOR).arg(FITS_VERSION_MINOR).arg(FITS_VERSION_PATCH));
+  QApplication a(argc, argv);
+
+  QCommandLineParser parser;
+  parser.setApplicationDescription("Run FitsIP operations without user interface");
+  parser.addHelpOption();
+  parser.addVersionOption();
+  parser.addOption({"list","List the operations available in batch mode and their parameters."});
+  parser.addOption({{"o","op"},"Operation to execute (class name, see --list).","name"});
+  parser.addOption({{"p","param"},"Operation parameter; may be given multiple times.","key=value"});
+  parser.addOption({"params","Read operation parameters from a file with key=value lines.","file"});
+  parser.addOption({"output","Output directory, or output file for a single result.","path"});
+  parser.addOption({"suffix","Suffix appended to the output file names.","suffix"});
+  parser.addOption({"format","Output file format.","suffix","fts"});
+  parser.addOption({"threads","Maximum number of worker threads.","n"});
+  parser.addOption({"pipeline","Execute a processing recipe (JSON) on the input files.","file"});
+  parser.addOption({"checkpoint","Checkpoint directory for --pipeline.","path"});
+  parser.addOption({"script","Execute a python script; the input files are available as the selected file list.","file"});
+  parser.addOption({{"v","verbose"},"Print debug messages."});
+  parser.addPositionalArgument("files","Input files.","[files...]");
+  parser.process(a);
+
+  verbose = parser.isSet("verbose");
+  qInstallMessageHandler(msgHandler);
+  if (parser.isSet("threads")) QThreadPool::globalInstance()->setMaxThreadCount(std::max(1,parser.value("threads").toInt()));
+
+  QVariantMap params;
+  if (parser.isSet("params") && !readParameterFile(params,parser.value("params"))) return 1;
+  for (const QString& s : parser.values("param"))
+  {
+    if (!addParameter(params,s)) return 1;
+  }
+  std::vector<QFileInfo> files;
+  for (const QString& s : parser.positionalArguments())
+  {
+    QFileInfo info(s);
+    if (!info.exists())
+    {
+      std::cerr << "file not found: " << s.toStdString() << std::endl;
+      return 1;
+    }
+    files.push_back(info);
+  }
+
+  IOFactory::getInstance();
+  auto plugins = std::make_unique<PluginFactory>();
+  if (verbose)
+  {
+    QObject::connect(plugins.get(),&PluginFactory::logOperation,[](QString image, QString op){
+      std::cout << image.toStdString() << ": " << op.toStdString() << std::endl;
+    });
+    QObject::connect(plugins.get(),&PluginFactory::logProfilerResult,[](QString profiler, QString image, int w, int h, int64_t t, QString){
+      std::cout << profiler.toStdString() << " " << image.toStdString() << " " << w << "x" << h << " " << t/1000.0 << "ms" << std::endl;
+    });
+  }
+
+  int ret = 0;
+  if (parser.isSet("list"))
+  {
+    listPlugins(plugins.get());
+  }
+  else if (parser.isSet("pipeline"))
+  {
+    ret = runPipeline(plugins.get(),parser,files);
+  }
+  else if (parser.isSet("script"))
+  {
+#ifdef USE_PYTHON
+    ret = runScript(plugins.get(),parser.value("script"),files);
+#else
+    std::cerr << "python support not available" << std::endl;
+    ret = 1;
+#endif
+  }
+  else if (parser.isSet("op"))
+  {
+    OpPlugin* plugin = findPlugin(plugins.get(),parser.value("op"));
+    if (!plugin)
+    {
+      std::cerr << "unknown operation " << parser.value("op").toStdString() << std::endl;
+      ret = 1;
+    }
+    else if (files.empty())
+    {
+      std::cerr << "no input files" << std::endl;
+      ret = 1;
+    }
+    else
+    {
+      QString output = parser.value("output");
+      if (!output.isEmpty() && (files.size() > 1 || output.endsWith('/')) && !plugin->requiresFileList()) QDir().mkpath(output);
+      ret = runPlugin(plugin,files,params,output,parser.value("suffix"),parser.value("format"));
+    }
+  }
+  else
+  {
+    parser.showHelp(1);
+  }
+  qInstallMessageHandler(nullptr);
+  return ret;
+}
@@ -0,0 +1,465 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - mesh based sky background and noise map                             *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "backgroundmap.h"
+#include "parallel.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+
+  /* Natural cubic spline through the nodes of one axis, evaluated at every
+     integer position of the axis. The value at position p is
+       a[p]*y[k] + b[p]*y[k+1] + c[p]*m[k] + d[p]*m[k+1]
+     with k = index[p] and m the second derivatives at the nodes. Outside of
+     the nodes the spline is continued linearly. */
+  class SplineAxis
+  {
+  public:
+    SplineAxis(const std::vector<double>& nodes, int size);
+
+    /* calculate the second derivatives for count independent splines; the
+       values of node i start at y+i*stride */
+    void solve(const double* y, double* m, size_t stride, int count) const;
+
+    int getNodeCount() const { return static_cast<int>(x.size()); }
+
+    std::vector<int> index;
+    std::vector<double> a;
+    std::vector<double> b;
+    std::vector<double> c;
+    std::vector<double> d;
+
+  private:
+    std::vector<double> x;
+    std::vector<double> cp;      // LU decomposition of the tridiagonal system
+    std::vector<double> denom;
+  };
+
+  SplineAxis::SplineAxis(const std::vector<double>& nodes, int size):
+    index(size,0),
+    a(size,1.0),
+    b(size,0.0),
+    c(size,0.0),
+    d(size,0.0),
+    x(nodes),
+    cp(nodes.size(),0.0),
+    denom(nodes.size(),1.0)
+  {
+    int n = static_cast<int>(x.size());
+    if (n < 2) return;
+    for (int i=1;i<n-1;i++)
+    {
+      double h0 = x[i] - x[i-1];
+      double h1 = x[i+1] - x[i];
+      denom[i] = 2.0 * (h0 + h1) - (i > 1 ? h0 * cp[i-1] : 0.0);
+      cp[i] = h1 / denom[i];
+    }
+    int k = 0;
+    for (int p=0;p<size;p++)
+    {
+      while (k < n - 2 && p > x[k+1]) k++;
+      double h = x[k+1] - x[k];
+      index[p] = k;
+      if (p < x[0])
+      {
+        double t = (p - x[0]) / h;
+        a[p] = 1.0 - t;
+        b[p] = t;
+        d[p] = -(p - x[0]) * h / 6.0;
+      }
+      else if (p > x[n-1])
+      {
+        double t = (p - x[n-1]) / h;
+        a[p] = -t;
+        b[p] = 1.0 + t;
+        c[p] = (p - x[n-1]) * h / 6.0;
+      }
+      else
+      {
+        double t = (p - x[k]) / h;
+        double u = 1.0 - t;
+        a[p] = u;
+        b[p] = t;
+        c[p] = (u * u * u - u) * h * h / 6.0;
+        d[p] = (t * t * t - t) * h * h / 6.0;
+      }
+    }
+  }
+
+  void SplineAxis::solve(const double* y, double* m, size_t stride, int count) const
+  {
+    int n = static_cast<int>(x.size());
+    for (int j=0;j<count;j++)
+    {
+      m[j] = 0;
+      m[(n-1)*stride+j] = 0;
+    }
+    if (n < 3) return;
+    /* forward substitution */
+    for (int i=1;i<n-1;i++)
+    {
+      double h0 = x[i] - x[i-1];
+      double h1 = x[i+1] - x[i];
+      const double* y0 = y + (i - 1) * stride;
+      const double* y1 = y + i * stride;
+      const double* y2 = y + (i + 1) * stride;
+      const double* mp = m + (i - 1) * stride;
+      double* mi = m + i * stride;
+      for (int j=0;j<count;j++)
+      {
+        double rhs = 6.0 * ((y2[j] - y1[j]) / h1 - (y1[j] - y0[j]) / h0);
+        if (i > 1) rhs -= h0 * mp[j];
+        mi[j] = rhs / denom[i];
+      }
+    }
+    /* back substitution */
+    for (int i=n-3;i>0;i--)
+    {
+      const double* mn = m + (i + 1) * stride;
+      double* mi = m + i * stride;
+      for (int j=0;j<count;j++) mi[j] -= cp[i] * mn[j];
+    }
+  }
+
+  /* the node positions are the centers of the mesh cells */
+  std::vector<double> cellCenters(int cells, int size)
+  {
+    std::vector<double> x(cells);
+    for (int i=0;i<cells;i++)
+    {
+      int x0 = i * size / cells;
+      int x1 = (i + 1) * size / cells;
+      x[i] = 0.5 * (x0 + x1 - 1);
+    }
+    return x;
+  }
+
+  double median(std::vector<double> values)
+  {
+    if (values.empty()) return 0;
+    auto mid = values.begin() + values.size() / 2;
+    std::nth_element(values.begin(),mid,values.end());
+    return *mid;
+  }
+
+}
+
+BackgroundMap::BackgroundMap():
+  meshSize(64),
+  filterSize(3),
+  clipSigma(3.0),
+  clipIterations(5)
+{
+}
+
+void BackgroundMap::setMeshSize(int size)
+{
+  if (size < 8) throw std::invalid_argument("background mesh size must be at least 8 pixels");
+  meshSize = size;
+}
+
+int BackgroundMap::getMeshSize() const
+{
+  return meshSize;
+}
+
+void BackgroundMap::setFilterSize(int size)
+{
+  if (size < 1 || size % 2 == 0) throw std::invalid_argument("background filter size must be a positive odd number");
+  filterSize = size;
+}
+
+int BackgroundMap::getFilterSize() const
+{
+  return filterSize;
+}
+
+void BackgroundMap::setClipping(double sigma, int iterations)
+{
+  if (sigma <= 0 || iterations < 1) throw std::invalid_argument("invalid sigma clipping parameters");
+  clipSigma = sigma;
+  clipIterations = iterations;
+}
+
+void BackgroundMap::build(const FitsImage& image)
+{
+  int depth = image.getDepth();
+  background = FitsImage("background",image.getWidth(),image.getHeight(),depth);
+  rms = FitsImage("background_rms",image.getWidth(),image.getHeight(),depth);
+  globalBackground.assign(depth,0.0);
+  globalRMS.assign(depth,0.0);
+  for (int l=0;l<depth;l++)
+  {
+    Mesh mesh = computeMesh(image.getLayer(l));
+    globalBackground[l] = median(mesh.background);
+    globalRMS[l] = median(mesh.rms);
+    interpolate(mesh.background,mesh.nx,mesh.ny,background.getLayer(l));
+    interpolate(mesh.rms,mesh.nx,mesh.ny,rms.getLayer(l));
+  }
+}
+
+bool BackgroundMap::isEmpty() const
+{
+  return !background;
+}
+
+const FitsImage& BackgroundMap::getBackground() const
+{
+  return background;
+}
+
+const FitsImage& BackgroundMap::getRMS() const
+{
+  return rms;
+}
+
+double BackgroundMap::getGlobalBackground(int layer) const
+{
+  return globalBackground.at(layer);
+}
+
+double BackgroundMap::getGlobalRMS(int layer) const
+{
+  return globalRMS.at(layer);
+}
+
+void BackgroundMap::subtract(FitsImage& image) const
+{
+  if (image.getWidth() != background.getWidth() || image.getHeight() != background.getHeight() ||
+      image.getDepth() != background.getDepth())
+  {
+    throw std::invalid_argument("image does not match the background map");
+  }
+  image -= background;
+}
+
+BackgroundMap::Mesh BackgroundMap::computeMesh(const Layer& layer) const
+{
+  int w = layer.getWidth();
+  int h = layer.getHeight();
+  Mesh mesh;
+  mesh.nx = std::max(1,(w+meshSize/2)/meshSize);
+  mesh.ny = std::max(1,(h+meshSize/2)/meshSize);
+  int n = mesh.nx * mesh.ny;
+  mesh.background.assign(n,0.0);
+  mesh.rms.assign(n,0.0);
+  std::vector<char> valid(n,0);
+  const ValueType* data = layer.getData();
+  parallel::forRange(n,[&](int c0, int c1){
+    std::vector<ValueType> values;
+    for (int cell=c0;cell<c1;cell++)
+    {
+      int i = cell % mesh.nx;
+      int j = cell / mesh.nx;
+      int x0 = i * w / mesh.nx;
+      int x1 = (i + 1) * w / mesh.nx;
+      int y0 = j * h / mesh.ny;
+      int y1 = (j + 1) * h / mesh.ny;
+      values.clear();
+      for (int y=y0;y<y1;y++)
+      {
+        const ValueType* p = data + static_cast<size_t>(y) * w;
+        for (int x=x0;x<x1;x++)
+        {
+          if (std::isfinite(p[x])) values.push_back(p[x]);
+        }
+      }
+      size_t count = values.size();
+      if (count == 0) continue;
+      double mean = 0;
+      double med = 0;
+      double sigma = 0;
+      for (int iter=0;;iter++)
+      {
+        auto mid = values.begin() + values.size() / 2;
+        std::nth_element(values.begin(),mid,values.end());
+        med = *mid;
+        double sum = 0;
+        double sum2 = 0;
+        for (ValueType v : values)
+        {
+          sum += v;
+          sum2 += static_cast<double>(v) * v;
+        }
+        mean = sum / values.size();
+        sigma = std::sqrt(std::max(0.0,sum2/values.size()-mean*mean));
+        if (iter == clipIterations || sigma == 0) break;
+        double lo = med - clipSigma * sigma;
+        double hi = med + clipSigma * sigma;
+        size_t size = values.size();
+        values.erase(std::remove_if(values.begin(),values.end(),[lo,hi](ValueType v){ return v < lo || v > hi; }),values.end());
+        if (values.size() == size || values.empty()) break;
+      }
+      /* cells, which lost most of their pixels, are dominated by objects */
+      if (values.size() < count / 4) continue;
+      /* mode estimate for a skewed distribution (as used by SExtractor) */
+      if (sigma > 0 && std::fabs(mean - med) < 0.3 * sigma)
+        mesh.background[cell] = 2.5 * med - 1.5 * mean;
+      else
+        mesh.background[cell] = med;
+      mesh.rms[cell] = sigma;
+      valid[cell] = 1;
+    }
+  });
+  if (std::find(valid.begin(),valid.end(),1) == valid.end())
+  {
+    throw std::runtime_error("no valid background mesh cells found");
+  }
+  fillMesh(mesh.background,valid,mesh.nx,mesh.ny);
+  fillMesh(mesh.rms,valid,mesh.nx,mesh.ny);
+  mesh.background = filterMesh(mesh.background,mesh.nx,mesh.ny);
+  mesh.rms = filterMesh(mesh.rms,mesh.nx,mesh.ny);
+  return mesh;
+}
+
+void BackgroundMap::fillMesh(std::vector<double>& values, const std::vector<char>& valid, int nx, int ny) const
+{
+  /* replace invalid cells by the mean of their valid neighbours, growing
+     from the valid cells inwards */
+  std::vector<char> done(valid);
+  bool missing = true;
+  while (missing)
+  {
+    missing = false;
+    std::vector<char> next(done);
+    for (int j=0;j<ny;j++)
+    {
+      for (int i=0;i<nx;i++)
+      {
+        if (done[j*nx+i]) continue;
+        double sum = 0;
+        int count = 0;
+        for (int jj=std::max(0,j-1);jj<=std::min(ny-1,j+1);jj++)
+        {
+          for (int ii=std::max(0,i-1);ii<=std::min(nx-1,i+1);ii++)
+          {
+            if (done[jj*nx+ii])
+            {
+              sum += values[jj*nx+ii];
+              count++;
+            }
+          }
+        }
+        if (count > 0)
+        {
+          values[j*nx+i] = sum / count;
+          next[j*nx+i] = 1;
+        }
+        else
+        {
+          missing = true;
+        }
+      }
+    }
+    done.swap(next);
+  }
+}
+
+std::vector<double> BackgroundMap::filterMesh(const std::vector<double>& values, int nx, int ny) const
+{
+  if (filterSize < 2) return values;
+  int r = filterSize / 2;
+  /* the mesh is continued by point reflection at its borders; unlike a
+     truncated window this does not bias a gradient at the image edges */
+  auto reflect = [](int i, int n, int& mirror){
+    mirror = i < 0 ? 0 : (i >= n ? n - 1 : -1);
+    if (mirror < 0) return i;
+    return std::max(0,std::min(n-1,2*mirror-i));
+  };
+  auto value = [&](int i, int j){
+    int mi,mj;
+    int ri = reflect(i,nx,mi);
+    int rj = reflect(j,ny,mj);
+    double v = values[rj*nx+ri];
+    if (mi >= 0) v = 2 * values[rj*nx+mi] - v;
+    if (mj >= 0) v = 2 * (mi >= 0 ? 2 * values[mj*nx+mi] - values[mj*nx+ri] : values[mj*nx+ri]) - v;
+    return v;
+  };
+  std::vector<double> filtered(values.size());
+  std::vector<double> window;
+  for (int j=0;j<ny;j++)
+  {
+    for (int i=0;i<nx;i++)
+    {
+      window.clear();
+      for (int jj=j-r;jj<=j+r;jj++)
+      {
+        for (int ii=i-r;ii<=i+r;ii++)
+        {
+          window.push_back(value(ii,jj));
+        }
+      }
+      filtered[j*nx+i] = median(window);
+    }
+  }
+  return filtered;
+}
+
+void BackgroundMap::interpolate(const std::vector<double>& values, int nx, int ny, Layer& layer) const
+{
+  int w = layer.getWidth();
+  int h = layer.getHeight();
+  SplineAxis xaxis(cellCenters(nx,w),w);
+  SplineAxis yaxis(cellCenters(ny,h),h);
+  /* first along the mesh rows ... */
+  std::vector<double> rows(static_cast<size_t>(ny)*w);
+  std::vector<double> m(nx);
+  for (int j=0;j<ny;j++)
+  {
+    const double* y = values.data() + j * nx;
+    xaxis.solve(y,m.data(),1,1);
+    double* row = rows.data() + static_cast<size_t>(j) * w;
+    for (int x=0;x<w;x++)
+    {
+      int k = xaxis.index[x];
+      int k1 = nx > 1 ? k + 1 : k;
+      row[x] = xaxis.a[x] * y[k] + xaxis.b[x] * y[k1] + xaxis.c[x] * m[k] + xaxis.d[x] * m[k1];
+    }
+  }
+  /* ... then along the columns, for all columns at once */
+  std::vector<double> mrows(rows.size());
+  yaxis.solve(rows.data(),mrows.data(),w,w);
+  ValueType* data = layer.getData();
+  parallel::forRange(h,[&](int y0, int y1){
+    for (int y=y0;y<y1;y++)
+    {
+      int k = yaxis.index[y];
+      int k1 = ny > 1 ? k + 1 : k;
+      const double* r0 = rows.data() + static_cast<size_t>(k) * w;
+      const double* r1 = rows.data() + static_cast<size_t>(k1) * w;
+      const double* m0 = mrows.data() + static_cast<size_t>(k) * w;
+      const double* m1 = mrows.data() + static_cast<size_t>(k1) * w;
+      double a = yaxis.a[y];
+      double b = yaxis.b[y];
+      double c = yaxis.c[y];
+      double d = yaxis.d[y];
+      ValueType* out = data + static_cast<size_t>(y) * w;
+      for (int x=0;x<w;x++)
+      {
+        out[x] = static_cast<ValueType>(a * r0[x] + b * r1[x] + c * m0[x] + d * m1[x]);
+      }
+    }
+  },16);
+}
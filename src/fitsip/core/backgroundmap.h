@@ -0,0 +1,131 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - mesh based sky background and noise map                             *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef BACKGROUNDMAP_H
+#define BACKGROUNDMAP_H
+
+#include "fitsimage.h"
+#include <vector>
+
+/**
+ * @brief Sky background and noise map of an image.
+ *
+ * The image is divided into a mesh of cells. For every cell a robust
+ * background level and its noise are calculated from sigma clipped
+ * statistics. The mesh is median filtered to suppress cells dominated by
+ * stars or other objects and then interpolated to full resolution with a
+ * separable natural bicubic spline. Each layer of an image is processed
+ * independently.
+ */
+class BackgroundMap
+{
+public:
+  BackgroundMap();
+
+  /**
+   * @brief Set the size of the mesh cells.
+   * @param size the cell size in pixels (>= 8)
+   */
+  void setMeshSize(int size);
+
+  int getMeshSize() const;
+
+  /**
+   * @brief Set the size of the median filter applied to the mesh.
+   * @param size the filter size in cells (odd, 1 disables the filter)
+   */
+  void setFilterSize(int size);
+
+  int getFilterSize() const;
+
+  /**
+   * @brief Set the parameters of the sigma clipping.
+   * @param sigma clip pixels deviating more than sigma standard deviations
+   * @param iterations the maximum number of clipping iterations
+   */
+  void setClipping(double sigma, int iterations);
+
+  /**
+   * @brief Calculate the background and noise map of an image.
+   * @param image the image
+   */
+  void build(const FitsImage& image);
+
+  bool isEmpty() const;
+
+  /**
+   * @brief Get the full resolution background map.
+   * @return the background map with the size and depth of the image
+   */
+  const FitsImage& getBackground() const;
+
+  /**
+   * @brief Get the full resolution noise (RMS) map.
+   * @return the noise map with the size and depth of the image
+   */
+  const FitsImage& getRMS() const;
+
+  /**
+   * @brief Get the median of the background of all mesh cells.
+   * @param layer the image layer
+   * @return the global background level
+   */
+  double getGlobalBackground(int layer=0) const;
+
+  /**
+   * @brief Get the median of the noise of all mesh cells.
+   * @param layer the image layer
+   * @return the global noise level
+   */
+  double getGlobalRMS(int layer=0) const;
+
+  /**
+   * @brief Subtract the background map from an image.
+   * @param image the image, which must match the size and depth of the map
+   */
+  void subtract(FitsImage& image) const;
+
+private:
+  struct Mesh
+  {
+    int nx;
+    int ny;
+    std::vector<double> background;
+    std::vector<double> rms;
+  };
+
+  Mesh computeMesh(const Layer& layer) const;
+  void fillMesh(std::vector<double>& values, const std::vector<char>& valid, int nx, int ny) const;
+  std::vector<double> filterMesh(const std::vector<double>& values, int nx, int ny) const;
+  void interpolate(const std::vector<double>& values, int nx, int ny, Layer& layer) const;
+
+  int meshSize;
+  int filterSize;
+  double clipSigma;
+  int clipIterations;
+  FitsImage background;
+  FitsImage rms;
+  std::vector<double> globalBackground;
+  std::vector<double> globalRMS;
+};
+
+#endif // BACKGROUNDMAP_H
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - dialog showing the progress of an operation                         *
  *                                                                              *
- * modified: 2022-11-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -26,7 +26,8 @@
 
 ProgressDialog::ProgressDialog(QWidget *parent):QDialog(parent),
   ui(new Ui::ProgressDialog),
-  cancelled(false)
+  cancelled(false),
+  finished(false)
 {
   ui->setupUi(this);
 }
@@ -61,10 +62,22 @@ bool ProgressDialog::isCancelled() const
   return cancelled;
 }
 
+void ProgressDialog::setFinished()
+{
+  finished = true;
+  ui->buttonBox->setStandardButtons(QDialogButtonBox::Close);
+}
+
 
 
 void ProgressDialog::reject()
 {
+  if (finished)
+  {
+    QDialog::reject();
+    return;
+  }
   cancelled = true;
+  emit cancelRequested();
 }
 
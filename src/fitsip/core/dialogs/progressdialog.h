@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - dialog showing the progress of an operation                         *
  *                                                                              *
- * modified: 2022-11-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -47,6 +47,18 @@ public:
 
   bool isCancelled() const;
 
+  /**
+   * @brief Mark the operation as finished.
+   *
+   * The cancel button becomes a close button, so the messages can be read
+   * before the dialog is closed.
+   */
+  void setFinished();
+
+signals:
+
+  void cancelRequested();
+
 public slots:
 
   virtual void reject() override;
@@ -54,6 +66,7 @@ public slots:
 private:
   Ui::ProgressDialog *ui;
   bool cancelled;
+  bool finished;
 };
 
 #endif // PROGESSDIALOG_H
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - image object                                                        *
  *                                                                              *
- * modified: 2025-10-24                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -32,6 +32,14 @@ Layer::Layer(int w, int h):
   memset(data,0,w*h*sizeof(ValueType));
 }
 
+Layer::Layer(int w, int h, ValueType* d, std::shared_ptr<void> o):
+  width(w),
+  height(h),
+  data(d),
+  owner(std::move(o))
+{
+}
+
 Layer::Layer(const Layer& l):
   width(l.width),
   height(l.height)
@@ -40,9 +48,42 @@ Layer::Layer(const Layer& l):
   memcpy(data,l.data,width*height*sizeof(ValueType));
 }
 
+Layer::Layer(Layer&& l) noexcept:
+  width(l.width),
+  height(l.height),
+  data(l.data),
+  owner(std::move(l.owner))
+{
+  l.data = nullptr;
+}
+
 Layer::~Layer()
 {
-  if (data) delete [] data;
+  if (data && !owner) delete [] data;
+}
+
+Layer& Layer::operator=(const Layer& l)
+{
+  if (this != &l)
+  {
+    Layer tmp(l);
+    *this = std::move(tmp);
+  }
+  return *this;
+}
+
+Layer& Layer::operator=(Layer&& l) noexcept
+{
+  if (this != &l)
+  {
+    if (data && !owner) delete [] data;
+    width = l.width;
+    height = l.height;
+    data = l.data;
+    owner = std::move(l.owner);
+    l.data = nullptr;
+  }
+  return *this;
 }
 
 int Layer::getWidth() const
@@ -60,6 +101,12 @@ size_t Layer::size() const
   return width * height;
 }
 
+std::shared_ptr<void> Layer::shareData()
+{
+  if (data && !owner) owner = std::shared_ptr<void>(data,[](void* p){ delete [] static_cast<ValueType*>(p); });
+  return owner;
+}
+
 void Layer::setData(std::valarray<ValueType> &d)
 {
   ValueType *p = data;
@@ -184,6 +231,20 @@ FitsImage::FitsImage(const QString& name, std::vector<Layer*>& layers):
   }
 }
 
+FitsImage::FitsImage(const QString& name, std::vector<Layer>&& layers):
+  name(name),
+  width(0),
+  height(0),
+  depth(layers.size()),
+  layers(std::move(layers))
+{
+  if (!this->layers.empty())
+  {
+    width = this->layers.front().getWidth();
+    height = this->layers.front().getHeight();
+  }
+}
+
 bool FitsImage::isNull() const
 {
   return width == 0 || height == 0;
@@ -641,6 +702,16 @@ FitsImage& FitsImage::operator=(const FitsImage& img)
   return *this;
 }
 
+FitsImage& FitsImage::operator=(FitsImage&& img)
+{
+  name = std::move(img.name);
+  width = img.width;
+  height = img.height;
+  depth = img.depth;
+  metadata = std::move(img.metadata);
+  layers = std::move(img.layers);
+  return *this;
+}
 
 QImage FitsImage::toQImage(ValueType min, ValueType max, Scale scale) const
 {
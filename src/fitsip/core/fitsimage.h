@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - image object                                                        *
  *                                                                              *
- * modified: 2025-11-05                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -28,6 +28,7 @@
 #include "pixel.h"
 #include "pixeliterator.h"
 #include <QImage>
+#include <memory>
 #include <vector>
 #include <valarray>
 
@@ -39,9 +40,27 @@ class Layer
 {
 public:
   Layer(int width, int height);
+
+  /**
+   * @brief Create a layer using external memory.
+   *
+   * The layer does not copy the data; the memory is kept alive by holding a
+   * reference to its owner (e.g. a NumPy array) for the lifetime of the
+   * layer. Copies of the layer allocate their own memory.
+   * @param width the width of the layer
+   * @param height the height of the layer
+   * @param data the pixel data, width*height values row by row
+   * @param owner the owner of the data
+   */
+  Layer(int width, int height, ValueType* data, std::shared_ptr<void> owner);
   Layer(const Layer& l);
+  Layer(Layer&& l) noexcept;
   ~Layer();
 
+  Layer& operator=(const Layer& l);
+
+  Layer& operator=(Layer&& l) noexcept;
+
   int getWidth() const;
 
   int getHeight() const;
@@ -54,6 +73,16 @@ public:
 
   const ValueType* getData() const;
 
+  /**
+   * @brief Share the pixel data.
+   *
+   * Memory allocated by the layer is handed over to a shared owner, so the
+   * data stays valid as long as the returned owner is held, even after the
+   * layer has been destroyed.
+   * @return the owner of the pixel data
+   */
+  std::shared_ptr<void> shareData();
+
   void blit(const Layer& layer, int x, int y, int w, int h, int xd, int yd);
 
   inline const ValueType& operator()(int x, int y) const { return data[y*width+x];}
@@ -64,6 +93,7 @@ private:
   int width;
   int height;
   ValueType* data;
+  std::shared_ptr<void> owner;
 };
 
 inline ValueType* Layer::getData()
@@ -90,6 +120,7 @@ public:
   FitsImage(FitsImage&& img);
   FitsImage(const QString& name, const FitsImage& img);
   FitsImage(const QString& name, std::vector<Layer*>& layers);
+  FitsImage(const QString& name, std::vector<Layer>&& layers);
 
   bool isNull() const;
 
@@ -242,6 +273,8 @@ public:
 
   FitsImage& operator=(const FitsImage&);
 
+  FitsImage& operator=(FitsImage&&);
+
 private:
   QImage toQImageLin(ValueType min, ValueType max) const;
   QImage toQImageLog(ValueType min, ValueType max) const;
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - fits object containing the image and other data                     *
  *                                                                              *
- * modified: 2025-11-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -26,7 +26,7 @@
 #include <QFile>
 #include <QDebug>
 
-int FitsObject::idCounter = 0;
+std::atomic<int> FitsObject::idCounter{0};
 
 FitsObject::FitsObject(const FitsImage& img, const QString&  fn):
   id(idCounter++),
@@ -51,6 +51,13 @@ FitsObject::FitsObject(const FitsImage& img, const std::string&  fn):
 //  histogram.build(image.get());
 }
 
+FitsObject::FitsObject(FitsImage&& img, const QString&  fn):
+  id(idCounter++),
+  filename(fn),
+  image(std::move(img))
+{
+}
+
 FitsObject::~FitsObject()
 {
 
@@ -84,6 +91,13 @@ FitsImage& FitsObject::getImage()
 void FitsObject::setImage(const FitsImage& img)
 {
   image = img;
+  backgroundMap.reset();
+}
+
+void FitsObject::setImage(FitsImage&& img)
+{
+  image = std::move(img);
+  backgroundMap.reset();
 }
 
 QRect FitsObject::getAOI() const
@@ -108,6 +122,18 @@ const Histogram& FitsObject::getHistogram(bool update)
 void FitsObject::updateHistogram()
 {
   histogram.build(image);
+  backgroundMap.reset();
+}
+
+std::shared_ptr<const BackgroundMap> FitsObject::getBackgroundMap(bool update)
+{
+  if (!backgroundMap || update)
+  {
+    auto map = std::make_shared<BackgroundMap>();
+    map->build(image);
+    backgroundMap = map;
+  }
+  return backgroundMap;
 }
 
 void FitsObject::setXProfile(const Profile& p)
@@ -239,3 +265,11 @@ std::shared_ptr<FitsObject> FitsObject::copy(const std::string& filename) const
   obj->yprofile = yprofile;
   return obj;
 }
+
+void FitsObject::moveToThread(QThread* thread)
+{
+  pixelList.moveToThread(thread);
+  starList.moveToThread(thread);
+  annotations.moveToThread(thread);
+  undostack.moveToThread(thread);
+}
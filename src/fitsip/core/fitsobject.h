@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - file object containing the image and other data                     *
  *                                                                              *
- * modified: 2025-11-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -24,6 +24,7 @@
 #define FITSOBJECT_H
 
 #include "annotations.h"
+#include "backgroundmap.h"
 #include "fitsimage.h"
 #include "histogram.h"
 #include "pixellist.h"
@@ -31,9 +32,12 @@
 #include "starlist.h"
 #include "undostack.h"
 #include "xydata.h"
+#include <atomic>
 #include <memory>
 #include <string>
 
+class QThread;
+
 /**
  * @brief The FitsObject class contains an object in the FitsIP application,
  *        which encapsulates the image and additional data.
@@ -43,6 +47,7 @@ class FitsObject
 public:
   FitsObject(const FitsImage& img, const QString& filename="");
   FitsObject(const FitsImage& img, const std::string& filename);
+  FitsObject(FitsImage&& img, const QString& filename="");
   FitsObject(const FitsObject& obj) = delete;
   ~FitsObject();
 
@@ -60,6 +65,8 @@ public:
 
   void setImage(const FitsImage& img);
 
+  void setImage(FitsImage&& img);
+
   QRect getAOI() const;
 
   void setAOI(const QRect& r);
@@ -68,6 +75,16 @@ public:
 
   void updateHistogram();
 
+  /**
+   * @brief Get the background and noise map of the image.
+   *
+   * The map is calculated on first use and cached until the image changes
+   * (see updateHistogram() and setImage()).
+   * @param update force a recalculation
+   * @return the background map
+   */
+  std::shared_ptr<const BackgroundMap> getBackgroundMap(bool update=false);
+
   void setXProfile(const Profile& p);
 
   const Profile& getXProfile() const;
@@ -129,12 +146,24 @@ public:
    */
   std::shared_ptr<FitsObject> copy(const std::string& filename) const;
 
+  /**
+   * @brief Move the Qt models of this object to another thread.
+   *
+   * Objects created by a worker thread (e.g. while loading images in
+   * parallel) must be handed over to the GUI thread, before they can be
+   * displayed. This method must be called from the thread which created the
+   * object.
+   * @param thread the thread which will own the models
+   */
+  void moveToThread(QThread* thread);
+
 private:
   const int id;
   QString  filename;
   FitsImage image;
   QRect aoi;
   Histogram histogram;
+  std::shared_ptr<BackgroundMap> backgroundMap;
   Profile xprofile;
   Profile yprofile;
   PixelList pixelList;
@@ -143,7 +172,7 @@ private:
   std::vector<XYData> xydata;
   UndoStack undostack;
 
-  static int idCounter;
+  static std::atomic<int> idCounter;
 };
 
 #endif // FILEOBJECT_H
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - astro image format reader                                           *
  *                                                                              *
- * modified: 2025-11-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -21,6 +21,7 @@
  ********************************************************************************/
 
 #include "astroimageio.h"
+#include "scanlineconverter.h"
 #include "../fitsimage.h"
 #include "../fitsobject.h"
 #include <QDataStream>
@@ -54,6 +55,7 @@ AstroImageIO::~AstroImageIO()
 std::vector<std::shared_ptr<FitsObject>> AstroImageIO::read(QString filename)
 {
   QFileInfo info(filename);
+  SimpleProfiler profiler("AstroImageIO");
   profiler.start();
   QFile f(filename);
   if (!f.open(QFile::ReadOnly)) throw std::runtime_error("AstroImageIO: Failed to open file");
@@ -78,7 +80,7 @@ std::vector<std::shared_ptr<FitsObject>> AstroImageIO::read(QString filename)
       break;
   }
   profiler.stop();
-  logProfiler(img,"read");
+  logProfiler(profiler,img,"read");
   return {std::make_shared<FitsObject>(img,filename)};
 }
 
@@ -129,13 +131,9 @@ FitsImage AstroImageIO::read_0x0100(QFile *f, const QFileInfo& info)
   uint32_t size = *(reinterpret_cast<uint32_t*>(a.data()));
   QByteArray d = f->read(size);
   if (compressed) d = qUncompress(d);
+  if (static_cast<uint64_t>(d.size()) < static_cast<uint64_t>(w)*h) throw std::runtime_error("AstroImageIO: image data truncated");
   auto img = FitsImage(info.baseName(),w,h,1);
-  PixelIterator it = img.getPixelIterator();
-  for (uint8_t v : std::as_const(d))
-  {
-    it[0] = v;
-    ++it;
-  }
+  scanline::copyGray<uint8_t>(d.constData(),w,img);
   img.setMetadata(metadata);
   return img;
 }
@@ -180,42 +178,22 @@ FitsImage AstroImageIO::read_0x0200(QFile *f, const QFileInfo& info)
   uint32_t size = *(reinterpret_cast<uint32_t*>(a.data()));
   QByteArray d = f->read(size);
   if (compressed) d = qUncompress(d);
+  if (static_cast<uint64_t>(d.size()) < static_cast<uint64_t>(w)*h*bytesPerPixel) throw std::runtime_error("AstroImageIO: image data truncated");
   FitsImage img;
   if (bytesPerPixel == 1)
   {
     img = FitsImage(info.baseName(),w,h,1);
-    PixelIterator it = img.getPixelIterator();
-    for (uint8_t v : std::as_const(d))
-    {
-      it[0] = v;
-      ++it;
-    }
+    scanline::copyGray<uint8_t>(d.constData(),w,img);
   }
   else if (bytesPerPixel == 2)
   {
     img = FitsImage(info.baseName(),w,h,1);
-    uint16_t* v = reinterpret_cast<uint16_t*>(d.data());
-    PixelIterator it = img.getPixelIterator();
-    for (uint32_t i=0;i<w*h;i++)
-    {
-      it[0] = *v;
-      ++v;
-      ++it;
-    }
+    scanline::copyGray<uint16_t>(d.constData(),static_cast<size_t>(w)*2,img);
   }
   else
   {
     img = FitsImage(info.baseName(),w,h,3);
-    uint32_t* v = reinterpret_cast<uint32_t*>(d.data());
-    PixelIterator it = img.getPixelIterator();
-    for (uint32_t i=0;i<w*h;i++)
-    {
-      it[0] = (*v >> 16) & 0xFF;
-      it[1] = (*v >> 8) & 0xFF;
-      it[2] = *v & 0xFF;
-      ++v;
-      ++it;
-    }
+    scanline::copyRGB32(d.constData(),static_cast<size_t>(w)*4,img);
   }
   img.setMetadata(metadata);
   return img;
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - Cookbook CCD image reader                                           *
  *                                                                              *
- * modified: 2025-11-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -56,6 +56,7 @@ bool CookbookIO::write(QString /*filename*/, const FitsObject& /*obj*/)
 FitsImage CookbookIO::readPA(QString filename)
 {
   QFileInfo info(filename);
+  SimpleProfiler profiler("CookbookIO");
   profiler.start();
   FitsImage img(info.baseName(),252,242,1);
   PixelIterator it = img.getPixelIterator();
@@ -102,13 +103,14 @@ FitsImage CookbookIO::readPA(QString filename)
     f.close();
   }
   profiler.stop();
-  logProfiler(img,"read");
+  logProfiler(profiler,img,"read");
   return img;
 }
 
 FitsImage CookbookIO::readP1(QString filename)
 {
   QFileInfo info(filename);
+  SimpleProfiler profiler("CookbookIO");
   profiler.start();
   FitsImage img(info.baseName(),378,242,1);
   PixelIterator it = img.getPixelIterator();
@@ -166,7 +168,7 @@ FitsImage CookbookIO::readP1(QString filename)
     f.close();
   }
   profiler.stop();
-  logProfiler(img,"read");
+  logProfiler(profiler,img,"read");
   return img;
 }
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - FITS image format reader and writer                                 *
  *                                                                              *
- * modified: 2025-11-03                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -36,7 +36,6 @@ const char* FitsIO::FILENAME_FILTER = "FITS Image (*.fts *.fit *.fits *.fts.gz *
 
 FitsIO::FitsIO()
 {
-  profiler = SimpleProfiler("FitsIO");
 }
 
 FitsIO::~FitsIO()
@@ -48,6 +47,7 @@ std::vector<std::shared_ptr<FitsObject>> FitsIO::read(QString filename)
   QFileInfo info(filename);
   try
   {
+    SimpleProfiler profiler("FitsIO");
     profiler.start();
     CCfits::FITS fits(filename.toStdString());
     ImageMetadata metadata;
@@ -111,7 +111,7 @@ std::vector<std::shared_ptr<FitsObject>> FitsIO::read(QString filename)
 //      qDebug() << fits.pHDU().axis(i);
 //    }
     profiler.stop();
-    logProfiler(info.baseName(),"read");
+    logProfiler(profiler,info.baseName(),"read");
     return list;
   }
   catch (CCfits::FitsException& ex)
@@ -128,6 +128,7 @@ bool FitsIO::write(QString filename, const FitsObject& obj)
   CCfits::FITS* fits = nullptr;
   try
   {
+    SimpleProfiler profiler("FitsIO");
     profiler.start();
     int64_t axes[]{img.getWidth(),img.getHeight(),img.getDepth()};
     switch (format)
@@ -168,7 +169,7 @@ bool FitsIO::write(QString filename, const FitsObject& obj)
     }
     delete fits;
     profiler.stop();
-    logProfiler(img,"write");
+    logProfiler(profiler,img,"write");
   }
   catch (std::exception& ex)
   {
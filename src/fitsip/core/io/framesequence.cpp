@@ -0,0 +1,157 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - sequence of frames from images and videos                           *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "framesequence.h"
+#include "imageloader.h"
+#include "iofactory.h"
+#include "servideo.h"
+#include "../fitsobject.h"
+
+FrameSequence::FrameSequence(const std::vector<QFileInfo>& list):
+  files(list),
+  prefetchCount(8)
+{
+  for (size_t i=0;i<files.size();++i)
+  {
+    if (isVideo(files[i]))
+    {
+      try
+      {
+        auto video = std::make_shared<SerVideo>(files[i].absoluteFilePath());
+        videos.insert(std::make_pair(i,video));
+        for (int frame=0;frame<video->getFrameCount();++frame) entries.push_back({i,frame});
+      }
+      catch (const std::exception& ex)
+      {
+        errors.append(files[i].fileName()+": "+ex.what());
+      }
+    }
+    else
+    {
+      entries.push_back({i,-1});
+    }
+  }
+}
+
+FrameSequence::FrameSequence(const std::vector<std::shared_ptr<FitsObject>>& list):
+  objects(list),
+  prefetchCount(0)
+{
+  for (size_t i=0;i<objects.size();++i) entries.push_back({i,-1});
+}
+
+FrameSequence::FrameSequence(const FrameSequence& seq, const std::vector<size_t>& indices):
+  files(seq.files),
+  objects(seq.objects),
+  videos(seq.videos),
+  errors(seq.errors),
+  prefetchCount(seq.prefetchCount)
+{
+  for (size_t index : indices) entries.push_back(seq.entries.at(index));
+}
+
+FrameSequence::~FrameSequence()
+{
+}
+
+bool FrameSequence::isVideo(const QFileInfo& info)
+{
+  return info.suffix().toLower() == "ser";
+}
+
+size_t FrameSequence::size() const
+{
+  return entries.size();
+}
+
+bool FrameSequence::empty() const
+{
+  return entries.empty();
+}
+
+const QStringList& FrameSequence::getErrors() const
+{
+  return errors;
+}
+
+const QFileInfo& FrameSequence::getFileInfo(size_t index) const
+{
+  static const QFileInfo none;
+  if (!objects.empty()) return none;
+  return files[entries[index].file];
+}
+
+int FrameSequence::getFrameIndex(size_t index) const
+{
+  return entries[index].frame;
+}
+
+QString FrameSequence::getName(size_t index) const
+{
+  const Entry& entry = entries[index];
+  if (!objects.empty()) return objects[entry.file]->getName();
+  if (entry.frame < 0) return files[entry.file].fileName();
+  return QString("%1 [%2]").arg(files[entry.file].fileName()).arg(entry.frame);
+}
+
+FitsImage FrameSequence::getImage(size_t index) const
+{
+  const Entry& entry = entries[index];
+  if (!objects.empty()) return FitsImage(objects[entry.file]->getImage());
+  if (entry.frame < 0)
+  {
+    /* frames are read once in sequence; they must not evict the images read repeatedly */
+    return IOFactory::getInstance()->loadImage(files[entry.file].absoluteFilePath(),IOFactory::ReadOnce);
+  }
+  const std::shared_ptr<SerVideo>& video = videos.at(entry.file);
+  /* video frames bypass the image cache; they are read once in sequence */
+  if (prefetchCount > 0) video->prefetch(entry.frame+1,prefetchCount);
+  return video->getFrame(entry.frame);
+}
+
+const std::vector<QFileInfo>& FrameSequence::getFiles() const
+{
+  return files;
+}
+
+const std::vector<std::shared_ptr<FitsObject>>& FrameSequence::getObjects() const
+{
+  return objects;
+}
+
+uint64_t FrameSequence::estimateMemory(size_t index) const
+{
+  const Entry& entry = entries[index];
+  if (!objects.empty())
+  {
+    const FitsImage& img = objects[entry.file]->getImage();
+    return static_cast<uint64_t>(img.getWidth()) * img.getHeight() * img.getDepth() * sizeof(ValueType);
+  }
+  if (entry.frame < 0) return ImageLoader::estimateMemory(files[entry.file]);
+  const std::shared_ptr<SerVideo>& video = videos.at(entry.file);
+  return static_cast<uint64_t>(video->getWidth()) * video->getHeight() * video->getPlanes() * sizeof(ValueType);
+}
+
+void FrameSequence::setPrefetch(int n)
+{
+  prefetchCount = n;
+}
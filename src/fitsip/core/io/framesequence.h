@@ -0,0 +1,153 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - sequence of frames from images and videos                           *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef FRAMESEQUENCE_H
+#define FRAMESEQUENCE_H
+
+#include "../fitsimage.h"
+#include <QFileInfo>
+#include <QStringList>
+#include <map>
+#include <memory>
+#include <vector>
+
+class FitsObject;
+class SerVideo;
+
+/**
+ * @brief Flat sequence of the frames in a list of files.
+ *
+ * Image files contribute one frame each, videos contribute all of their
+ * frames. Video frames are read directly from the memory mapped file and
+ * the frames following an accessed frame are prefetched, so operators can
+ * process video captures without converting them to single images first.
+ *
+ * A sequence can also be built from images already in memory; each image
+ * is one frame then.
+ *
+ * Videos that cannot be opened contribute no frames; their errors are
+ * available from getErrors() and must be checked by the caller.
+ */
+class FrameSequence
+{
+public:
+  explicit FrameSequence(const std::vector<QFileInfo>& list);
+  explicit FrameSequence(const std::vector<std::shared_ptr<FitsObject>>& list);
+
+  /**
+   * @brief Create a sequence of selected frames of another sequence.
+   *
+   * The files and videos are shared with the other sequence.
+   * @param seq the sequence
+   * @param indices the indices of the frames in seq, in the new order
+   */
+  FrameSequence(const FrameSequence& seq, const std::vector<size_t>& indices);
+  ~FrameSequence();
+
+  /**
+   * @brief Check if a file is a video with several frames.
+   * @param info the file
+   * @return true if the file is a video
+   */
+  static bool isVideo(const QFileInfo& info);
+
+  size_t size() const;
+
+  bool empty() const;
+
+  /**
+   * @brief Get the errors of the videos that could not be opened.
+   * @return the errors, each prefixed by the file name; empty on success
+   */
+  const QStringList& getErrors() const;
+
+  /**
+   * @brief Get the file containing a frame.
+   * @param index the index of the frame in the sequence
+   * @return the file
+   */
+  const QFileInfo& getFileInfo(size_t index) const;
+
+  /**
+   * @brief Get the index of a frame within its video.
+   * @param index the index of the frame in the sequence
+   * @return the frame index or -1 for image files
+   */
+  int getFrameIndex(size_t index) const;
+
+  /**
+   * @brief Get a displayable name of a frame.
+   * @param index the index of the frame in the sequence
+   * @return the file name, followed by the frame index for videos
+   */
+  QString getName(size_t index) const;
+
+  /**
+   * @brief Get the files of the sequence.
+   * @return the files; empty for a sequence of images in memory
+   */
+  const std::vector<QFileInfo>& getFiles() const;
+
+  /**
+   * @brief Get the images of the sequence.
+   * @return the images; empty for a sequence of files
+   */
+  const std::vector<std::shared_ptr<FitsObject>>& getObjects() const;
+
+  /**
+   * @brief Estimate the memory needed for a decoded frame.
+   * @param index the index of the frame in the sequence
+   * @return the estimate in bytes
+   */
+  uint64_t estimateMemory(size_t index) const;
+
+  /**
+   * @brief Read a frame.
+   *
+   * Throws a std::runtime_error if the frame cannot be read.
+   * @param index the index of the frame in the sequence
+   * @return the image
+   */
+  FitsImage getImage(size_t index) const;
+
+  /**
+   * @brief Set the number of video frames read ahead of an accessed frame.
+   * @param n the number of frames
+   */
+  void setPrefetch(int n);
+
+private:
+  struct Entry
+  {
+    size_t file;
+    int frame;
+  };
+
+  std::vector<QFileInfo> files;
+  std::vector<std::shared_ptr<FitsObject>> objects;
+  std::vector<Entry> entries;
+  std::map<size_t,std::shared_ptr<SerVideo>> videos;
+  QStringList errors;
+  int prefetchCount;
+};
+
+#endif // FRAMESEQUENCE_H
@@ -0,0 +1,133 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - cache for decoded images                                            *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "imagecache.h"
+#include "../fitsimage.h"
+#include <QDateTime>
+#include <QMutexLocker>
+
+ImageCache::ImageCache():
+  budget(0),
+  size(0),
+  hits(0),
+  misses(0)
+{
+}
+
+void ImageCache::setBudget(uint64_t bytes)
+{
+  QMutexLocker locker(&mutex);
+  budget = bytes;
+  evict();
+}
+
+uint64_t ImageCache::getBudget() const
+{
+  QMutexLocker locker(&mutex);
+  return budget;
+}
+
+std::shared_ptr<const FitsImage> ImageCache::get(const QFileInfo& file)
+{
+  QMutexLocker locker(&mutex);
+  auto i = index.find(file.absoluteFilePath());
+  if (i == index.end())
+  {
+    ++misses;
+    return std::shared_ptr<const FitsImage>();
+  }
+  auto it = i->second;
+  if (it->modified != file.lastModified().toMSecsSinceEpoch() || it->filesize != file.size())
+  {
+    /* file changed on disk */
+    erase(it);
+    ++misses;
+    return std::shared_ptr<const FitsImage>();
+  }
+  entries.splice(entries.begin(),entries,it);
+  ++hits;
+  return it->image;
+}
+
+void ImageCache::put(const QFileInfo& file, std::shared_ptr<const FitsImage> img)
+{
+  if (!img) return;
+  uint64_t bytes = static_cast<uint64_t>(img->getWidth()) * img->getHeight() * img->getDepth() * sizeof(ValueType);
+  QMutexLocker locker(&mutex);
+  auto i = index.find(file.absoluteFilePath());
+  if (i != index.end()) erase(i->second);
+  if (bytes > budget) return;
+  entries.push_front({file.absoluteFilePath(),file.lastModified().toMSecsSinceEpoch(),file.size(),bytes,img});
+  index[file.absoluteFilePath()] = entries.begin();
+  size += bytes;
+  evict();
+}
+
+void ImageCache::remove(const QString& filename)
+{
+  QMutexLocker locker(&mutex);
+  auto i = index.find(QFileInfo(filename).absoluteFilePath());
+  if (i != index.end()) erase(i->second);
+}
+
+void ImageCache::clear()
+{
+  QMutexLocker locker(&mutex);
+  entries.clear();
+  index.clear();
+  size = 0;
+}
+
+uint64_t ImageCache::getSize() const
+{
+  QMutexLocker locker(&mutex);
+  return size;
+}
+
+uint64_t ImageCache::getHits() const
+{
+  QMutexLocker locker(&mutex);
+  return hits;
+}
+
+uint64_t ImageCache::getMisses() const
+{
+  QMutexLocker locker(&mutex);
+  return misses;
+}
+
+
+
+void ImageCache::erase(std::list<Entry>::iterator it)
+{
+  size -= it->bytes;
+  index.erase(it->path);
+  entries.erase(it);
+}
+
+void ImageCache::evict()
+{
+  while (size > budget && !entries.empty())
+  {
+    erase(std::prev(entries.end()));
+  }
+}
@@ -0,0 +1,112 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - cache for decoded images                                            *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QFileInfo>
+#include <QMutex>
+#include <QString>
+#include <list>
+#include <map>
+#include <memory>
+
+class FitsImage;
+
+/**
+ * @brief Memory limited cache for decoded images.
+ *
+ * The images are stored by the absolute path of the file, together with
+ * the modification time and the size of the file. An entry is only valid,
+ * if both still match the file on disk. The cached images are handed out as
+ * const shared pointers; whoever needs to modify an image has to make a
+ * copy. If the total size of the cached images exceeds the budget, the least
+ * recently used images are dropped.
+ *
+ * All methods are thread safe.
+ */
+class ImageCache
+{
+public:
+  ImageCache();
+
+  /**
+   * @brief Set the memory budget.
+   *
+   * A budget of 0 disables the cache.
+   * @param bytes the budget in bytes
+   */
+  void setBudget(uint64_t bytes);
+
+  uint64_t getBudget() const;
+
+  /**
+   * @brief Look up an image.
+   * @param file the file the image was read from
+   * @return the image or a null pointer if not cached or outdated
+   */
+  std::shared_ptr<const FitsImage> get(const QFileInfo& file);
+
+  /**
+   * @brief Add an image to the cache.
+   * @param file the file the image was read from
+   * @param img the decoded image
+   */
+  void put(const QFileInfo& file, std::shared_ptr<const FitsImage> img);
+
+  void remove(const QString& filename);
+
+  void clear();
+
+  /**
+   * @brief Get the size of all cached images.
+   * @return the size in bytes
+   */
+  uint64_t getSize() const;
+
+  uint64_t getHits() const;
+
+  uint64_t getMisses() const;
+
+private:
+  struct Entry
+  {
+    QString path;
+    qint64 modified;
+    qint64 filesize;
+    uint64_t bytes;
+    std::shared_ptr<const FitsImage> image;
+  };
+
+  void erase(std::list<Entry>::iterator it);
+  void evict();
+
+  mutable QMutex mutex;
+  std::list<Entry> entries; /* most recently used first */
+  std::map<QString,std::list<Entry>::iterator> index;
+  uint64_t budget;
+  uint64_t size;
+  uint64_t hits;
+  uint64_t misses;
+};
+
+#endif // IMAGECACHE_H
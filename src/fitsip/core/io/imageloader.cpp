@@ -0,0 +1,194 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - parallel loader for image files                                     *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "imageloader.h"
+#include "iofactory.h"
+#include "../fitsobject.h"
+#include "../fitstypes.h"
+#include <QPointer>
+#include <QRunnable>
+#include <QThread>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+namespace
+{
+
+class LoadTask: public QRunnable
+{
+public:
+  LoadTask(const QFileInfo& file, std::shared_ptr<std::atomic<bool>> cancelled, std::function<void(std::vector<std::shared_ptr<FitsObject>>,QString)> callback):
+    file(file),
+    cancelled(cancelled),
+    callback(callback)
+  {
+  }
+
+  void run() override
+  {
+    std::vector<std::shared_ptr<FitsObject>> images;
+    QString error;
+    /* a task waiting in the pool when the run is cancelled does not decode its file */
+    if (*cancelled)
+    {
+      callback(images,error);
+      return;
+    }
+    IOHandler* handler = IOFactory::getInstance()->getHandler(file.absoluteFilePath());
+    if (handler)
+    {
+      try
+      {
+        images = handler->read(file.absoluteFilePath());
+      }
+      catch (std::exception& ex)
+      {
+        error = ex.what();
+      }
+    }
+    else
+    {
+      error = "No IOHandler for: " + file.absoluteFilePath();
+    }
+    callback(images,error);
+  }
+
+private:
+  QFileInfo file;
+  std::shared_ptr<std::atomic<bool>> cancelled;
+  std::function<void(std::vector<std::shared_ptr<FitsObject>>,QString)> callback;
+};
+
+}
+
+ImageLoader::ImageLoader(QObject* parent):QObject(parent),
+  next(0),
+  running(0),
+  done(0),
+  budget(2048ull*1024*1024),
+  inflight(0),
+  cancelled(std::make_shared<std::atomic<bool>>(false))
+{
+  pool.setMaxThreadCount(QThread::idealThreadCount());
+}
+
+ImageLoader::~ImageLoader()
+{
+  cancel();
+  pool.waitForDone();
+}
+
+void ImageLoader::setMemoryBudget(uint64_t bytes)
+{
+  budget = bytes;
+}
+
+uint64_t ImageLoader::getMemoryBudget() const
+{
+  return budget;
+}
+
+void ImageLoader::setMaxThreads(int n)
+{
+  pool.setMaxThreadCount(n < 1 ? QThread::idealThreadCount() : n);
+}
+
+void ImageLoader::load(const std::vector<QFileInfo>& files)
+{
+  /* tasks of a cancelled run keep the old flag */
+  if (*cancelled) cancelled = std::make_shared<std::atomic<bool>>(false);
+  if (!isRunning())
+  {
+    queue.clear();
+    next = 0;
+    done = 0;
+  }
+  queue.insert(queue.end(),files.begin(),files.end());
+  emit progress(done,static_cast<int>(queue.size()));
+  scheduleNext();
+}
+
+void ImageLoader::cancel()
+{
+  *cancelled = true;
+  next = queue.size();
+  if (running == 0) emit finished();
+}
+
+bool ImageLoader::isRunning() const
+{
+  return running > 0 || next < queue.size();
+}
+
+uint64_t ImageLoader::estimateMemory(const QFileInfo& file)
+{
+  uint64_t size = static_cast<uint64_t>(file.size());
+  QString suffix = file.suffix().toLower();
+  /* uncompressed FITS files store at least 8 bit per sample */
+  if (suffix == "fts" || suffix == "fit" || suffix == "fits") return size * sizeof(ValueType);
+  /* compressed FITS, raw and other image formats: assume a compression of 1:4 */
+  return size * sizeof(ValueType) * 4;
+}
+
+
+
+void ImageLoader::scheduleNext()
+{
+  while (next < queue.size() && running < pool.maxThreadCount())
+  {
+    uint64_t estimate = std::min(estimateMemory(queue[next]),budget);
+    if (running > 0 && inflight + estimate > budget) break;
+    QString filename = queue[next].absoluteFilePath();
+    inflight += estimate;
+    ++running;
+    ++next;
+    QPointer<ImageLoader> loader(this);
+    std::shared_ptr<std::atomic<bool>> flag = cancelled;
+    QThread* target = thread();
+    pool.start(new LoadTask(queue[next-1],flag,[=](std::vector<std::shared_ptr<FitsObject>> images, QString error){
+      /* hand the Qt models over to the thread of the loader */
+      for (const auto& obj : images) obj->moveToThread(target);
+      if (*flag) images.clear();
+      QMetaObject::invokeMethod(loader,[=](){
+        if (loader) loader->taskDone(filename,estimate,images,error,*flag);
+      },Qt::QueuedConnection);
+    }));
+  }
+}
+
+void ImageLoader::taskDone(const QString& filename, uint64_t estimate, std::vector<std::shared_ptr<FitsObject>> images, const QString& error, bool dropped)
+{
+  inflight -= estimate;
+  --running;
+  ++done;
+  if (!dropped)
+  {
+    if (error.isEmpty())
+      emit imageLoaded(filename,images);
+    else
+      emit loadFailed(filename,error);
+    emit progress(done,static_cast<int>(queue.size()));
+  }
+  scheduleNext();
+  if (running == 0 && next >= queue.size()) emit finished();
+}
@@ -0,0 +1,117 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - parallel loader for image files                                     *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef IMAGELOADER_H
+#define IMAGELOADER_H
+
+#include <QFileInfo>
+#include <QObject>
+#include <QThreadPool>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+class FitsObject;
+
+/**
+ * @brief Loads a list of image files in parallel on worker threads.
+ *
+ * The number of files decoded at the same time is limited by the number of
+ * threads and by a memory budget. Before a file is started, the memory
+ * needed for the decoded image is estimated; a file is only started, if the
+ * estimate fits into the budget together with all files currently in
+ * flight. A single file exceeding the budget is loaded alone.
+ *
+ * The loaded images are reported in the thread of the loader (usually the
+ * GUI thread) as soon as a file is done, so they can be added to an image
+ * collection while the rest of the files are still loading.
+ */
+class ImageLoader: public QObject
+{
+  Q_OBJECT
+public:
+  explicit ImageLoader(QObject* parent=nullptr);
+  ~ImageLoader() override;
+
+  /**
+   * @brief Set the memory budget for the images in flight.
+   * @param bytes the budget in bytes
+   */
+  void setMemoryBudget(uint64_t bytes);
+
+  uint64_t getMemoryBudget() const;
+
+  /**
+   * @brief Set the maximum number of files loaded at the same time.
+   * @param n number of threads; if < 1 the ideal thread count is used
+   */
+  void setMaxThreads(int n);
+
+  /**
+   * @brief Start loading the files.
+   *
+   * The method returns immediately. Files added while the loader is still
+   * running are appended to the current run.
+   * @param files the files to load
+   */
+  void load(const std::vector<QFileInfo>& files);
+
+  /**
+   * @brief Cancel loading.
+   *
+   * Files already being decoded will finish, but will not be reported.
+   */
+  void cancel();
+
+  bool isRunning() const;
+
+  /**
+   * @brief Estimate the memory needed for the decoded image of a file.
+   * @param file the file
+   * @return the estimate in bytes
+   */
+  static uint64_t estimateMemory(const QFileInfo& file);
+
+signals:
+  void imageLoaded(QString filename, std::vector<std::shared_ptr<FitsObject>> images);
+
+  void loadFailed(QString filename, QString error);
+
+  void progress(int done, int total);
+
+  void finished();
+
+private:
+  void scheduleNext();
+  void taskDone(const QString& filename, uint64_t estimate, std::vector<std::shared_ptr<FitsObject>> images, const QString& error, bool dropped);
+
+  QThreadPool pool;
+  std::vector<QFileInfo> queue;
+  size_t next;
+  int running;
+  int done;
+  uint64_t budget;
+  uint64_t inflight;
+  std::shared_ptr<std::atomic<bool>> cancelled;
+};
+
+#endif // IMAGELOADER_H
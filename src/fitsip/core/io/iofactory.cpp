@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - factory for I/O handlers                                            *
  *                                                                              *
- * modified: 2025-08-19                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -21,17 +21,24 @@
  ********************************************************************************/
 
 #include "iofactory.h"
+#include "../fitsimage.h"
+#include "../fitsobject.h"
+#include "../settings.h"
 #include "astroimageio.h"
 #include "cookbookio.h"
 #include "fitsio.h"
 #include "qtimageio.h"
+#include "scratchio.h"
+#include "serio.h"
 #ifdef HAVE_LIBRAW
 #include "rawio.h"
 #endif
 #include <QByteArray>
+#include <QCoreApplication>
 #include <QDebug>
 #include <QFileInfo>
 #include <QImageReader>
+#include <QMutexLocker>
 #include <QTextStream>
 
 const char* IOFactory::filelist_filter = "File List (*.lst)";
@@ -40,10 +47,13 @@ const char* IOFactory::csv_filter = "Comma Separated Values (*.csv)";
 
 const char* IOFactory::all_files_filter = "ALL Files (*)";
 
-IOFactory* IOFactory::instance = nullptr;
-
 IOFactory::IOFactory():QObject()
 {
+  /* needed for queued delivery of profiler results from worker threads */
+  qRegisterMetaType<int64_t>("int64_t");
+  /* the factory might be created by a worker thread; it has to live in the main thread */
+  if (QCoreApplication::instance()) moveToThread(QCoreApplication::instance()->thread());
+  cache.setBudget(static_cast<uint64_t>(Settings().getImageCacheSize())*1024*1024);
 }
 
 IOFactory::~IOFactory()
@@ -52,7 +62,8 @@ IOFactory::~IOFactory()
 
 IOFactory* IOFactory::getInstance()
 {
-  if (!instance) instance = new IOFactory;
+  /* initialization of a function local static is thread safe */
+  static IOFactory* instance = new IOFactory;
   // auto list = QImageReader::supportedImageFormats();
   // for (const auto& a : list)
   // {
@@ -78,14 +89,40 @@ bool IOFactory::isScript(QString filename)
 IOHandler* IOFactory::getHandler(QString filename)
 {
   QString suffix = QFileInfo(filename).suffix().toLower();
-  if (handlers.find(suffix) == handlers.end())
+  QMutexLocker locker(&mutex);
+  auto it = handlers.find(suffix);
+  if (it == handlers.end())
   {
     IOHandler* handler = createHandler(filename);
     if (!handler) return handler;
+    /* handlers are shared between threads, keep them in the thread of the factory */
+    handler->moveToThread(thread());
     handlers.insert(std::make_pair(suffix,handler));
     connect(handler,&IOHandler::logProfilerResult,this,&IOFactory::logProfilerResult);
+    return handler;
   }
-  return handlers[suffix];
+  return it->second;
+}
+
+std::shared_ptr<const FitsImage> IOFactory::readImage(const QString& filename, CachePolicy policy)
+{
+  FitsImage decoded;
+  std::shared_ptr<const FitsImage> img = read(filename,policy,decoded);
+  if (!img) img = std::make_shared<const FitsImage>(std::move(decoded));
+  return img;
+}
+
+FitsImage IOFactory::loadImage(const QString& filename, CachePolicy policy)
+{
+  FitsImage decoded;
+  std::shared_ptr<const FitsImage> img = read(filename,policy,decoded);
+  if (img) return FitsImage(*img);
+  return decoded;
+}
+
+ImageCache* IOFactory::getImageCache()
+{
+  return &cache;
 }
 
 QString IOFactory::getReadFilters() const
@@ -100,6 +137,8 @@ QString IOFactory::getReadFilters() const
 #endif
   s << ";;" << AstroImageIO::FILENAME_FILTER;
   s << ";;" << CookbookIO::FILENAME_FILTER;
+  s << ";;" << SerIO::FILENAME_FILTER;
+  s << ";;" << ScratchIO::FILENAME_FILTER;
   s.flush();
   return a;
 }
@@ -110,6 +149,7 @@ QString IOFactory::getWriteFilters() const
   QTextStream s(&a);
   s << FitsIO::FILENAME_FILTER;
   s << ";;" << QtImageIO::FILENAME_FILTER;
+  s << ";;" << ScratchIO::FILENAME_FILTER;
   s.flush();
   return a;
 }
@@ -139,6 +179,39 @@ QString IOFactory::assertSuffix(const QString &fn, QString filter)
 
 
 
+/* returns the cached image, or a null pointer if the image was decoded into 'decoded' and not cached */
+std::shared_ptr<const FitsImage> IOFactory::read(const QString& filename, CachePolicy policy, FitsImage& decoded)
+{
+  SimpleProfiler profiler("ImageCache");
+  profiler.start();
+  QFileInfo info(filename);
+  std::shared_ptr<const FitsImage> img = cache.get(info);
+  QString msg = "hit";
+  if (!img)
+  {
+    IOHandler* handler = getHandler(filename);
+    if (!handler) throw std::runtime_error("No IOHandler for: "+filename.toStdString());
+    auto list = handler->read(filename);
+    if (list.empty()) throw std::runtime_error("The file contains no images: "+filename.toStdString());
+    if (policy == CacheResult)
+    {
+      img = std::make_shared<const FitsImage>(std::move(list.front()->getImage()));
+      cache.put(info,img);
+      msg = "miss";
+    }
+    else
+    {
+      decoded = std::move(list.front()->getImage());
+      msg = "miss, not cached";
+    }
+  }
+  profiler.stop();
+  const FitsImage& result = img ? *img : decoded;
+  emit logProfilerResult(QString::fromStdString(profiler.getName()),result.getName(),result.getWidth(),result.getHeight(),profiler.getDuration(),
+                         QString("%1 (hits: %2 misses: %3)").arg(msg).arg(cache.getHits()).arg(cache.getMisses()));
+  return img;
+}
+
 IOHandler* IOFactory::createHandler(QString filename)
 {
   QString suffix = QFileInfo(filename).suffix().toLower();
@@ -153,9 +226,12 @@ IOHandler* IOFactory::createHandler(QString filename)
   // if (suffix == "bmp") return new QtImageIO;
   if (suffix == "pa" || suffix == "p1") return new CookbookIO;
   if (suffix == "aimg") return new AstroImageIO;
+  if (suffix == "ser") return new SerIO;
+  if (suffix == "fsc") return new ScratchIO;
 #ifdef HAVE_LIBRAW
   auto rawio = new RawIO;
   if (rawio->handlesFile(filename)) return rawio;
+  delete rawio;
 #endif
   auto list = QImageReader::supportedImageFormats();
   for (const auto& a : list)
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - factory for I/O handlers                                            *
  *                                                                              *
- * modified: 2025-02-05                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -23,9 +23,23 @@
 #ifndef IOFACTORY_H
 #define IOFACTORY_H
 
+#include "imagecache.h"
 #include "iohandler.h"
+#include <QMutex>
 #include <map>
 
+/**
+ * @brief Factory for the I/O handlers.
+ *
+ * The factory and the handlers it returns may be used from any thread. The
+ * handlers are stateless, so one instance per file type is shared by all
+ * threads. Profiler results emitted from worker threads are delivered queued
+ * to the thread owning the factory (the application main thread).
+ *
+ * Decoded images can be read through a shared, memory limited cache (see
+ * readImage()), so files read over and over again (reference frames,
+ * calibration masters, PSF images) are decoded only once.
+ */
 class IOFactory: public QObject
 {
   Q_OBJECT
@@ -38,6 +52,41 @@ public:
 
   IOHandler* getHandler(QString filename);
 
+  /**
+   * @brief How an image decoded by readImage() or loadImage() is cached.
+   *
+   * Files read only once (frames of a stack, files of a batch run) should
+   * use ReadOnce, so they do not evict the images read over and over again.
+   */
+  enum CachePolicy { CacheResult, ReadOnce };
+
+  /**
+   * @brief Read the first image of a file through the image cache.
+   *
+   * The returned image may be shared with the cache and must not be
+   * modified; use loadImage() for an image to work on. Cache hits and
+   * misses are reported to the profiler.
+   * @param filename the file to read
+   * @param policy whether a decoded image is added to the cache
+   * @return the image
+   * @throws std::runtime_error if the file cannot be read
+   */
+  std::shared_ptr<const FitsImage> readImage(const QString& filename, CachePolicy policy=CacheResult);
+
+  /**
+   * @brief Read the first image of a file for modification.
+   *
+   * The image is only copied if it is shared with the cache; an image
+   * decoded with the ReadOnce policy is handed over as it is.
+   * @param filename the file to read
+   * @param policy whether a decoded image is added to the cache
+   * @return the image
+   * @throws std::runtime_error if the file cannot be read
+   */
+  FitsImage loadImage(const QString& filename, CachePolicy policy=CacheResult);
+
+  ImageCache* getImageCache();
+
   QString getReadFilters() const;
 
   QString getWriteFilters() const;
@@ -60,9 +109,11 @@ private:
 
   IOHandler* createHandler(QString filename);
 
-  std::map<QString,IOHandler*> handlers;
+  std::shared_ptr<const FitsImage> read(const QString& filename, CachePolicy policy, FitsImage& decoded);
 
-  static IOFactory* instance;
+  std::map<QString,IOHandler*> handlers;
+  QMutex mutex;
+  ImageCache cache;
 };
 
 #endif // IOFACTORY_H
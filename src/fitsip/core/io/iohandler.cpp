@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - virtual base class for image I/O handlers                           *
  *                                                                              *
- * modified: 2025-11-03                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -39,7 +39,7 @@ bool IOHandler::write(QString filename, const FitsImage& img)
   return write(filename,obj);
 }
 
-void IOHandler::logProfiler(const QString& image, const QString& msg)
+void IOHandler::logProfiler(const SimpleProfiler& profiler, const QString& image, const QString& msg)
 {
   if (profiler.getDuration() > 0)
   {
@@ -48,7 +48,7 @@ void IOHandler::logProfiler(const QString& image, const QString& msg)
   }
 }
 
-void IOHandler::logProfiler(const FitsImage& image, const QString& msg)
+void IOHandler::logProfiler(const SimpleProfiler& profiler, const FitsImage& image, const QString& msg)
 {
   if (profiler.getDuration() > 0)
   {
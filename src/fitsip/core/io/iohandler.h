@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - virtual base class for image I/O handlers                           *
  *                                                                              *
- * modified: 2025-11-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -32,6 +32,14 @@ class FitsImage;
 class FitsObject;
 class QWidget;
 
+/**
+ * @brief Base class for all image I/O handlers.
+ *
+ * The IOFactory shares a single handler instance per file type between all
+ * threads. Handlers must therefore not keep any state between calls of
+ * read() and write(); everything needed during a call, including the
+ * profiler, has to live on the stack.
+ */
 class IOHandler: public QObject
 {
   Q_OBJECT
@@ -57,11 +65,9 @@ signals:
   void logProfilerResult(QString profiler, QString image, int w, int h, int64_t t, QString notes);
 
 protected:
-  void logProfiler(const QString& image, const QString& msg="");
+  void logProfiler(const SimpleProfiler& profiler, const QString& image, const QString& msg="");
 
-  void logProfiler(const FitsImage& image, const QString& msg="");
-
-  SimpleProfiler profiler;
+  void logProfiler(const SimpleProfiler& profiler, const FitsImage& image, const QString& msg="");
 
 };
 
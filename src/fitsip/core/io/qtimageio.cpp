@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - reader and writer for image formats handled by Qt                   *
  *                                                                              *
- * modified: 2025-11-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -21,6 +21,7 @@
  ********************************************************************************/
 
 #include "qtimageio.h"
+#include "scanlineconverter.h"
 #include "../fitsimage.h"
 #include "../fitsobject.h"
 #include "../histogram.h"
@@ -35,7 +36,6 @@ const char* QtImageIO::FILENAME_FILTER = "Portable Network Graphics (*.png);;JPE
 
 QtImageIO::QtImageIO()
 {
-  profiler = SimpleProfiler("QtImageIO");
 }
 
 QtImageIO::~QtImageIO()
@@ -44,6 +44,7 @@ QtImageIO::~QtImageIO()
 
 std::vector<std::shared_ptr<FitsObject>> QtImageIO::read(QString filename)
 {
+  SimpleProfiler profiler("QtImageIO");
   profiler.start();
   QImage i(filename);
   if (i.isNull()) throw std::runtime_error("Failed to load image: "+filename.toStdString());
@@ -52,35 +53,13 @@ std::vector<std::shared_ptr<FitsObject>> QtImageIO::read(QString filename)
   if (i.depth() == 8)
   {
     img = FitsImage(info.baseName(),i.width(),i.height(),1);
-    PixelIterator pixel = img.getPixelIterator();
-    for (int y=0;y<i.height();y++)
-    {
-      const uchar* ptr = i.scanLine(y);
-      for (int x=0;x<i.width();x++)
-      {
-        pixel[0] = *ptr;
-        ++ptr;
-        ++pixel;
-      }
-    }
+    scanline::copyGray<uint8_t>(i.constBits(),i.bytesPerLine(),img);
   }
   else
   {
+    if (i.depth() != 32) i = i.convertToFormat(QImage::Format_RGB32);
     img = FitsImage(info.baseName(),i.width(),i.height(),3);
-    PixelIterator pixel = img.getPixelIterator();
-    for (int y=0;y<i.height();y++)
-    {
-      const QRgb* rgb = reinterpret_cast<QRgb*>(i.scanLine(y));
-      for (int x=0;x<i.width();x++)
-      {
-        RGBValue v(*rgb);
-        pixel[0] = v.red();
-        pixel[1] = v.green();
-        pixel[2] = v.blue();
-        ++rgb;
-        ++pixel;
-      }
-    }
+    scanline::copyRGB32(i.constBits(),i.bytesPerLine(),img);
   }
   ImageMetadata data = img.getMetadata();
   readMetadata(filename,&data);
@@ -89,12 +68,13 @@ std::vector<std::shared_ptr<FitsObject>> QtImageIO::read(QString filename)
 #endif
   img.setMetadata(data);
   profiler.stop();
-  logProfiler(img,"read");
+  logProfiler(profiler,img,"read");
   return {std::make_shared<FitsObject>(img,filename)};
 }
 
 bool QtImageIO::write(QString filename, const FitsObject& obj)
 {
+  SimpleProfiler profiler("QtImageIO");
   profiler.start();
   const FitsImage& img = obj.getImage();
   Histogram h;
@@ -106,7 +86,7 @@ bool QtImageIO::write(QString filename, const FitsObject& obj)
   writeExif(filename,img);
 #endif
   profiler.stop();
-  logProfiler(img,"write");
+  logProfiler(profiler,img,"write");
   return true;
 }
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - DSLR raw image format reader                                        *
  *                                                                              *
- * modified: 2025-11-03                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -21,8 +21,10 @@
  ********************************************************************************/
 
 #include "rawio.h"
+#include "scanlineconverter.h"
 #include "../fitsimage.h"
 #include "../fitsobject.h"
+#include "../settings.h"
 #include <QFileInfo>
 
 const char* RawIO::FILENAME_FILTER = "Canon Raw Data (*.crw);;Other Raw Data (*)";
@@ -45,6 +47,7 @@ bool RawIO::handlesFile(const QString &filename)
 std::vector<std::shared_ptr<FitsObject>> RawIO::read(QString filename)
 {
   QFileInfo info(filename);
+  SimpleProfiler profiler("RawIO");
   profiler.start();
   LibRaw ip;
 #ifdef USE_16BITRAW
@@ -59,80 +62,115 @@ std::vector<std::shared_ptr<FitsObject>> RawIO::read(QString filename)
   }
   err = ip.unpack();
   if (err != LIBRAW_SUCCESS) throw std::runtime_error("Failed to load image");
-  err = ip.dcraw_process();
+  QString pattern;
+  if (Settings().isRawCFAImport()) pattern = getCFAPattern(ip);
+  /* sensors without a plain 2x2 Bayer pattern are always interpolated by libraw */
+  FitsImage img = pattern.isEmpty() ? readProcessed(ip,info) : readCFA(ip,info);
+  ImageMetadata meta = img.getMetadata();
+  meta.setExposureTime(ip.imgdata.other.shutter);
+  meta.setObserver(ip.imgdata.other.artist);
+  meta.setInstrument(ip.imgdata.idata.model);
+  meta.setObsDateTime(QDateTime::fromTime_t(ip.imgdata.other.timestamp));
+  if (!pattern.isEmpty()) meta.addEntry("BAYERPAT",pattern,"Bayer color filter array pattern");
+  img.setMetadata(meta);
+  profiler.stop();
+  logProfiler(profiler,img,pattern.isEmpty()?"read":"read CFA");
+  return {std::make_shared<FitsObject>(img,filename)};
+}
+
+bool RawIO::write(QString /*filename*/, const FitsObject& /*img*/)
+{
+  throw std::runtime_error("Writing to raw format not supported.");
+}
+
+
+FitsImage RawIO::readProcessed(LibRaw& ip, const QFileInfo& info)
+{
+  int32_t err = ip.dcraw_process();
   if (err != LIBRAW_SUCCESS) throw std::runtime_error("Failed to load image");
   libraw_processed_image_t *image = ip.dcraw_make_mem_image(&err);
-  if (image)
+  if (!image) throw std::runtime_error("Failed to load image");
+  if (image->type != LIBRAW_IMAGE_BITMAP)
+  {
+    LibRaw::dcraw_clear_mem(image);
+    throw std::runtime_error("Failed to load image");
+  }
+  if (image->colors != 3 && image->colors != 1)
+  {
+    LibRaw::dcraw_clear_mem(image);
+    throw std::runtime_error("Only monochrome and 3-color images supported");
+  }
+  FitsImage img(info.baseName(),image->width,image->height,image->colors);
+  if (image->colors == 1)
   {
-    if (image->type != LIBRAW_IMAGE_BITMAP) throw std::runtime_error("Failed to load image");
-    if (image->colors != 3 && image->colors != 1) throw std::runtime_error("Only monochrome and 3-color images supported");
-//    if (image->bits != 8) throw std::runtime_error("Only 8 bpp images supported");
-    FitsImage img(info.baseName(),image->width,image->height,image->colors);
-    PixelIterator it = img.getPixelIterator();
-    if (image->colors == 1)
+    if (image->bits == 8)
     {
-      if (image->bits == 8)
-      {
-        copyGray<uint8_t>(&img,image);
-      }
-      else
-      {
-        copyGray<uint16_t>(&img,image);
-      }
+      copyGray<uint8_t>(&img,image);
     }
     else
     {
-      if (image->bits == 8)
-      {
-        copyColor<uint8_t>(&img,image);
-      }
-      else
-      {
-        copyColor<uint16_t>(&img,image);
-      }
+      copyGray<uint16_t>(&img,image);
     }
-    LibRaw::dcraw_clear_mem(image);
-    ImageMetadata meta = img.getMetadata();
-    meta.setExposureTime(ip.imgdata.other.shutter);
-    meta.setObserver(ip.imgdata.other.artist);
-    meta.setInstrument(ip.imgdata.idata.model);
-    meta.setObsDateTime(QDateTime::fromTime_t(ip.imgdata.other.timestamp));
-    img.setMetadata(meta);
-    profiler.stop();
-    logProfiler(img,"read");
-    return {std::make_shared<FitsObject>(img,filename)};
   }
   else
-    throw std::runtime_error("Failed to load image");
+  {
+    if (image->bits == 8)
+    {
+      copyColor<uint8_t>(&img,image);
+    }
+    else
+    {
+      copyColor<uint16_t>(&img,image);
+    }
+  }
+  LibRaw::dcraw_clear_mem(image);
+  return img;
 }
 
-bool RawIO::write(QString /*filename*/, const FitsObject& /*img*/)
+FitsImage RawIO::readCFA(LibRaw& ip, const QFileInfo& info)
 {
-  throw std::runtime_error("Writing to raw format not supported.");
+  const libraw_image_sizes_t& s = ip.imgdata.sizes;
+  const uint16_t* raw = ip.imgdata.rawdata.raw_image;
+  size_t pitch = s.raw_pitch;
+  const uint16_t* visible = raw + static_cast<size_t>(s.top_margin) * (pitch / sizeof(uint16_t)) + s.left_margin;
+  FitsImage img(info.baseName(),s.width,s.height,1);
+  scanline::copyGray<uint16_t>(visible,pitch,img);
+  return img;
 }
 
-
-template<typename T> void RawIO::copyGray(FitsImage* img, libraw_processed_image_t* src)
+QString RawIO::getCFAPattern(LibRaw& ip) const
 {
-  PixelIterator it = img->getPixelIterator();
-  T* ptr = (T*)src->data;
-  for (uint32_t i=0;i<static_cast<uint32_t>(src->width)*static_cast<uint32_t>(src->height);i++)
+  if (ip.imgdata.rawdata.raw_image == nullptr || ip.imgdata.idata.filters < 1000) return "";
+  if (ip.imgdata.sizes.width < 2 || ip.imgdata.sizes.height < 2) return "";
+  static const char* colors = "RGBG";
+  QString pattern;
+  for (int y=0;y<2;y++)
   {
-    it[0] = *ptr;
-    ++it;
-    ++ptr;
+    for (int x=0;x<2;x++)
+    {
+      int c = ip.COLOR(y,x);
+      if (c < 0 || c > 3) return "";
+      /* the pattern must repeat every two pixels */
+      for (int dy=0;dy<4;dy+=2)
+      {
+        for (int dx=0;dx<4;dx+=2)
+        {
+          if (ip.COLOR(y+dy,x+dx) != c) return "";
+        }
+      }
+      pattern += colors[c];
+    }
   }
+  if (pattern.count('R') != 1 || pattern.count('B') != 1) return "";
+  return pattern;
+}
+
+template<typename T> void RawIO::copyGray(FitsImage* img, libraw_processed_image_t* src)
+{
+  scanline::copyGray<T>(src->data,static_cast<size_t>(src->width)*sizeof(T),*img);
 }
 
 template<typename T> void RawIO::copyColor(FitsImage* img, libraw_processed_image_t* src)
 {
-  PixelIterator it = img->getPixelIterator();
-  T* ptr = (T*)src->data;
-  for (uint32_t i=0;i<static_cast<uint32_t>(src->width)*static_cast<uint32_t>(src->height);i++)
-  {
-    it[0] = *ptr++;
-    it[1] = *ptr++;
-    it[2] = *ptr++;
-    ++it;
-  }
+  scanline::copyRGB<T>(src->data,static_cast<size_t>(src->width)*3*sizeof(T),*img);
 }
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - DSLR raw image format reader                                        *
  *                                                                              *
- * modified: 2025-11-03                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -26,6 +26,8 @@
 #include "iohandler.h"
 #include <libraw/libraw.h>
 
+class QFileInfo;
+
 class RawIO: public IOHandler
 {
 public:
@@ -41,6 +43,9 @@ public:
   static const char* FILENAME_FILTER;
 
 private:
+  FitsImage readProcessed(LibRaw& ip, const QFileInfo& info);
+  FitsImage readCFA(LibRaw& ip, const QFileInfo& info);
+  QString getCFAPattern(LibRaw& ip) const;
   template<typename T> void copyGray(FitsImage* img, libraw_processed_image_t* src);
   template<typename T> void copyColor(FitsImage* img, libraw_processed_image_t* src);
 
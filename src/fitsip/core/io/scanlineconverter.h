@@ -0,0 +1,142 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - bulk conversion of raw scanlines into image layers                  *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef SCANLINECONVERTER_H
+#define SCANLINECONVERTER_H
+
+#include "../fitsimage.h"
+#include "../fitstypes.h"
+#include "../parallel.h"
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Bulk converters from the sample formats of the image readers to
+ *        the planar layers of a FitsImage.
+ *
+ * The inner loops work on plain contiguous pointers without aliasing, so the
+ * compiler can vectorize them. The images are split into blocks of rows
+ * which are converted in parallel on the thread pool.
+ */
+namespace scanline
+{
+  /**
+   * @brief Convert a run of samples to the layer type.
+   */
+  template<typename T> inline void convert(const T* __restrict src, ValueType* __restrict dst, size_t n)
+  {
+    for (size_t i=0;i<n;++i) dst[i] = static_cast<ValueType>(src[i]);
+  }
+
+  /**
+   * @brief Split a run of interleaved 3-sample pixels into three planes.
+   */
+  template<typename T> inline void deinterleave(const T* __restrict src, ValueType* __restrict r, ValueType* __restrict g, ValueType* __restrict b, size_t n)
+  {
+    for (size_t i=0;i<n;++i)
+    {
+      r[i] = static_cast<ValueType>(src[3*i]);
+      g[i] = static_cast<ValueType>(src[3*i+1]);
+      b[i] = static_cast<ValueType>(src[3*i+2]);
+    }
+  }
+
+  /**
+   * @brief Split a run of 0xAARRGGBB pixels (QRgb) into three planes.
+   */
+  inline void unpackRGB32(const uint32_t* __restrict src, ValueType* __restrict r, ValueType* __restrict g, ValueType* __restrict b, size_t n)
+  {
+    for (size_t i=0;i<n;++i)
+    {
+      uint32_t v = src[i];
+      r[i] = static_cast<ValueType>((v >> 16) & 0xFF);
+      g[i] = static_cast<ValueType>((v >> 8) & 0xFF);
+      b[i] = static_cast<ValueType>(v & 0xFF);
+    }
+  }
+
+  /**
+   * @brief Copy single channel samples into the first layer of an image.
+   * @param src pointer to the first sample
+   * @param stride distance between two rows in bytes
+   * @param img the image with the destination layer
+   */
+  template<typename T> void copyGray(const void* src, size_t stride, FitsImage& img)
+  {
+    const int w = img.getWidth();
+    ValueType* dst = img.getLayer(0).getData();
+    const char* base = static_cast<const char*>(src);
+    parallel::forRange(img.getHeight(),[=](int y0, int y1){
+      for (int y=y0;y<y1;++y)
+      {
+        convert(reinterpret_cast<const T*>(base+y*stride),dst+static_cast<size_t>(y)*w,w);
+      }
+    },16);
+  }
+
+  /**
+   * @brief Copy interleaved RGB samples into the first three layers of an image.
+   * @param src pointer to the first sample
+   * @param stride distance between two rows in bytes
+   * @param img the image with the destination layers
+   */
+  template<typename T> void copyRGB(const void* src, size_t stride, FitsImage& img)
+  {
+    const int w = img.getWidth();
+    ValueType* r = img.getLayer(0).getData();
+    ValueType* g = img.getLayer(1).getData();
+    ValueType* b = img.getLayer(2).getData();
+    const char* base = static_cast<const char*>(src);
+    parallel::forRange(img.getHeight(),[=](int y0, int y1){
+      for (int y=y0;y<y1;++y)
+      {
+        size_t offset = static_cast<size_t>(y) * w;
+        deinterleave(reinterpret_cast<const T*>(base+y*stride),r+offset,g+offset,b+offset,w);
+      }
+    },16);
+  }
+
+  /**
+   * @brief Copy 0xAARRGGBB pixels into the first three layers of an image.
+   * @param src pointer to the first pixel
+   * @param stride distance between two rows in bytes
+   * @param img the image with the destination layers
+   */
+  inline void copyRGB32(const void* src, size_t stride, FitsImage& img)
+  {
+    const int w = img.getWidth();
+    ValueType* r = img.getLayer(0).getData();
+    ValueType* g = img.getLayer(1).getData();
+    ValueType* b = img.getLayer(2).getData();
+    const char* base = static_cast<const char*>(src);
+    parallel::forRange(img.getHeight(),[=](int y0, int y1){
+      for (int y=y0;y<y1;++y)
+      {
+        size_t offset = static_cast<size_t>(y) * w;
+        unpackRGB32(reinterpret_cast<const uint32_t*>(base+y*stride),r+offset,g+offset,b+offset,w);
+      }
+    },16);
+  }
+
+}
+
+#endif // SCANLINECONVERTER_H
@@ -0,0 +1,252 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - internal scratch image format                                       *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "scratchio.h"
+#include "scanlineconverter.h"
+#include "../fitsimage.h"
+#include "../fitsobject.h"
+#include "../parallel.h"
+#include "../settings.h"
+#include <QDataStream>
+#include <QFile>
+#include <QFileInfo>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+const char* ScratchIO::FILENAME_FILTER = "FitsIP Scratch Image (*.fsc)";
+
+static const char* sc_magic = "FIPSCRAT";
+static const quint32 sc_version = 1;
+static const quint32 sc_flag_shuffle = 0x01;
+/* chunk data starts at a page boundary, so uncompressed layers can be mapped */
+static const qint64 sc_alignment = 4096;
+/* target size of an uncompressed chunk */
+static const qint64 sc_chunk_bytes = 256 * 1024;
+
+namespace
+{
+
+struct Chunk
+{
+  int layer;
+  int row;
+  int rows;
+};
+
+/* group the bytes of equal significance of n samples of the given size */
+void shuffle(const char* src, char* dst, size_t n, size_t size)
+{
+  for (size_t b=0;b<size;++b)
+  {
+    char* out = dst + b * n;
+    for (size_t i=0;i<n;++i) out[i] = src[i*size+b];
+  }
+}
+
+void unshuffle(const char* src, char* dst, size_t n, size_t size)
+{
+  for (size_t b=0;b<size;++b)
+  {
+    const char* in = src + b * n;
+    for (size_t i=0;i<n;++i) dst[i*size+b] = in[i];
+  }
+}
+
+std::vector<Chunk> makeChunks(int height, int depth, int rows)
+{
+  std::vector<Chunk> chunks;
+  for (int l=0;l<depth;++l)
+  {
+    for (int y=0;y<height;y+=rows) chunks.push_back({l,y,std::min(rows,height-y)});
+  }
+  return chunks;
+}
+
+}
+
+ScratchIO::ScratchIO()
+{
+}
+
+ScratchIO::~ScratchIO()
+{
+}
+
+std::vector<std::shared_ptr<FitsObject>> ScratchIO::read(QString filename)
+{
+  SimpleProfiler profiler("ScratchIO");
+  profiler.start();
+  QFile f(filename);
+  if (!f.open(QFile::ReadOnly)) throw std::runtime_error("ScratchIO: failed to open file "+filename.toStdString());
+  const uchar* data = f.map(0,f.size());
+  if (!data) throw std::runtime_error("ScratchIO: failed to map file "+filename.toStdString());
+  QByteArray bytes = QByteArray::fromRawData(reinterpret_cast<const char*>(data),static_cast<int>(std::min<qint64>(f.size(),INT_MAX)));
+  QDataStream s(bytes);
+  s.setByteOrder(QDataStream::LittleEndian);
+  char magic[8];
+  if (s.readRawData(magic,8) != 8 || memcmp(magic,sc_magic,8) != 0) throw std::runtime_error("ScratchIO: not a scratch image");
+  quint32 version, flags, sampleSize;
+  qint32 width, height, depth, rows;
+  s >> version >> flags >> sampleSize >> width >> height >> depth >> rows;
+  if (version != sc_version) throw std::runtime_error("ScratchIO: unsupported version");
+  if (sampleSize != sizeof(float) && sampleSize != sizeof(double)) throw std::runtime_error("ScratchIO: unsupported sample size");
+  if (width <= 0 || height <= 0 || depth <= 0 || rows <= 0) throw std::runtime_error("ScratchIO: invalid header");
+  QString name;
+  quint32 count;
+  s >> name >> count;
+  std::map<QString,ImageMetadata::Entry> entries;
+  for (quint32 i=0;i<count;++i)
+  {
+    QString key;
+    ImageMetadata::Entry entry;
+    s >> key >> entry.value >> entry.comment;
+    entries[key] = entry;
+  }
+  QStringList history;
+  s >> history;
+  std::vector<Chunk> chunks = makeChunks(height,depth,rows);
+  std::vector<quint64> offsets(chunks.size());
+  std::vector<quint64> sizes(chunks.size());
+  for (size_t i=0;i<chunks.size();++i) s >> offsets[i] >> sizes[i];
+  if (s.status() != QDataStream::Ok) throw std::runtime_error("ScratchIO: truncated header");
+  for (size_t i=0;i<chunks.size();++i)
+  {
+    if (offsets[i] + sizes[i] > static_cast<quint64>(f.size())) throw std::runtime_error("ScratchIO: truncated file");
+  }
+  FitsImage img(name,width,height,depth);
+  parallel::forRange(static_cast<int>(chunks.size()),[&](int c0, int c1){
+    QByteArray raw;
+    QByteArray samples;
+    for (int c=c0;c<c1;++c)
+    {
+      const Chunk& chunk = chunks[c];
+      size_t n = static_cast<size_t>(chunk.rows) * width;
+      size_t rawsize = n * sampleSize;
+      const char* src = reinterpret_cast<const char*>(data + offsets[c]);
+      if (sizes[c] != rawsize)
+      {
+        raw = qUncompress(reinterpret_cast<const uchar*>(src),static_cast<int>(sizes[c]));
+        if (static_cast<size_t>(raw.size()) != rawsize) throw std::runtime_error("ScratchIO: corrupt chunk");
+        src = raw.constData();
+      }
+      if (flags & sc_flag_shuffle)
+      {
+        samples.resize(static_cast<int>(rawsize));
+        unshuffle(src,samples.data(),n,sampleSize);
+        src = samples.constData();
+      }
+      ValueType* dst = img.getLayer(chunk.layer).getData() + static_cast<size_t>(chunk.row) * width;
+      if (sampleSize == sizeof(ValueType))
+        memcpy(dst,src,rawsize);
+      else if (sampleSize == sizeof(float))
+        scanline::convert(reinterpret_cast<const float*>(src),dst,n);
+      else
+        scanline::convert(reinterpret_cast<const double*>(src),dst,n);
+    }
+  });
+  f.unmap(const_cast<uchar*>(data));
+  ImageMetadata metadata;
+  metadata.setEntries(entries);
+  metadata.setHistory(history);
+  img.setMetadata(metadata);
+  profiler.stop();
+  logProfiler(profiler,img,"read");
+  return {std::make_shared<FitsObject>(img,filename)};
+}
+
+bool ScratchIO::write(QString filename, const FitsObject& obj)
+{
+  SimpleProfiler profiler("ScratchIO");
+  profiler.start();
+  const FitsImage& img = obj.getImage();
+  const int width = img.getWidth();
+  const int height = img.getHeight();
+  const int depth = img.getDepth();
+  const size_t sampleSize = sizeof(ValueType);
+  const int level = std::clamp(Settings().getScratchCompression(),0,9);
+  const bool compress = level > 0;
+  const qint32 rows = static_cast<qint32>(std::max<qint64>(1,sc_chunk_bytes/(static_cast<qint64>(width)*sampleSize)));
+  std::vector<Chunk> chunks = makeChunks(height,depth,rows);
+  /* compress all chunks in parallel; the order in the file is fixed */
+  std::vector<QByteArray> packed(chunks.size());
+  if (compress)
+  {
+    parallel::forRange(static_cast<int>(chunks.size()),[&](int c0, int c1){
+      QByteArray shuffled;
+      for (int c=c0;c<c1;++c)
+      {
+        const Chunk& chunk = chunks[c];
+        size_t n = static_cast<size_t>(chunk.rows) * width;
+        const char* src = reinterpret_cast<const char*>(img.getLayer(chunk.layer).getData() + static_cast<size_t>(chunk.row) * width);
+        shuffled.resize(static_cast<int>(n*sampleSize));
+        shuffle(src,shuffled.data(),n,sampleSize);
+        packed[c] = qCompress(shuffled,level);
+        /* a chunk which does not shrink is stored as is */
+        if (static_cast<size_t>(packed[c].size()) >= n * sampleSize) packed[c] = shuffled;
+      }
+    });
+  }
+  QByteArray header;
+  QDataStream s(&header,QIODevice::WriteOnly);
+  s.setByteOrder(QDataStream::LittleEndian);
+  s.writeRawData(sc_magic,8);
+  s << sc_version << static_cast<quint32>(compress ? sc_flag_shuffle : 0) << static_cast<quint32>(sampleSize);
+  s << static_cast<qint32>(width) << static_cast<qint32>(height) << static_cast<qint32>(depth) << rows;
+  s << img.getName();
+  const auto& entries = img.getMetadata().getEntries();
+  s << static_cast<quint32>(entries.size());
+  for (const auto& entry : entries) s << entry.first << entry.second.value << entry.second.comment;
+  s << img.getMetadata().getHistory();
+  /* the header size is known before the table is filled in */
+  qint64 tableSize = static_cast<qint64>(chunks.size()) * 2 * sizeof(quint64);
+  quint64 offset = static_cast<quint64>(((header.size() + tableSize + sc_alignment - 1) / sc_alignment) * sc_alignment);
+  for (size_t i=0;i<chunks.size();++i)
+  {
+    quint64 size = compress ? packed[i].size() : static_cast<quint64>(chunks[i].rows) * width * sampleSize;
+    s << offset << size;
+    offset += size;
+  }
+  header.append(QByteArray(static_cast<int>((sc_alignment - header.size() % sc_alignment) % sc_alignment),'\0'));
+  QFile f(filename);
+  if (!f.open(QFile::WriteOnly|QFile::Truncate)) throw std::runtime_error("ScratchIO: failed to open file "+filename.toStdString());
+  bool ok = f.write(header) == header.size();
+  for (size_t i=0;ok && i<chunks.size();++i)
+  {
+    if (compress)
+    {
+      ok = f.write(packed[i]) == packed[i].size();
+    }
+    else
+    {
+      const Chunk& chunk = chunks[i];
+      qint64 size = static_cast<qint64>(chunk.rows) * width * sampleSize;
+      ok = f.write(reinterpret_cast<const char*>(img.getLayer(chunk.layer).getData() + static_cast<size_t>(chunk.row) * width),size) == size;
+    }
+  }
+  if (!ok) throw std::runtime_error("ScratchIO: failed to write file "+filename.toStdString());
+  profiler.stop();
+  logProfiler(profiler,img,compress?QString("write level %1").arg(level):"write uncompressed");
+  return true;
+}
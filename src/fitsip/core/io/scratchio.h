@@ -0,0 +1,58 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - internal scratch image format                                       *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef SCRATCHIO_H
+#define SCRATCHIO_H
+
+#include "iohandler.h"
+
+/**
+ * @brief Handler for the internal scratch image format.
+ *
+ * The format is meant for intermediate images which are written and read
+ * again by FitsIP itself. Each layer is split into chunks of whole rows
+ * which are compressed independently and in parallel. A byte shuffle
+ * groups the bytes of equal significance of all samples before
+ * compression. Without compression the chunks of a layer form one block of
+ * samples in the layout of Layer, aligned to the page size, so the file
+ * can be memory mapped.
+ *
+ * File layout (little endian):
+ *   magic "FIPSCRAT", version, flags, sample size, width, height, depth,
+ *   rows per chunk, image name, metadata, chunk table (offset and size of
+ *   every chunk, layer by layer), padding, chunk data
+ */
+class ScratchIO: public IOHandler
+{
+public:
+  ScratchIO();
+  ~ScratchIO() override;
+
+  virtual std::vector<std::shared_ptr<FitsObject>> read(QString filename) override;
+
+  virtual bool write(QString filename, const FitsObject& obj) override;
+
+  static const char* FILENAME_FILTER;
+
+};
+
+#endif // SCRATCHIO_H
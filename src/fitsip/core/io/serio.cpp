@@ -0,0 +1,54 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - SER video reader                                                    *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "serio.h"
+#include "servideo.h"
+#include "../fitsimage.h"
+#include "../fitsobject.h"
+#include <stdexcept>
+
+const char* SerIO::FILENAME_FILTER = "SER Video (*.ser)";
+
+SerIO::SerIO()
+{
+}
+
+SerIO::~SerIO()
+{
+}
+
+std::vector<std::shared_ptr<FitsObject>> SerIO::read(QString filename)
+{
+  SimpleProfiler profiler("SerIO");
+  profiler.start();
+  SerVideo video(filename);
+  if (video.getFrameCount() == 0) throw std::runtime_error("SerIO: the video contains no frames");
+  FitsImage img = video.getFrame(0);
+  profiler.stop();
+  logProfiler(profiler,img,QString("read frame 0 of %1").arg(video.getFrameCount()));
+  return {std::make_shared<FitsObject>(img,filename)};
+}
+
+bool SerIO::write(QString /*filename*/, const FitsObject& /*obj*/)
+{
+  throw std::runtime_error("Writing to SER format not supported.");
+}
@@ -0,0 +1,49 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - SER video reader                                                    *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef SERIO_H
+#define SERIO_H
+
+#include "iohandler.h"
+
+/**
+ * @brief Handler for SER videos.
+ *
+ * Reading a SER file returns its first frame only; videos often contain
+ * thousands of frames. Operators which process all frames access them
+ * through a FrameSequence.
+ */
+class SerIO: public IOHandler
+{
+public:
+  SerIO();
+  ~SerIO() override;
+
+  virtual std::vector<std::shared_ptr<FitsObject>> read(QString filename) override;
+
+  virtual bool write(QString filename, const FitsObject& obj) override;
+
+  static const char* FILENAME_FILTER;
+
+};
+
+#endif // SERIO_H
@@ -0,0 +1,252 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - memory mapped SER video file                                        *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "servideo.h"
+#include "scanlineconverter.h"
+#include "../parallel.h"
+#include <QFileInfo>
+#include <QtEndian>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#ifdef Q_OS_UNIX
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+static const int HEADER_SIZE = 178;
+
+/* time stamps count 100ns ticks since 0001-01-01 */
+static const int64_t TICKS_UNIX_EPOCH = 621355968000000000LL;
+
+static int32_t readInt32(const uchar* ptr)
+{
+  return qFromLittleEndian<qint32>(ptr);
+}
+
+static int64_t readInt64(const uchar* ptr)
+{
+  return qFromLittleEndian<qint64>(ptr);
+}
+
+static QString readString(const uchar* ptr, int len)
+{
+  return QString::fromLatin1(reinterpret_cast<const char*>(ptr),static_cast<int>(strnlen(reinterpret_cast<const char*>(ptr),len))).trimmed();
+}
+
+static QDateTime fromTicks(int64_t ticks)
+{
+  if (ticks <= TICKS_UNIX_EPOCH) return QDateTime();
+  return QDateTime::fromMSecsSinceEpoch((ticks-TICKS_UNIX_EPOCH)/10000,Qt::UTC);
+}
+
+SerVideo::SerVideo(const QString& filename):
+  file(filename),
+  data(nullptr),
+  name(QFileInfo(filename).baseName()),
+  colorId(MONO),
+  width(0),
+  height(0),
+  depth(0),
+  frameCount(0),
+  littleEndian(true),
+  hasTimestamps(false)
+{
+  if (!file.open(QFile::ReadOnly)) throw std::runtime_error("SerVideo: failed to open file "+filename.toStdString());
+  if (file.size() < HEADER_SIZE) throw std::runtime_error("SerVideo: not a SER file");
+  data = file.map(0,file.size());
+  if (!data) throw std::runtime_error("SerVideo: failed to map file "+filename.toStdString());
+  if (memcmp(data,"LUCAM-RECORDER",14) != 0) throw std::runtime_error("SerVideo: not a SER file");
+  colorId = static_cast<ColorId>(readInt32(data+18));
+  switch (colorId)
+  {
+    case MONO:
+    case BAYER_RGGB:
+    case BAYER_GRBG:
+    case BAYER_GBRG:
+    case BAYER_BGGR:
+    case RGB:
+    case BGR:
+      break;
+    default:
+      throw std::runtime_error("SerVideo: unsupported color format");
+  }
+  /* the specification says 1 for little endian, but capture programs write 0
+     for little endian data, which has become the de facto standard */
+  littleEndian = readInt32(data+22) == 0;
+  width = readInt32(data+26);
+  height = readInt32(data+30);
+  depth = readInt32(data+34);
+  frameCount = readInt32(data+38);
+  if (width <= 0 || height <= 0 || depth < 1 || depth > 16 || frameCount < 0) throw std::runtime_error("SerVideo: invalid header");
+  /* truncated captures are common, only use the frames actually present */
+  int64_t available = (file.size() - HEADER_SIZE) / static_cast<int64_t>(getFrameSize());
+  if (available < frameCount) frameCount = static_cast<int>(available);
+  hasTimestamps = file.size() >= HEADER_SIZE + static_cast<int64_t>(getFrameSize()) * frameCount + 8LL * frameCount;
+  metadata.setObserver(readString(data+42,40));
+  metadata.setInstrument(readString(data+82,40));
+  metadata.setTelescope(readString(data+122,40));
+  QDateTime start = fromTicks(readInt64(data+170));
+  if (start.isValid()) metadata.setObsDateTime(start);
+  switch (colorId)
+  {
+    case BAYER_RGGB:
+      metadata.addEntry("BAYERPAT","RGGB","Bayer color filter array pattern");
+      break;
+    case BAYER_GRBG:
+      metadata.addEntry("BAYERPAT","GRBG","Bayer color filter array pattern");
+      break;
+    case BAYER_GBRG:
+      metadata.addEntry("BAYERPAT","GBRG","Bayer color filter array pattern");
+      break;
+    case BAYER_BGGR:
+      metadata.addEntry("BAYERPAT","BGGR","Bayer color filter array pattern");
+      break;
+    default:
+      break;
+  }
+}
+
+SerVideo::~SerVideo()
+{
+  if (data) file.unmap(data);
+}
+
+bool SerVideo::isSerFile(const QString& filename)
+{
+  QFile f(filename);
+  if (!f.open(QFile::ReadOnly)) return false;
+  return f.read(14) == "LUCAM-RECORDER";
+}
+
+int SerVideo::getFrameCount() const
+{
+  return frameCount;
+}
+
+int SerVideo::getWidth() const
+{
+  return width;
+}
+
+int SerVideo::getHeight() const
+{
+  return height;
+}
+
+SerVideo::ColorId SerVideo::getColorId() const
+{
+  return colorId;
+}
+
+int SerVideo::getPlanes() const
+{
+  return (colorId == RGB || colorId == BGR) ? 3 : 1;
+}
+
+int SerVideo::getBytesPerSample() const
+{
+  return depth > 8 ? 2 : 1;
+}
+
+size_t SerVideo::getFrameSize() const
+{
+  return static_cast<size_t>(width) * height * getPlanes() * getBytesPerSample();
+}
+
+const uchar* SerVideo::getFrameData(int index) const
+{
+  if (index < 0 || index >= frameCount) throw std::runtime_error("SerVideo: frame index out of range");
+  return data + HEADER_SIZE + getFrameSize() * index;
+}
+
+FitsImage SerVideo::getFrame(int index) const
+{
+  const uchar* src = getFrameData(index);
+  FitsImage img(QString("%1_%2").arg(name).arg(index,5,10,QChar('0')),width,height,getPlanes());
+  if (getBytesPerSample() == 1)
+    copyFrame<uint8_t>(src,img);
+  else
+    copyFrame<uint16_t>(src,img);
+  ImageMetadata meta = metadata;
+  QDateTime t = getTimestamp(index);
+  if (t.isValid()) meta.setObsDateTime(t);
+  img.setMetadata(meta);
+  return img;
+}
+
+QDateTime SerVideo::getTimestamp(int index) const
+{
+  if (!hasTimestamps || index < 0 || index >= frameCount) return QDateTime();
+  return fromTicks(readInt64(data+HEADER_SIZE+getFrameSize()*frameCount+8*static_cast<size_t>(index)));
+}
+
+void SerVideo::prefetch(int first, int count) const
+{
+#ifdef Q_OS_UNIX
+  first = std::max(0,first);
+  int last = std::min(frameCount,first+count);
+  if (first >= last) return;
+  uintptr_t page = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+  uintptr_t begin = reinterpret_cast<uintptr_t>(getFrameData(first)) & ~(page - 1);
+  uintptr_t end = reinterpret_cast<uintptr_t>(getFrameData(last-1)) + getFrameSize();
+  posix_madvise(reinterpret_cast<void*>(begin),end-begin,POSIX_MADV_WILLNEED);
+#else
+  Q_UNUSED(first)
+  Q_UNUSED(count)
+#endif
+}
+
+const ImageMetadata& SerVideo::getMetadata() const
+{
+  return metadata;
+}
+
+template<typename T> void SerVideo::copyFrame(const uchar* src, FitsImage& img) const
+{
+  const int planes = getPlanes();
+  const size_t samples = static_cast<size_t>(width) * planes;
+  const bool swap = sizeof(T) > 1 && littleEndian != (Q_BYTE_ORDER == Q_LITTLE_ENDIAN);
+  ValueType* l0 = img.getLayer(0).getData();
+  ValueType* l1 = planes > 1 ? img.getLayer(1).getData() : nullptr;
+  ValueType* l2 = planes > 1 ? img.getLayer(2).getData() : nullptr;
+  parallel::forRange(height,[&](int y0, int y1){
+    std::vector<T> buffer(swap ? samples : 0);
+    for (int y=y0;y<y1;++y)
+    {
+      const T* row = reinterpret_cast<const T*>(src + samples * sizeof(T) * y);
+      if (swap)
+      {
+        for (size_t i=0;i<samples;++i) buffer[i] = qbswap(row[i]);
+        row = buffer.data();
+      }
+      size_t offset = static_cast<size_t>(y) * width;
+      if (planes == 1)
+        scanline::convert(row,l0+offset,width);
+      else if (colorId == BGR)
+        scanline::deinterleave(row,l2+offset,l1+offset,l0+offset,width);
+      else
+        scanline::deinterleave(row,l0+offset,l1+offset,l2+offset,width);
+    }
+  },16);
+}
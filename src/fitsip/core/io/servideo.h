@@ -0,0 +1,146 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - memory mapped SER video file                                        *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef SERVIDEO_H
+#define SERVIDEO_H
+
+#include "../fitsimage.h"
+#include "../imagemetadata.h"
+#include <QDateTime>
+#include <QFile>
+#include <QString>
+#include <cstdint>
+
+/**
+ * @brief Read access to the frames of a SER video.
+ *
+ * SER files as written by planetary capture software contain a fixed size
+ * header followed by the uncompressed frames and an optional trailer with
+ * time stamps. The file is memory mapped, so a frame is only read from disk
+ * when its data is accessed. Frames can be accessed in any order and from
+ * several threads at once.
+ */
+class SerVideo
+{
+public:
+
+  enum ColorId { MONO=0, BAYER_RGGB=8, BAYER_GRBG=9, BAYER_GBRG=10, BAYER_BGGR=11, RGB=100, BGR=101 };
+
+  /**
+   * @brief Open and map a SER file.
+   *
+   * Throws a std::runtime_error if the file cannot be mapped or is not a
+   * supported SER file.
+   * @param filename the name of the file
+   */
+  explicit SerVideo(const QString& filename);
+  ~SerVideo();
+
+  SerVideo(const SerVideo&) = delete;
+  SerVideo& operator=(const SerVideo&) = delete;
+
+  /**
+   * @brief Check if the file has the SER file signature.
+   * @param filename the name of the file
+   * @return true if the file is a SER file
+   */
+  static bool isSerFile(const QString& filename);
+
+  int getFrameCount() const;
+
+  int getWidth() const;
+
+  int getHeight() const;
+
+  ColorId getColorId() const;
+
+  /**
+   * @brief Get the number of samples per pixel.
+   * @return 3 for RGB and BGR videos, 1 otherwise
+   */
+  int getPlanes() const;
+
+  /**
+   * @brief Get the number of bytes of a sample.
+   * @return 1 for up to 8 bit per sample, 2 otherwise
+   */
+  int getBytesPerSample() const;
+
+  size_t getFrameSize() const;
+
+  /**
+   * @brief Get a view of the raw data of a frame.
+   *
+   * The data is not copied; the pointer stays valid as long as the video
+   * object exists.
+   * @param index the index of the frame
+   * @return pointer to the first sample of the frame
+   */
+  const uchar* getFrameData(int index) const;
+
+  /**
+   * @brief Convert a frame to an image.
+   * @param index the index of the frame
+   * @return the image
+   */
+  FitsImage getFrame(int index) const;
+
+  /**
+   * @brief Get the time stamp of a frame.
+   * @param index the index of the frame
+   * @return the time stamp (UTC) or an invalid date if the file has none
+   */
+  QDateTime getTimestamp(int index) const;
+
+  /**
+   * @brief Announce that a range of frames will be read soon.
+   *
+   * The operating system is advised to read the pages of the frames ahead,
+   * so sequential access does not wait for the disk.
+   * @param first the first frame
+   * @param count the number of frames
+   */
+  void prefetch(int first, int count) const;
+
+  /**
+   * @brief Get the metadata from the file header.
+   * @return the metadata
+   */
+  const ImageMetadata& getMetadata() const;
+
+private:
+  template<typename T> void copyFrame(const uchar* src, FitsImage& img) const;
+
+  QFile file;
+  uchar* data;
+  QString name;
+  ColorId colorId;
+  int width;
+  int height;
+  int depth;
+  int frameCount;
+  bool littleEndian;
+  bool hasTimestamps;
+  ImageMetadata metadata;
+};
+
+#endif // SERVIDEO_H
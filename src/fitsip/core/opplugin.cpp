@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - base class for operation plugins                                    *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -24,6 +24,7 @@
 #include "settings.h"
 #include <io/iofactory.h>
 #include <QDir>
+#include <QTemporaryDir>
 
 Q_LOGGING_CATEGORY(LOG_PROFILER,"profiler");
 
@@ -73,6 +74,55 @@ OpPlugin::ResultType OpPlugin::execute(const std::vector<std::shared_ptr<FitsObj
   return execute(filelist,data);
 }
 
+bool OpPlugin::supportsBatch() const
+{
+  return false;
+}
+
+QStringList OpPlugin::getBatchParameters() const
+{
+  return QStringList();
+}
+
+OpPlugin::ResultType OpPlugin::executeBatch(std::shared_ptr<FitsObject> /*image*/, const QVariantMap& /*params*/)
+{
+  setError(getMenuEntry()+": no batch mode for single images");
+  return ERROR;
+}
+
+OpPlugin::ResultType OpPlugin::executeBatch(const std::vector<QFileInfo>& /*list*/, const QVariantMap& /*params*/)
+{
+  setError(getMenuEntry()+": no batch mode for file lists");
+  return ERROR;
+}
+
+OpPlugin::ResultType OpPlugin::executeBatch(const std::vector<std::shared_ptr<FitsObject>>& list, const QVariantMap& params)
+{
+  QTemporaryDir dir;
+  if (!dir.isValid())
+  {
+    setError(getMenuEntry()+": cannot create temporary directory");
+    return ERROR;
+  }
+  IOHandler* handler = IOFactory::getInstance()->getHandler("tmp.fsc");
+  std::vector<QFileInfo> files;
+  for (size_t i=0;i<list.size();++i)
+  {
+    QString fn = dir.filePath(QString("%1_%2.fsc").arg(i,5,10,QChar('0')).arg(QFileInfo(list[i]->getName()).completeBaseName()));
+    try
+    {
+      if (!handler->write(fn,*list[i])) throw std::runtime_error("failed to write "+fn.toStdString());
+    }
+    catch (const std::exception& ex)
+    {
+      setError(getMenuEntry()+": "+ex.what());
+      return ERROR;
+    }
+    files.push_back(QFileInfo(fn));
+  }
+  return executeBatch(files,params);
+}
+
 const std::vector<QFileInfo> OpPlugin::getFileList() const
 {
   return filelist;
@@ -92,6 +142,82 @@ void OpPlugin::setError(const QString &err)
   error = err;
 }
 
+bool OpPlugin::readBatchParameter(const QVariantMap& params, const QString& name, double def, double& value, double min, double max)
+{
+  value = def;
+  if (!params.contains(name)) return true;
+  bool ok;
+  value = params.value(name).toDouble(&ok);
+  if (!ok)
+  {
+    setError(QString("%1: parameter %2 is not a number: '%3'").arg(metaObject()->className(),name,params.value(name).toString()));
+    return false;
+  }
+  if (!(value >= min && value <= max))
+  {
+    setError(QString("%1: parameter %2=%3 is outside of the range %4..%5").arg(metaObject()->className(),name).arg(value).arg(min).arg(max));
+    return false;
+  }
+  return true;
+}
+
+bool OpPlugin::readBatchParameter(const QVariantMap& params, const QString& name, int def, int& value, int min, int max)
+{
+  value = def;
+  if (!params.contains(name)) return true;
+  bool ok;
+  value = params.value(name).toInt(&ok);
+  if (!ok)
+  {
+    setError(QString("%1: parameter %2 is not an integer: '%3'").arg(metaObject()->className(),name,params.value(name).toString()));
+    return false;
+  }
+  if (value < min || value > max)
+  {
+    setError(QString("%1: parameter %2=%3 is outside of the range %4..%5").arg(metaObject()->className(),name).arg(value).arg(min).arg(max));
+    return false;
+  }
+  return true;
+}
+
+bool OpPlugin::readBatchParameter(const QVariantMap& params, const QString& name, bool def, bool& value)
+{
+  value = def;
+  if (!params.contains(name)) return true;
+  QVariant v = params.value(name);
+  if (v.type() == QVariant::Bool)
+  {
+    value = v.toBool();
+    return true;
+  }
+  QString s = v.toString().toLower();
+  if (s == "true" || s == "1" || s == "yes" || s == "on")
+    value = true;
+  else if (s == "false" || s == "0" || s == "no" || s == "off")
+    value = false;
+  else
+  {
+    setError(QString("%1: parameter %2 is not a boolean: '%3'").arg(metaObject()->className(),name,v.toString()));
+    return false;
+  }
+  return true;
+}
+
+bool OpPlugin::readBatchParameter(const QVariantMap& params, const QString& name, const QString& def, const QStringList& choices, QString& value)
+{
+  value = params.value(name,def).toString();
+  for (const QString& choice : choices)
+  {
+    if (choice.compare(value,Qt::CaseInsensitive) == 0)
+    {
+      value = choice;
+      return true;
+    }
+  }
+  setError(QString("%1: parameter %2 must be one of %3: '%4'").arg(metaObject()->className(),name,choices.join(", "),value));
+  return false;
+}
+
 OpPlugin::ResultType OpPlugin::save(const FitsImage& image, const QString& outputpath, const QFileInfo &info, const QString& tag)
 {
   return save(std::make_shared<FitsObject>(image),outputpath,info,tag);
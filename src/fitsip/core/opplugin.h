@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - base class for operation plugins                                    *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -30,6 +30,9 @@
 #include <QFileInfo>
 #include <QLoggingCategory>
 #include <QRect>
+#include <QStringList>
+#include <QVariantMap>
+#include <limits>
 #include <vector>
 #include <memory>
 
@@ -79,6 +82,49 @@ public:
 
   virtual ResultType execute(const std::vector<std::shared_ptr<FitsObject>>& list, const OpPluginData& data=OpPluginData());
 
+  /**
+   * @brief Check if the plugin can be executed without user interaction.
+   *
+   * Plugins returning true implement at least one of the executeBatch()
+   * methods, which never show a dialog. They are used by the command line
+   * runner.
+   * @return true if batch execution is supported
+   */
+  virtual bool supportsBatch() const;
+
+  /**
+   * @brief Describe the parameters accepted by executeBatch().
+   * @return one entry per parameter in the form "name=default  description"
+   */
+  virtual QStringList getBatchParameters() const;
+
+  /**
+   * @brief Execute the plugin on an image without user interaction.
+   * @param image the image to process
+   * @param params the parameters by name
+   * @return result of the operation
+   */
+  virtual ResultType executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params);
+
+  /**
+   * @brief Execute the plugin on a list of files without user interaction.
+   * @param list the files to process
+   * @param params the parameters by name
+   * @return result of the operation
+   */
+  virtual ResultType executeBatch(const std::vector<QFileInfo>& list, const QVariantMap& params);
+
+  /**
+   * @brief Execute the plugin on a list of images without user interaction.
+   *
+   * The default implementation writes the images to temporary scratch files
+   * and calls the file list version.
+   * @param list the images to process
+   * @param params the parameters by name
+   * @return result of the operation
+   */
+  virtual ResultType executeBatch(const std::vector<std::shared_ptr<FitsObject>>& list, const QVariantMap& params);
+
   /**
    * @brief Get the file list generated by this plugin.
    *
@@ -105,6 +151,43 @@ signals:
 protected:
   void setError(const QString& err);
 
+  /**
+   * @brief Read a numeric parameter of executeBatch().
+   *
+   * A missing parameter takes the default value. If the value is not a
+   * number or outside of [min,max], the error is set.
+   * @param params the parameters by name
+   * @param name the name of the parameter
+   * @param def the default value
+   * @param value receives the value
+   * @param min the smallest valid value
+   * @param max the largest valid value
+   * @return true if the value is valid
+   */
+  bool readBatchParameter(const QVariantMap& params, const QString& name, double def, double& value,
+                          double min=std::numeric_limits<double>::lowest(), double max=std::numeric_limits<double>::max());
+
+  /**
+   * @brief Read an integer parameter of executeBatch(), like the numeric one.
+   * @return true if the value is valid
+   */
+  bool readBatchParameter(const QVariantMap& params, const QString& name, int def, int& value,
+                          int min=std::numeric_limits<int>::min(), int max=std::numeric_limits<int>::max());
+
+  /**
+   * @brief Read a boolean parameter of executeBatch().
+   *
+   * Accepts true, false, 1, 0, yes, no, on and off.
+   * @return true if the value is valid
+   */
+  bool readBatchParameter(const QVariantMap& params, const QString& name, bool def, bool& value);
+
+  /**
+   * @brief Read a parameter of executeBatch() with a fixed set of values.
+   * @return true if the value is one of the choices, compared without case
+   */
+  bool readBatchParameter(const QVariantMap& params, const QString& name, const QString& def, const QStringList& choices, QString& value);
+
   /**
    * @brief Save the image to disk
    * @param image the image to save
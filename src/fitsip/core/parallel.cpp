@@ -0,0 +1,130 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - helper for parallel execution on the thread pool                    *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "parallel.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <memory>
+
+namespace
+{
+
+struct State
+{
+  int n;
+  int chunk;
+  int chunks;
+  const std::function<void(int,int)>* func;
+  std::atomic<int> next{0};
+  int completed{0};
+  std::exception_ptr error;
+  QMutex mutex;
+  QWaitCondition done;
+};
+
+/* process chunks until none are left; the function is only accessed while
+   the calling thread is still waiting for the claimed chunk */
+void work(State* s)
+{
+  while (true)
+  {
+    int i = s->next.fetch_add(1);
+    if (i >= s->chunks) break;
+    int begin = i * s->chunk;
+    int end = std::min(begin+s->chunk,s->n);
+    std::exception_ptr error;
+    try
+    {
+      (*s->func)(begin,end);
+    }
+    catch (...)
+    {
+      error = std::current_exception();
+    }
+    QMutexLocker locker(&s->mutex);
+    if (error && !s->error) s->error = error;
+    if (++s->completed == s->chunks) s->done.wakeAll();
+  }
+}
+
+class Task: public QRunnable
+{
+public:
+  Task(std::shared_ptr<State> s):state(s)
+  {
+  }
+
+  void run() override
+  {
+    work(state.get());
+  }
+
+private:
+  std::shared_ptr<State> state;
+};
+
+}
+
+int parallel::getThreadCount()
+{
+  return std::max(1,QThreadPool::globalInstance()->maxThreadCount());
+}
+
+void parallel::forRange(int n, const std::function<void(int,int)>& func, int grain)
+{
+  if (n <= 0) return;
+  int threads = getThreadCount();
+  grain = std::max(1,grain);
+  /* a few chunks per thread for load balancing */
+  int chunk = std::max(grain,(n+4*threads-1)/(4*threads));
+  int chunks = (n + chunk - 1) / chunk;
+  if (threads == 1 || chunks == 1)
+  {
+    func(0,n);
+    return;
+  }
+  auto state = std::make_shared<State>();
+  state->n = n;
+  state->chunk = chunk;
+  state->chunks = chunks;
+  state->func = &func;
+  for (int i=1;i<std::min(threads,chunks);++i)
+  {
+    QThreadPool::globalInstance()->start(new Task(state));
+  }
+  work(state.get());
+  QMutexLocker locker(&state->mutex);
+  while (state->completed < state->chunks) state->done.wait(&state->mutex);
+  if (state->error) std::rethrow_exception(state->error);
+}
+
+QMutex& parallel::getPlannerMutex()
+{
+  static QMutex mutex;
+  return mutex;
+}
@@ -0,0 +1,65 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - helper for parallel execution on the thread pool                    *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+
+class QMutex;
+
+namespace parallel
+{
+  /**
+   * @brief Get the number of threads used for parallel execution.
+   * @return the maximum thread count of the global thread pool
+   */
+  extern int getThreadCount();
+
+  /**
+   * @brief Execute a function for the range [0,n) split into chunks.
+   *
+   * The function is called as func(begin,end) for consecutive chunks of the
+   * range. The chunks are processed by the global thread pool and by the
+   * calling thread, which returns after all chunks are done. Since the
+   * calling thread takes part in the work, the method can be nested without
+   * the danger of dead locks. The first exception thrown by any chunk is
+   * rethrown in the calling thread.
+   * @param n the size of the range
+   * @param func the function to call
+   * @param grain the minimum chunk size
+   */
+  extern void forRange(int n, const std::function<void(int,int)>& func, int grain=1);
+
+  /**
+   * @brief Get the mutex serializing the FFTW planner.
+   *
+   * Only fftw_execute() is thread safe; every creation and destruction of a
+   * plan has to hold this mutex, since plugins run concurrently from the
+   * GUI, scripts and worker threads.
+   * @return the process wide mutex
+   */
+  extern QMutex& getPlannerMutex();
+
+}
+
+#endif // PARALLEL_H
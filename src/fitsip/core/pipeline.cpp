@@ -0,0 +1,735 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - processing pipeline                                                 *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "pipeline.h"
+#include "fitsobject.h"
+#include "opplugin.h"
+#include "parallel.h"
+#include "pluginfactory.h"
+#include "settings.h"
+#include "io/framesequence.h"
+#include "io/iofactory.h"
+#include "io/iohandler.h"
+#include <QCoreApplication>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRunnable>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QThread>
+#include <QThreadPool>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+
+struct Pipeline::Step
+{
+  QString id;
+  OpPlugin* plugin = nullptr;
+  QVariantMap params;
+  int input = -1;                    // index of the input step, -1 = input files
+  bool reduce = false;               // plugin requires a file list
+  bool checkpoint = false;
+  bool output = false;
+  std::vector<int> mapConsumers;
+  std::vector<int> reduceConsumers;
+  QMutex* mutex = nullptr;           // shared by all steps using the same plugin
+};
+
+struct Pipeline::Frame
+{
+  size_t index;
+  QString base;                      // base name for output and checkpoint files
+  FrameReport* report;               // only for the input frames
+};
+
+namespace
+{
+
+class FrameTask: public QRunnable
+{
+public:
+  explicit FrameTask(std::function<void()> func):
+    func(func)
+  {
+  }
+
+  void run() override
+  {
+    func();
+  }
+
+private:
+  std::function<void()> func;
+};
+
+uint64_t imageBytes(const FitsImage& img)
+{
+  return static_cast<uint64_t>(img.getWidth()) * img.getHeight() * img.getDepth() * sizeof(ValueType);
+}
+
+std::shared_ptr<FitsObject> copyObject(const std::shared_ptr<FitsObject>& obj)
+{
+  return std::make_shared<FitsObject>(obj->getImage(),obj->getFilename());
+}
+
+std::shared_ptr<FitsObject> readScratch(const QString& filename)
+{
+  IOHandler* handler = IOFactory::getInstance()->getHandler(filename);
+  auto list = handler->read(filename);
+  if (list.empty()) throw std::runtime_error("no image in "+filename.toStdString());
+  return list.front();
+}
+
+/* write to a temporary name first, so an interrupted run leaves no partial checkpoint */
+void writeScratch(const QString& filename, const FitsObject& obj)
+{
+  QFileInfo info(filename);
+  QString tmp = info.dir().filePath(info.completeBaseName()+".part."+info.suffix());
+  IOHandler* handler = IOFactory::getInstance()->getHandler(tmp);
+  if (!handler->write(tmp,obj)) throw std::runtime_error("failed to write "+tmp.toStdString());
+  QFile::remove(filename);
+  if (!QFile::rename(tmp,filename)) throw std::runtime_error("failed to write "+filename.toStdString());
+}
+
+QString baseName(const FrameSequence& frames, size_t index)
+{
+  if (frames.getFrameIndex(index) >= 0)
+  {
+    return QString("%1_%2").arg(frames.getFileInfo(index).completeBaseName()).arg(frames.getFrameIndex(index),5,10,QChar('0'));
+  }
+  return QFileInfo(frames.getName(index)).completeBaseName();
+}
+
+/* a video that cannot be opened fails the run instead of being skipped */
+std::unique_ptr<FrameSequence> openSequence(const std::vector<QFileInfo>& list)
+{
+  auto seq = std::make_unique<FrameSequence>(list);
+  if (!seq->getErrors().isEmpty()) throw std::runtime_error(seq->getErrors().join("\n").toStdString());
+  return seq;
+}
+
+std::vector<QFileInfo> readFileList(const QString& filename)
+{
+  QFile file(filename);
+  if (!file.open(QFile::ReadOnly|QFile::Text)) throw std::runtime_error("cannot read "+filename.toStdString());
+  std::vector<QFileInfo> list;
+  QTextStream s(&file);
+  while (!s.atEnd())
+  {
+    QString line = s.readLine();
+    if (!line.isEmpty()) list.push_back(QFileInfo(line));
+  }
+  return list;
+}
+
+void writeFileList(const QString& filename, const std::vector<QFileInfo>& list)
+{
+  QFile file(filename);
+  if (!file.open(QFile::WriteOnly|QFile::Text|QFile::Truncate)) throw std::runtime_error("cannot write "+filename.toStdString());
+  QTextStream s(&file);
+  for (const QFileInfo& info : list) s << info.absoluteFilePath() << "\n";
+}
+
+}
+
+/*
+ * Frames collected for a reducing step. As long as they fit into the
+ * budget they are kept in memory, afterwards all of them are moved to
+ * scratch files.
+ */
+class Pipeline::Collector
+{
+public:
+  Collector(const QString& id, const QString& dir, uint64_t budget):
+    id(id),
+    dir(dir),
+    bytes(0),
+    budget(budget),
+    spilled(false)
+  {
+  }
+
+  void add(const Frame& frame, std::shared_ptr<FitsObject> obj, QThread* owner)
+  {
+    uint64_t size = imageBytes(obj->getImage());
+    QMutexLocker lock(&mutex);
+    if (!spilled && bytes + size > budget)
+    {
+      spilled = true;
+      for (auto& entry : objects) files[entry.first] = write(entry.first,*entry.second);
+      objects.clear();
+      bytes = 0;
+    }
+    if (spilled)
+    {
+      lock.unlock();
+      QString fn = write(frame.index,*obj);
+      lock.relock();
+      files[frame.index] = fn;
+    }
+    else
+    {
+      obj->moveToThread(owner);
+      objects[frame.index] = obj;
+      bytes += size;
+    }
+  }
+
+  bool isSpilled() const
+  {
+    return spilled;
+  }
+
+  std::vector<std::shared_ptr<FitsObject>> getObjects() const
+  {
+    std::vector<std::shared_ptr<FitsObject>> list;
+    for (const auto& entry : objects) list.push_back(entry.second);
+    return list;
+  }
+
+  std::vector<QFileInfo> getFiles() const
+  {
+    std::vector<QFileInfo> list;
+    for (const auto& entry : files) list.push_back(QFileInfo(entry.second));
+    return list;
+  }
+
+  void clear()
+  {
+    objects.clear();
+    for (const auto& entry : files) QFile::remove(entry.second);
+    files.clear();
+  }
+
+private:
+  QString write(size_t index, const FitsObject& obj) const
+  {
+    QString fn = QDir(dir).filePath(QString("%1_%2.fsc").arg(id).arg(index,5,10,QChar('0')));
+    writeScratch(fn,obj);
+    return fn;
+  }
+
+  QString id;
+  QString dir;
+  QMutex mutex;
+  std::map<size_t,std::shared_ptr<FitsObject>> objects;
+  std::map<size_t,QString> files;
+  uint64_t bytes;
+  uint64_t budget;
+  bool spilled;
+};
+
+/*
+ * Image produced on demand. Steps only ask for their input, if they cannot
+ * use a checkpoint, so nothing upstream of a checkpoint is computed.
+ */
+class Pipeline::LazyImage
+{
+public:
+  explicit LazyImage(std::function<std::shared_ptr<FitsObject>()> func):
+    func(func)
+  {
+  }
+
+  std::shared_ptr<FitsObject> get()
+  {
+    if (!value) value = func();
+    return value;
+  }
+
+  /* plugins modify their input, so every consumer but the last gets a copy */
+  std::shared_ptr<FitsObject> take(bool copy)
+  {
+    return copy ? copyObject(get()) : get();
+  }
+
+private:
+  std::function<std::shared_ptr<FitsObject>()> func;
+  std::shared_ptr<FitsObject> value;
+};
+
+Pipeline::Pipeline(PluginFactory* plugins, QObject* parent):
+  QObject(parent),
+  plugins(plugins),
+  input(std::make_unique<Step>()),
+  outputFormat("fts"),
+  budget(static_cast<uint64_t>(Settings().getLoaderMemoryBudget())*1024*1024),
+  threadCount(0),
+  outputCount(0),
+  cancelled(false),
+  owner(nullptr)
+{
+  input->id = "input";
+}
+
+Pipeline::~Pipeline()
+{
+}
+
+void Pipeline::load(const QString& filename)
+{
+  QFile file(filename);
+  if (!file.open(QFile::ReadOnly)) throw std::runtime_error("cannot read recipe "+filename.toStdString());
+  parse(file.readAll());
+  if (name.isEmpty()) name = QFileInfo(filename).completeBaseName();
+}
+
+void Pipeline::parse(const QByteArray& json)
+{
+  QJsonParseError err;
+  QJsonDocument doc = QJsonDocument::fromJson(json,&err);
+  if (doc.isNull()) throw std::runtime_error(("invalid recipe: "+err.errorString()).toStdString());
+  if (!doc.isObject()) throw std::runtime_error("invalid recipe: not a JSON object");
+  QJsonObject root = doc.object();
+  name = root.value("name").toString();
+  checkpointDir = root.value("checkpoint").toString();
+  QJsonObject output = root.value("output").toObject();
+  outputDir = output.value("dir").toString();
+  outputSuffix = output.value("suffix").toString();
+  outputFormat = output.value("format").toString("fts");
+  steps.clear();
+  pluginMutexes.clear();
+  input = std::make_unique<Step>();
+  input->id = "input";
+  QJsonArray array = root.value("steps").toArray();
+  if (array.isEmpty()) throw std::runtime_error("invalid recipe: no steps");
+  std::map<QString,int> ids;
+  std::vector<bool> explicitOutput;
+  std::vector<OpPlugin*> oplist = plugins->getOpPlugins();
+  for (int i=0;i<array.size();++i)
+  {
+    QJsonObject o = array[i].toObject();
+    auto step = std::make_unique<Step>();
+    step->id = o.value("id").toString(QString("step%1").arg(i+1));
+    if (step->id == "input" || ids.find(step->id) != ids.end())
+    {
+      throw std::runtime_error(("invalid recipe: duplicate step id "+step->id).toStdString());
+    }
+    QString op = o.value("op").toString();
+    for (OpPlugin* p : oplist)
+    {
+      if (op.compare(p->metaObject()->className(),Qt::CaseInsensitive) == 0) step->plugin = p;
+    }
+    if (!step->plugin) throw std::runtime_error(("invalid recipe: unknown operation "+op).toStdString());
+    /* plugins are single instances; steps using the same op must not run it at the same time */
+    step->mutex = &pluginMutexes[step->plugin];
+    if (!step->plugin->supportsBatch())
+    {
+      throw std::runtime_error(("invalid recipe: "+op+" cannot be run without user interaction").toStdString());
+    }
+    QVariantMap params = o.value("params").toObject().toVariantMap();
+    for (auto it=params.begin();it!=params.end();++it) step->params[it.key().toLower()] = it.value();
+    QString in = o.value("input").toString(i == 0 ? QString("input") : steps.back()->id);
+    if (in != "input")
+    {
+      auto it = ids.find(in);
+      if (it == ids.end()) throw std::runtime_error(("invalid recipe: unknown input "+in+" of step "+step->id).toStdString());
+      step->input = it->second;
+    }
+    step->reduce = step->plugin->requiresFileList();
+    step->checkpoint = o.value("checkpoint").toBool(false);
+    step->output = o.value("output").toBool(false);
+    explicitOutput.push_back(o.contains("output"));
+    Step& src = node(step->input);
+    if (step->reduce)
+      src.reduceConsumers.push_back(i);
+    else
+      src.mapConsumers.push_back(i);
+    ids[step->id] = i;
+    steps.push_back(std::move(step));
+  }
+  outputCount = 0;
+  for (size_t i=0;i<steps.size();++i)
+  {
+    Step& step = *steps[i];
+    if (!explicitOutput[i] && step.mapConsumers.empty() && step.reduceConsumers.empty()) step.output = true;
+    if (step.output) ++outputCount;
+  }
+}
+
+QString Pipeline::getName() const
+{
+  return name;
+}
+
+void Pipeline::setOutputDir(const QString& dir)
+{
+  outputDir = dir;
+}
+
+QString Pipeline::getOutputDir() const
+{
+  return outputDir;
+}
+
+void Pipeline::setOutputSuffix(const QString& suffix)
+{
+  outputSuffix = suffix;
+}
+
+void Pipeline::setOutputFormat(const QString& format)
+{
+  outputFormat = format;
+}
+
+void Pipeline::setCheckpointDir(const QString& dir)
+{
+  checkpointDir = dir;
+}
+
+QString Pipeline::getCheckpointDir() const
+{
+  return checkpointDir;
+}
+
+void Pipeline::setMemoryBudget(uint64_t bytes)
+{
+  budget = bytes;
+}
+
+void Pipeline::setThreadCount(int n)
+{
+  threadCount = n;
+}
+
+bool Pipeline::run(const std::vector<QFileInfo>& files)
+{
+  error.clear();
+  warnings.clear();
+  results.clear();
+  written.clear();
+  reports.clear();
+  cancelled = false;
+  owner = QThread::currentThread();
+  if (steps.empty())
+  {
+    error = "no recipe loaded";
+    return false;
+  }
+  bool ok = true;
+  try
+  {
+    if (!outputDir.isEmpty() && !QDir().mkpath(outputDir)) throw std::runtime_error("cannot create output directory "+outputDir.toStdString());
+    for (const auto& step : steps)
+    {
+      if (!step->checkpoint) continue;
+      if (checkpointDir.isEmpty()) throw std::runtime_error("no checkpoint directory for step "+step->id.toStdString());
+      if (!QDir().mkpath(checkpointPath(*step))) throw std::runtime_error("cannot create checkpoint directory "+checkpointDir.toStdString());
+    }
+    /* frames for reducing steps fed by per frame steps are collected, unless the step is done */
+    collectors.clear();
+    for (size_t i=0;i<steps.size();++i)
+    {
+      const Step& step = *steps[i];
+      if (!step.reduce || step.input < 0 || steps[step.input]->reduce) continue;
+      if (step.checkpoint && QFileInfo::exists(checkpointPath(step)+".done")) continue;
+      if (!spillDir)
+      {
+        spillDir = checkpointDir.isEmpty() ? std::make_unique<QTemporaryDir>() : std::make_unique<QTemporaryDir>(QDir(checkpointDir).filePath("spill-XXXXXX"));
+        if (!spillDir->isValid()) throw std::runtime_error("cannot create scratch directory");
+      }
+      collectors[static_cast<int>(i)] = std::make_unique<Collector>(step.id,spillDir->path(),budget);
+    }
+    std::map<int,std::unique_ptr<FrameSequence>> sequences;
+    sequences[-1] = openSequence(files);
+    ok = processRegion(-1,*sequences[-1]);
+    for (size_t i=0;ok && i<steps.size();++i)
+    {
+      if (!steps[i]->reduce) continue;
+      sequences[static_cast<int>(i)] = reduce(static_cast<int>(i),files,sequences);
+      ok = processRegion(static_cast<int>(i),*sequences[static_cast<int>(i)]);
+    }
+  }
+  catch (const std::exception& ex)
+  {
+    error = ex.what();
+    ok = false;
+  }
+  for (auto& entry : collectors) entry.second->clear();
+  collectors.clear();
+  spillDir.reset();
+  flushWarnings();
+  if (ok && cancelled)
+  {
+    error = "cancelled";
+    ok = false;
+  }
+  return ok;
+}
+
+void Pipeline::cancel()
+{
+  cancelled = true;
+}
+
+QString Pipeline::getError() const
+{
+  return error;
+}
+
+const std::vector<std::shared_ptr<FitsObject>>& Pipeline::getResults() const
+{
+  return results;
+}
+
+const std::vector<QFileInfo>& Pipeline::getWrittenFiles() const
+{
+  return written;
+}
+
+const std::vector<Pipeline::FrameReport>& Pipeline::getFrameReports() const
+{
+  return reports;
+}
+
+Pipeline::Step& Pipeline::node(int index)
+{
+  return index < 0 ? *input : *steps[index];
+}
+
+bool Pipeline::needsFrames(int from)
+{
+  Step& n = node(from);
+  if (from >= 0 && !n.reduce)
+  {
+    for (int c : n.reduceConsumers)
+    {
+      if (collectors.find(c) != collectors.end()) return true;
+    }
+  }
+  for (int c : n.mapConsumers)
+  {
+    if (steps[c]->output || needsFrames(c)) return true;
+  }
+  return false;
+}
+
+bool Pipeline::processRegion(int root, const FrameSequence& frames)
+{
+  if (frames.empty() || !needsFrames(root)) return true;
+  emit message(QString("%1: %2 frames").arg(node(root).id).arg(frames.size()));
+  /* every frame in flight holds about two images (input and a copy) */
+  uint64_t estimate = std::max<uint64_t>(1,2*frames.estimateMemory(0));
+  int maxThreads = threadCount > 0 ? threadCount : parallel::getThreadCount();
+  int threads = static_cast<int>(std::max<uint64_t>(1,std::min<uint64_t>(maxThreads,budget/estimate)));
+  if (root < 0)
+  {
+    reports.resize(frames.size());
+    for (size_t i=0;i<frames.size();++i) reports[i].name = frames.getName(i);
+  }
+  QThreadPool pool;
+  pool.setMaxThreadCount(threads);
+  std::atomic<int> done(0);
+  for (size_t i=0;i<frames.size();++i)
+  {
+    Frame frame{i,baseName(frames,i),root < 0 ? &reports[i] : nullptr};
+    pool.start(new FrameTask([this,root,frame,&frames,&done](){
+      if (!cancelled)
+      {
+        QElapsedTimer timer;
+        timer.start();
+        try
+        {
+          LazyImage image([&frames,&frame](){
+            return std::make_shared<FitsObject>(frames.getImage(frame.index),frames.getFileInfo(frame.index).absoluteFilePath());
+          });
+          distribute(root,image,frame);
+          if (frame.report) frame.report->ok = !cancelled;
+        }
+        catch (const std::exception& ex)
+        {
+          warn(frames.getName(frame.index)+": "+ex.what());
+          if (frame.report) frame.report->error = ex.what();
+        }
+        if (frame.report) frame.report->time = timer.nsecsElapsed()/1000;
+      }
+      if (frame.report && !frame.report->ok && frame.report->error.isEmpty()) frame.report->error = "cancelled";
+      ++done;
+    }));
+  }
+  int reported = -1;
+  while (!pool.waitForDone(50))
+  {
+    if (done != reported)
+    {
+      reported = done;
+      emit progress(reported,static_cast<int>(frames.size()));
+    }
+    flushWarnings();
+    QCoreApplication::processEvents();
+  }
+  emit progress(static_cast<int>(frames.size()),static_cast<int>(frames.size()));
+  flushWarnings();
+  return !cancelled;
+}
+
+void Pipeline::distribute(int from, LazyImage& image, const Frame& frame)
+{
+  Step& n = node(from);
+  if (from >= 0 && !n.reduce)
+  {
+    for (int c : n.reduceConsumers)
+    {
+      auto it = collectors.find(c);
+      if (it != collectors.end()) it->second->add(frame,image.take(!n.mapConsumers.empty()),owner);
+    }
+  }
+  for (size_t k=0;k<n.mapConsumers.size() && !cancelled;++k)
+  {
+    processStep(n.mapConsumers[k],image,k+1 < n.mapConsumers.size(),frame);
+  }
+}
+
+void Pipeline::processStep(int index, LazyImage& input, bool copy, const Frame& frame)
+{
+  Step& step = *steps[index];
+  QString checkpoint;
+  if (step.checkpoint) checkpoint = QDir(checkpointPath(step)).filePath(QString("%1_%2.fsc").arg(frame.index,5,10,QChar('0')).arg(frame.base));
+  LazyImage image([&](){
+    if (!checkpoint.isEmpty() && QFileInfo::exists(checkpoint)) return readScratch(checkpoint);
+    std::shared_ptr<FitsObject> obj = input.take(copy);
+    {
+      QMutexLocker lock(step.mutex);
+      if (step.plugin->executeBatch(obj,step.params) != OpPlugin::OK)
+      {
+        throw std::runtime_error((step.id+": "+step.plugin->getError()).toStdString());
+      }
+    }
+    if (!checkpoint.isEmpty()) writeScratch(checkpoint,*obj);
+    return obj;
+  });
+  if (step.output)
+  {
+    QString fn = writeOutput(step,image.get(),frame.base);
+    if (frame.report && !fn.isEmpty()) frame.report->outputs.push_back(fn);
+  }
+  distribute(index,image,frame);
+}
+
+std::unique_ptr<FrameSequence> Pipeline::reduce(int index, const std::vector<QFileInfo>& files, const std::map<int,std::unique_ptr<FrameSequence>>& sequences)
+{
+  Step& step = *steps[index];
+  QString done = checkpointPath(step)+".done";
+  if (step.checkpoint && QFileInfo::exists(done))
+  {
+    emit message(step.id+": using checkpoint");
+    return openSequence(readFileList(done));
+  }
+  emit message(step.id+": running "+step.plugin->metaObject()->className());
+  QMutexLocker lock(step.mutex);
+  OpPlugin::ResultType ret;
+  auto it = collectors.find(index);
+  if (it != collectors.end())
+  {
+    Collector& collector = *it->second;
+    if (collector.isSpilled())
+      ret = step.plugin->executeBatch(collector.getFiles(),step.params);
+    else
+      ret = step.plugin->executeBatch(collector.getObjects(),step.params);
+    collector.clear();
+  }
+  else if (step.input < 0)
+  {
+    ret = step.plugin->executeBatch(files,step.params);
+  }
+  else
+  {
+    const FrameSequence& seq = *sequences.at(step.input);
+    if (seq.getObjects().empty())
+      ret = step.plugin->executeBatch(seq.getFiles(),step.params);
+    else
+      ret = step.plugin->executeBatch(seq.getObjects(),step.params);
+  }
+  if (ret != OpPlugin::OK) throw std::runtime_error((step.id+": "+step.plugin->getError()).toStdString());
+  std::vector<std::shared_ptr<FitsObject>> created = step.plugin->getCreatedImages();
+  std::vector<QFileInfo> list;
+  std::unique_ptr<FrameSequence> seq;
+  if (created.empty())
+  {
+    /* the plugin wrote files */
+    list = step.plugin->getFileList();
+    seq = openSequence(list);
+  }
+  else
+  {
+    for (size_t i=0;i<created.size();++i)
+    {
+      QString base = QFileInfo(created[i]->getName()).completeBaseName();
+      if (step.output) writeOutput(step,created[i],base);
+      if (step.checkpoint)
+      {
+        QString fn = QDir(checkpointPath(step)).filePath(QString("%1_%2.fsc").arg(i,5,10,QChar('0')).arg(base));
+        writeScratch(fn,*created[i]);
+        list.push_back(QFileInfo(fn));
+      }
+    }
+    seq = std::make_unique<FrameSequence>(created);
+  }
+  if (step.checkpoint) writeFileList(done,list);
+  return seq;
+}
+
+QString Pipeline::writeOutput(const Step& step, std::shared_ptr<FitsObject> obj, const QString& base)
+{
+  if (outputDir.isEmpty())
+  {
+    /* the image may still be modified by the following steps */
+    std::shared_ptr<FitsObject> result = copyObject(obj);
+    result->moveToThread(owner);
+    QMutexLocker lock(&mutex);
+    results.push_back(result);
+    return QString();
+  }
+  QString fn = QDir(outputDir).filePath(base+(outputCount > 1 ? "_"+step.id : QString())+outputSuffix+"."+outputFormat);
+  IOHandler* handler = IOFactory::getInstance()->getHandler(fn);
+  if (!handler) throw std::runtime_error("no writer for "+fn.toStdString());
+  if (!handler->write(fn,*obj)) throw std::runtime_error("failed to write "+fn.toStdString());
+  QMutexLocker lock(&mutex);
+  written.push_back(QFileInfo(fn));
+  return fn;
+}
+
+QString Pipeline::checkpointPath(const Step& step) const
+{
+  return QDir(checkpointDir).filePath(step.id);
+}
+
+void Pipeline::warn(const QString& msg)
+{
+  QMutexLocker lock(&mutex);
+  warnings.push_back(msg);
+}
+
+void Pipeline::flushWarnings()
+{
+  QStringList list;
+  {
+    QMutexLocker lock(&mutex);
+    list.swap(warnings);
+  }
+  for (const QString& msg : list) emit message(msg);
+}
@@ -0,0 +1,228 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - processing pipeline                                                 *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef PIPELINE_H
+#define PIPELINE_H
+
+#include <QFileInfo>
+#include <QMutex>
+#include <QObject>
+#include <QStringList>
+#include <QVariantMap>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+class FitsObject;
+class FrameSequence;
+class OpPlugin;
+class PluginFactory;
+class QTemporaryDir;
+class QThread;
+
+/**
+ * @brief Executes a processing recipe over a list of files.
+ *
+ * A recipe is a JSON document describing a graph of plugin steps:
+ *
+ *   {
+ *     "name": "m42",
+ *     "checkpoint": "/data/m42/checkpoint",
+ *     "output": { "dir": "/data/m42/out", "suffix": "_p", "format": "fts" },
+ *     "steps": [
+ *       { "id": "demosaic", "op": "OpDemosaic", "params": { "method": "gradient" } },
+ *       { "id": "stack", "op": "OpStack", "params": { "align": "template" }, "checkpoint": true },
+ *       { "id": "sqrt", "op": "OpSqrt", "input": "stack" }
+ *     ]
+ *   }
+ *
+ * Every step consumes the frames of one earlier step given by "input"
+ * (default: the previous step; "input" names the input files), so a
+ * recipe forms a tree. Plugins working on single images are mapped over
+ * the frames of their input; plugins requiring a file list reduce all
+ * frames to the images they create (or the files they write).
+ *
+ * Frames are processed in parallel and passed from step to step in
+ * memory. A plugin instance works on one frame at a time, so the frames
+ * proceed through the steps like on an assembly line. The number of frames
+ * in flight is limited by the thread count and the memory budget; frames
+ * collected for a reducing step are moved to scratch files when they
+ * exceed the budget.
+ *
+ * Steps with "checkpoint" set save their results in the checkpoint
+ * directory. When the recipe is run again, the saved results are loaded
+ * instead of executing the step and the steps it depends on.
+ *
+ * The results of steps with "output" set (default: the steps without
+ * consumers) are written to the output directory or, if no output
+ * directory is set, kept in memory (see getResults()).
+ */
+class Pipeline: public QObject
+{
+  Q_OBJECT
+public:
+  /**
+   * @brief Outcome of processing one input frame.
+   */
+  struct FrameReport
+  {
+    QString name;                    // name of the input file or frame
+    bool ok = false;
+    QString error;
+    qint64 time = 0;                 // processing time in microseconds
+    QStringList outputs;             // files written for the frame
+  };
+
+  explicit Pipeline(PluginFactory* plugins, QObject* parent=nullptr);
+  ~Pipeline() override;
+
+  /**
+   * @brief Load a recipe from a file.
+   *
+   * Throws a std::runtime_error if the recipe is invalid.
+   * @param filename the recipe file
+   */
+  void load(const QString& filename);
+
+  /**
+   * @brief Parse a recipe.
+   *
+   * Throws a std::runtime_error if the recipe is invalid.
+   * @param json the recipe
+   */
+  void parse(const QByteArray& json);
+
+  QString getName() const;
+
+  void setOutputDir(const QString& dir);
+
+  QString getOutputDir() const;
+
+  void setOutputSuffix(const QString& suffix);
+
+  void setOutputFormat(const QString& format);
+
+  void setCheckpointDir(const QString& dir);
+
+  QString getCheckpointDir() const;
+
+  /**
+   * @brief Set the memory budget for the frames in flight.
+   * @param bytes the budget in bytes
+   */
+  void setMemoryBudget(uint64_t bytes);
+
+  /**
+   * @brief Set the number of frames processed in parallel.
+   * @param n the thread count; 0 uses the configured number of threads
+   */
+  void setThreadCount(int n);
+
+  /**
+   * @brief Run the recipe.
+   *
+   * The method returns when all steps are done. Events of the calling
+   * thread are processed while the frames are worked on.
+   * @param files the input files
+   * @return true on success
+   */
+  bool run(const std::vector<QFileInfo>& files);
+
+  /**
+   * @brief Cancel a running recipe.
+   *
+   * Frames being processed will finish, but no further frames are started.
+   */
+  void cancel();
+
+  QString getError() const;
+
+  /**
+   * @brief Get the results of the output steps kept in memory.
+   * @return the images
+   */
+  const std::vector<std::shared_ptr<FitsObject>>& getResults() const;
+
+  /**
+   * @brief Get the files written by the output steps.
+   * @return the files
+   */
+  const std::vector<QFileInfo>& getWrittenFiles() const;
+
+  /**
+   * @brief Get the outcome for each input frame of the last run.
+   *
+   * Frames failing in one of the per frame steps are skipped by the
+   * following steps and do not make the run fail; their errors are
+   * reported here.
+   * @return the reports in the order of the input frames
+   */
+  const std::vector<FrameReport>& getFrameReports() const;
+
+signals:
+  void progress(int done, int total);
+
+  void message(QString msg);
+
+private:
+  struct Step;
+  struct Frame;
+  class Collector;
+  class LazyImage;
+
+  Step& node(int index);
+  bool needsFrames(int from);
+  bool processRegion(int root, const FrameSequence& frames);
+  void distribute(int from, LazyImage& image, const Frame& frame);
+  void processStep(int index, LazyImage& input, bool copy, const Frame& frame);
+  std::unique_ptr<FrameSequence> reduce(int index, const std::vector<QFileInfo>& files, const std::map<int,std::unique_ptr<FrameSequence>>& sequences);
+  QString writeOutput(const Step& step, std::shared_ptr<FitsObject> obj, const QString& base);
+  QString checkpointPath(const Step& step) const;
+  void warn(const QString& msg);
+  void flushWarnings();
+
+  PluginFactory* plugins;
+  QString name;
+  std::unique_ptr<Step> input;
+  std::vector<std::unique_ptr<Step>> steps;
+  std::map<OpPlugin*,QMutex> pluginMutexes;
+  std::map<int,std::unique_ptr<Collector>> collectors;
+  QString outputDir;
+  QString outputSuffix;
+  QString outputFormat;
+  QString checkpointDir;
+  uint64_t budget;
+  int threadCount;
+  int outputCount;
+  std::atomic<bool> cancelled;
+  QMutex mutex;
+  QString error;
+  QStringList warnings;
+  std::vector<std::shared_ptr<FitsObject>> results;
+  std::vector<QFileInfo> written;
+  std::vector<FrameReport> reports;
+  std::unique_ptr<QTemporaryDir> spillDir;
+  QThread* owner;
+};
+
+#endif // PIPELINE_H
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - list of selected pixels                                             *
  *                                                                              *
- * modified: 2025-03-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -44,6 +44,7 @@ void PixelList::clear()
     QModelIndex parent;
     beginRemoveRows(parent,0,pixels.size()-1);
     pixels.clear();
+    index.clear();
     endRemoveRows();
   }
 }
@@ -53,6 +54,7 @@ void PixelList::addPixel(const Pixel &pixel)
   QModelIndex parent;
   beginInsertRows(parent,pixels.size(),pixels.size());
   pixels.push_back(pixel);
+  updateIndex();
   endInsertRows();
 }
 
@@ -62,6 +64,7 @@ void PixelList::setPixels(const std::vector<Pixel> &list)
   QModelIndex parent;
   beginInsertRows(parent,0,list.size()-1);
   pixels = list;
+  updateIndex();
   endInsertRows();
 }
 
@@ -70,6 +73,19 @@ const std::vector<Pixel>& PixelList::getPixels() const
   return pixels;
 }
 
+const SpatialIndex& PixelList::getIndex() const
+{
+  return index;
+}
+
+void PixelList::updateIndex()
+{
+  std::vector<QPointF> points;
+  points.reserve(pixels.size());
+  for (const Pixel& pixel : pixels) points.emplace_back(pixel.x,pixel.y);
+  index.build(points);
+}
+
 void PixelList::removePixels(const QModelIndexList &list)
 {
   int shift = 0;
@@ -80,6 +96,7 @@ void PixelList::removePixels(const QModelIndexList &list)
     pixels.erase(pixels.begin()+row);
     ++shift;
   }
+  updateIndex();
   emit layoutChanged();
 }
 
@@ -138,6 +155,7 @@ void PixelList::shift(int dx, int dy)
     pixel.x += dx;
     pixel.y += dy;
   }
+  updateIndex();
 }
 
 bool PixelList::save(const QString &filename)
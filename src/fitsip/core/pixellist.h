@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - list of selected pixels                                             *
  *                                                                              *
- * modified: 2025-03-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -24,6 +24,7 @@
 #define PIXELLIST_H
 
 #include "pixel.h"
+#include "spatialindex.h"
 #include <QAbstractTableModel>
 #include <vector>
 
@@ -43,6 +44,15 @@ public:
 
   const std::vector<Pixel>& getPixels() const;
 
+  /**
+   * @brief Get the spatial index of the pixel positions.
+   *
+   * The index is kept in sync with the list; it refers to the pixels by
+   * their position in getPixels().
+   * @return the spatial index
+   */
+  const SpatialIndex& getIndex() const;
+
   void removePixels(const QModelIndexList& list);
 
   QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
@@ -62,7 +72,10 @@ public:
   PixelList* copy();
 
 private:
+  void updateIndex();
+
   std::vector<Pixel> pixels;
+  SpatialIndex index;
 
   static std::vector<QString> headers;
 
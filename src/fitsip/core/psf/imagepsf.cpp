@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - image based point-spread-function                                   *
  *                                                                              *
- * modified: 2025-06-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -24,6 +24,7 @@
 #include "../fitsobject.h"
 #include "../io/iofactory.h"
 #include <QFileInfo>
+#include <QDebug>
 
 ImagePSF::ImagePSF(QString filename):PSF(),
   filename(filename)
@@ -49,40 +50,44 @@ void ImagePSF::init()
 {
   if (!img)
   {
-    IOHandler* handler = IOFactory::getInstance()->getHandler(filename);
-    if (handler)
+    try
     {
-      img = handler->read(filename).front()->getImage();
+      /* the PSF image is only read, so it is shared with the image cache */
+      img = IOFactory::getInstance()->readImage(filename);
     }
-    if (!img)
+    catch (std::exception& ex)
     {
-      img = FitsImage(ImagePSF::getName(),50,50);
+      qWarning() << ex.what();
+    }
+    if (!img || !*img)
+    {
+      img = std::make_shared<const FitsImage>(ImagePSF::getName(),50,50);
     }
   }
 }
 
 FitsImage ImagePSF::createPSF(int w, int h, const std::vector<ValueType>& par) const
 {
-  if (w < img.getWidth()) w = img.getWidth();
-  if (h < img.getHeight()) h = img.getHeight();
-  FitsImage dst("",w,h,img.getDepth());
-  int iw2 = img.getWidth() / 2;
-  int iwodd = (img.getWidth() % 2);
-  int ih2 = img.getHeight() / 2;
-  int ihodd = (img.getHeight() % 2);
-  dst.blit(img,iw2,ih2,iw2+iwodd,ih2+ihodd,0,0);
-  dst.blit(img,0,0,iw2,ih2,dst.getWidth()-iw2,dst.getHeight()-ih2);
-  dst.blit(img,0,ih2,iw2,ih2+ihodd,dst.getWidth()-iw2,0);
-  dst.blit(img,iw2,0,iw2+iwodd,ih2,0,dst.getHeight()-ih2);
+  if (w < img->getWidth()) w = img->getWidth();
+  if (h < img->getHeight()) h = img->getHeight();
+  FitsImage dst("",w,h,img->getDepth());
+  int iw2 = img->getWidth() / 2;
+  int iwodd = (img->getWidth() % 2);
+  int ih2 = img->getHeight() / 2;
+  int ihodd = (img->getHeight() % 2);
+  dst.blit(*img,iw2,ih2,iw2+iwodd,ih2+ihodd,0,0);
+  dst.blit(*img,0,0,iw2,ih2,dst.getWidth()-iw2,dst.getHeight()-ih2);
+  dst.blit(*img,0,ih2,iw2,ih2+ihodd,dst.getWidth()-iw2,0);
+  dst.blit(*img,iw2,0,iw2+iwodd,ih2,0,dst.getHeight()-ih2);
   return dst;
 }
 
 FitsImage ImagePSF::createPSFForDisplay(int w, int h, const std::vector<ValueType>& par) const
 {
-  if (w < img.getWidth()) w = img.getWidth();
-  if (h < img.getHeight()) h = img.getHeight();
-  FitsImage dst("",w,h,img.getDepth());
-  dst.blit(img,0,0,img.getWidth(),img.getHeight(),(w-img.getWidth())/2,(h-img.getHeight())/2);
+  if (w < img->getWidth()) w = img->getWidth();
+  if (h < img->getHeight()) h = img->getHeight();
+  FitsImage dst("",w,h,img->getDepth());
+  dst.blit(*img,0,0,img->getWidth(),img->getHeight(),(w-img->getWidth())/2,(h-img->getHeight())/2);
   return dst;
 }
 
@@ -93,11 +98,11 @@ bool ImagePSF::isFixedSize() const
 
 int ImagePSF::getWidth() const
 {
-  return img.getWidth();
+  return img->getWidth();
 }
 
 int ImagePSF::getHeight() const
 {
-  return img.getHeight();
+  return img->getHeight();
 }
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - image based point-spread-function                                   *
  *                                                                              *
- * modified: 2025-06-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -50,7 +50,7 @@ private:
   void init();
 
   QString filename;
-  FitsImage img;
+  std::shared_ptr<const FitsImage> img;
 
 };
 
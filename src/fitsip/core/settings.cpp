@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - generic settings                                                    *
  *                                                                              *
- * modified: 2025-03-13                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -41,6 +41,10 @@ static const char* PREVIEW_HEIGHT = "fits/preview/height";
 static const char* IO_ALWAYS_FITS = "fits/io/alwaysfits";
 static const char* IO_METADATA_FILE = "fits/io/metadatafile";
 static const char* IO_FITS_IMGFORMAT = "fits/io/fitsimageformat";
+static const char* IO_LOADER_MEMORY = "fits/io/loadermemory";
+static const char* IO_IMAGE_CACHE = "fits/io/imagecache";
+static const char* IO_RAW_CFA = "fits/io/rawcfa";
+static const char* IO_SCRATCH_COMPRESSION = "fits/io/scratchcompression";
 
 static const char* TOOL_FILE_MANAGER = "fits/tools/filemanager";
 static const char* TOOL_SCRIPT_EDITOR = "fits/tools/scripteditor";
@@ -146,6 +150,46 @@ int Settings::getFitsImageFormat() const
   return settings.value(IO_FITS_IMGFORMAT,0).toInt();
 }
 
+void Settings::setLoaderMemoryBudget(int mb)
+{
+  settings.setValue(IO_LOADER_MEMORY,mb);
+}
+
+int Settings::getLoaderMemoryBudget() const
+{
+  return settings.value(IO_LOADER_MEMORY,2048).toInt();
+}
+
+void Settings::setImageCacheSize(int mb)
+{
+  settings.setValue(IO_IMAGE_CACHE,mb);
+}
+
+int Settings::getImageCacheSize() const
+{
+  return settings.value(IO_IMAGE_CACHE,512).toInt();
+}
+
+void Settings::setRawCFAImport(bool flag)
+{
+  settings.setValue(IO_RAW_CFA,flag);
+}
+
+bool Settings::isRawCFAImport() const
+{
+  return settings.value(IO_RAW_CFA,false).toBool();
+}
+
+void Settings::setScratchCompression(int level)
+{
+  settings.setValue(IO_SCRATCH_COMPRESSION,level);
+}
+
+int Settings::getScratchCompression() const
+{
+  return settings.value(IO_SCRATCH_COMPRESSION,1).toInt();
+}
+
 void Settings::setTool(Tools tool, QString cmd)
 {
   switch (tool)
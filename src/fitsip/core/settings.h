@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - generic settings                                                    *
  *                                                                              *
- * modified: 2025-08-19                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -105,6 +105,54 @@ public:
 
   int getFitsImageFormat() const;
 
+  /**
+   * @brief Set the memory budget for loading several images in parallel.
+   * @param mb the budget in MB
+   */
+  void setLoaderMemoryBudget(int mb);
+
+  /**
+   * @brief Get the memory budget for loading several images in parallel.
+   * @return the budget in MB
+   */
+  int getLoaderMemoryBudget() const;
+
+  /**
+   * @brief Set the size of the cache for decoded images.
+   * @param mb the size in MB; 0 disables the cache
+   */
+  void setImageCacheSize(int mb);
+
+  /**
+   * @brief Get the size of the cache for decoded images.
+   * @return the size in MB
+   */
+  int getImageCacheSize() const;
+
+  /**
+   * @brief Set if camera raw images are imported as undebayered CFA data.
+   * @param flag true to import the raw color filter array mosaic
+   */
+  void setRawCFAImport(bool flag);
+
+  /**
+   * @brief Get if camera raw images are imported as undebayered CFA data.
+   * @return true if the raw color filter array mosaic is imported
+   */
+  bool isRawCFAImport() const;
+
+  /**
+   * @brief Set the compression level of the internal scratch format.
+   * @param level 0 stores uncompressed data, 1-9 are zlib levels
+   */
+  void setScratchCompression(int level);
+
+  /**
+   * @brief Get the compression level of the internal scratch format.
+   * @return the level
+   */
+  int getScratchCompression() const;
+
   void setTool(Tools tool, QString cmd);
 
   QString getTool(Tools tool) const;
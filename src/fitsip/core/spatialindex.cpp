@@ -0,0 +1,186 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - spatial index for point lists                                       *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "spatialindex.h"
+#include <algorithm>
+#include <queue>
+
+/* ranges up to this size are searched linearly */
+static const size_t leafSize = 8;
+
+SpatialIndex::SpatialIndex()
+{
+}
+
+SpatialIndex::SpatialIndex(const std::vector<QPointF>& points)
+{
+  build(points);
+}
+
+void SpatialIndex::build(const std::vector<QPointF>& points)
+{
+  entries.resize(points.size());
+  for (size_t i=0;i<points.size();++i) entries[i] = {points[i].x(),points[i].y(),i};
+  build(0,entries.size(),0);
+}
+
+void SpatialIndex::clear()
+{
+  entries.clear();
+}
+
+bool SpatialIndex::empty() const
+{
+  return entries.empty();
+}
+
+size_t SpatialIndex::size() const
+{
+  return entries.size();
+}
+
+/*
+ * The tree is implicit: the median of a range is the node, the lower and
+ * upper half are its subtrees. The split axis alternates with the depth.
+ */
+void SpatialIndex::build(size_t lo, size_t hi, int axis)
+{
+  if (hi - lo <= leafSize) return;
+  size_t mid = (lo + hi) / 2;
+  std::nth_element(entries.begin()+lo,entries.begin()+mid,entries.begin()+hi,[axis](const Entry& e1, const Entry& e2){
+    return axis == 0 ? e1.x < e2.x : e1.y < e2.y;
+  });
+  build(lo,mid,1-axis);
+  build(mid+1,hi,1-axis);
+}
+
+/*
+ * Visits all entries whose squared distance from (x,y) does not exceed the
+ * bound. The visitor may shrink the bound while searching.
+ */
+template<class Visitor> void SpatialIndex::visit(size_t lo, size_t hi, int axis, double x, double y, double& bound, Visitor& visitor) const
+{
+  if (hi - lo <= leafSize)
+  {
+    for (size_t i=lo;i<hi;++i)
+    {
+      double dx = entries[i].x - x;
+      double dy = entries[i].y - y;
+      double d = dx * dx + dy * dy;
+      if (d <= bound) visitor(entries[i].index,d);
+    }
+    return;
+  }
+  size_t mid = (lo + hi) / 2;
+  const Entry& e = entries[mid];
+  double dx = e.x - x;
+  double dy = e.y - y;
+  double d = dx * dx + dy * dy;
+  if (d <= bound) visitor(e.index,d);
+  double delta = axis == 0 ? x - e.x : y - e.y;
+  if (delta < 0)
+  {
+    visit(lo,mid,1-axis,x,y,bound,visitor);
+    if (delta * delta <= bound) visit(mid+1,hi,1-axis,x,y,bound,visitor);
+  }
+  else
+  {
+    visit(mid+1,hi,1-axis,x,y,bound,visitor);
+    if (delta * delta <= bound) visit(lo,mid,1-axis,x,y,bound,visitor);
+  }
+}
+
+std::vector<size_t> SpatialIndex::findInRadius(const QPointF& p, double r) const
+{
+  std::vector<size_t> list;
+  if (entries.empty() || r < 0) return list;
+  double bound = r * r;
+  auto visitor = [&list](size_t index, double){ list.push_back(index); };
+  visit(0,entries.size(),0,p.x(),p.y(),bound,visitor);
+  return list;
+}
+
+std::vector<size_t> SpatialIndex::findNearest(const QPointF& p, size_t k, double maxdist) const
+{
+  std::vector<size_t> list;
+  if (entries.empty() || k == 0 || maxdist < 0) return list;
+  /* max heap of the k nearest entries found so far */
+  std::priority_queue<std::pair<double,size_t>> heap;
+  double bound = maxdist * maxdist;
+  auto visitor = [&](size_t index, double d){
+    if (heap.size() == k)
+    {
+      if (d >= heap.top().first) return;
+      heap.pop();
+    }
+    heap.push({d,index});
+    if (heap.size() == k) bound = heap.top().first;
+  };
+  visit(0,entries.size(),0,p.x(),p.y(),bound,visitor);
+  list.resize(heap.size());
+  for (size_t i=list.size();i>0;--i)
+  {
+    list[i-1] = heap.top().second;
+    heap.pop();
+  }
+  return list;
+}
+
+long SpatialIndex::findClosest(const QPointF& p, double maxdist) const
+{
+  if (entries.empty() || maxdist < 0) return -1;
+  long closest = -1;
+  double bound = maxdist * maxdist;
+  auto visitor = [&](size_t index, double d){
+    closest = static_cast<long>(index);
+    bound = d;
+  };
+  visit(0,entries.size(),0,p.x(),p.y(),bound,visitor);
+  return closest;
+}
+
+std::vector<size_t> SpatialIndex::findInRect(const QRectF& r) const
+{
+  std::vector<size_t> list;
+  if (!entries.empty()) findInRect(0,entries.size(),0,r.normalized(),list);
+  return list;
+}
+
+void SpatialIndex::findInRect(size_t lo, size_t hi, int axis, const QRectF& r, std::vector<size_t>& list) const
+{
+  auto inside = [&r](const Entry& e){
+    return e.x >= r.left() && e.x <= r.right() && e.y >= r.top() && e.y <= r.bottom();
+  };
+  if (hi - lo <= leafSize)
+  {
+    for (size_t i=lo;i<hi;++i) if (inside(entries[i])) list.push_back(entries[i].index);
+    return;
+  }
+  size_t mid = (lo + hi) / 2;
+  const Entry& e = entries[mid];
+  if (inside(e)) list.push_back(e.index);
+  double v = axis == 0 ? e.x : e.y;
+  double low = axis == 0 ? r.left() : r.top();
+  double high = axis == 0 ? r.right() : r.bottom();
+  if (low <= v) findInRect(lo,mid,1-axis,r,list);
+  if (high >= v) findInRect(mid+1,hi,1-axis,r,list);
+}
@@ -0,0 +1,105 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - spatial index for point lists                                       *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef SPATIALINDEX_H
+#define SPATIALINDEX_H
+
+#include <QPointF>
+#include <QRectF>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+/**
+ * @brief Two dimensional k-d tree over a list of points.
+ *
+ * The points are referred to by their position in the list the index was
+ * built from. The tree is static; when the list changes the index is built
+ * again, which takes O(n log n). Queries take O(log n) plus the number of
+ * points found. Concurrent queries are safe.
+ */
+class SpatialIndex
+{
+public:
+  SpatialIndex();
+  explicit SpatialIndex(const std::vector<QPointF>& points);
+
+  /**
+   * @brief Build the index.
+   * @param points the points to index
+   */
+  void build(const std::vector<QPointF>& points);
+
+  void clear();
+
+  bool empty() const;
+
+  size_t size() const;
+
+  /**
+   * @brief Find all points within a distance.
+   * @param p the center
+   * @param r the radius
+   * @return the indices of the points, in no particular order
+   */
+  std::vector<size_t> findInRadius(const QPointF& p, double r) const;
+
+  /**
+   * @brief Find the k nearest points.
+   * @param p the position
+   * @param k the maximum number of points
+   * @param maxdist the maximum distance
+   * @return the indices of the points, nearest first
+   */
+  std::vector<size_t> findNearest(const QPointF& p, size_t k, double maxdist=std::numeric_limits<double>::infinity()) const;
+
+  /**
+   * @brief Find the nearest point.
+   * @param p the position
+   * @param maxdist the maximum distance
+   * @return the index of the point or -1 if there is no point within maxdist
+   */
+  long findClosest(const QPointF& p, double maxdist=std::numeric_limits<double>::infinity()) const;
+
+  /**
+   * @brief Find all points inside a rectangle (including its border).
+   * @param r the rectangle
+   * @return the indices of the points, in no particular order
+   */
+  std::vector<size_t> findInRect(const QRectF& r) const;
+
+private:
+  struct Entry
+  {
+    double x;
+    double y;
+    size_t index;
+  };
+
+  void build(size_t lo, size_t hi, int axis);
+  template<class Visitor> void visit(size_t lo, size_t hi, int axis, double x, double y, double& bound, Visitor& visitor) const;
+  void findInRect(size_t lo, size_t hi, int axis, const QRectF& r, std::vector<size_t>& list) const;
+
+  std::vector<Entry> entries;
+};
+
+#endif // SPATIALINDEX_H
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - list of selected/detected stars                                     *
  *                                                                              *
- * modified: 2025-10-25                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -54,6 +54,7 @@ void StarList::clear()
     QModelIndex parent;
     beginRemoveRows(parent,0,stars.size()-1);
     stars.clear();
+    index.clear();
     endRemoveRows();
   }
 }
@@ -64,6 +65,7 @@ void StarList::setStars(const std::vector<Star> &list)
   QModelIndex parent;
   beginInsertRows(parent,0,list.size()-1);
   stars = list;
+  updateIndex();
   endInsertRows();
 }
 
@@ -72,6 +74,19 @@ const std::vector<Star>& StarList::getStars() const
   return stars;
 }
 
+const SpatialIndex& StarList::getIndex() const
+{
+  return index;
+}
+
+void StarList::updateIndex()
+{
+  std::vector<QPointF> points;
+  points.reserve(stars.size());
+  for (const Star& star : stars) points.emplace_back(star.getX(),star.getY());
+  index.build(points);
+}
+
 
 QVariant StarList::headerData(int section, Qt::Orientation orientation, int role) const
 {
@@ -134,6 +149,7 @@ void StarList::shift(double dx, double dy)
   {
     star.shift(dx,dy);
   }
+  updateIndex();
   emit layoutChanged();
 }
 
@@ -147,6 +163,7 @@ void StarList::rotate(double xc, double yc, double a)
   {
     star.rotate(xc,yc,sa,ca);
   }
+  updateIndex();
   emit layoutChanged();
 }
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - list of selected/detected stars                                     *
  *                                                                              *
- * modified: 2025-10-25                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -25,6 +25,7 @@
 
 #include "fitsimage.h"
 #include "pixellist.h"
+#include "spatialindex.h"
 #include "star.h"
 #include <QAbstractTableModel>
 #include <vector>
@@ -45,6 +46,15 @@ public:
 
   const std::vector<Star>& getStars() const;
 
+  /**
+   * @brief Get the spatial index of the star positions.
+   *
+   * The index is kept in sync with the list; it refers to the stars by their
+   * position in getStars().
+   * @return the spatial index
+   */
+  const SpatialIndex& getIndex() const;
+
   QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
 
   int rowCount(const QModelIndex &parent = QModelIndex()) const override;
@@ -62,7 +72,10 @@ public:
   bool load(const QString& filename);
 
 private:
+  void updateIndex();
+
   std::vector<Star> stars;
+  SpatialIndex index;
 
   static std::vector<QString> headers;
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - widget to select an image from memory or filesystem                 *
  *                                                                              *
- * modified: 2024-12-13                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -66,14 +66,13 @@ std::shared_ptr<FitsObject> ImageSelectWidget::getImage()
     QString fn = ui->filenameField->text();
     if (!fn.isEmpty())
     {
-      IOHandler* handler = IOFactory::getInstance()->getHandler(fn);
-      if (handler)
+      try
       {
-        return handler->read(fn).front();
+        return std::make_shared<FitsObject>(IOFactory::getInstance()->loadImage(fn),fn);
       }
-      else
+      catch (std::exception& ex)
       {
-        qWarning() << "No IOHandler for " << fn;
+        qWarning() << ex.what();
       }
     }
   }
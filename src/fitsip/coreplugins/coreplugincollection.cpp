@@ -4,6 +4,7 @@
 #include "opcombinechannels.h"
 #include "opcrop.h"
 #include "opcut.h"
+#include "opdemosaic.h"
 #include "opdiv.h"
 #include "opflipx.h"
 #include "opflipy.h"
@@ -38,6 +39,7 @@ CorePluginCollection::CorePluginCollection()
   plugins.push_back(new OpCombineChannels());
   plugins.push_back(new OpSplitChannels());
   plugins.push_back(new OpToGray());
+  plugins.push_back(new OpDemosaic());
   plugins.push_back(new OpAverage());
 }
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - plugin to add two images                                            *
  *                                                                              *
- * modified: 2025-03-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -65,7 +65,7 @@ void OpAdd::bindPython(void* mod) const
     obj1->getImage().log("Added image "+obj2->getImage().getName());
     return OK;
   },
-  "Add the second image to the first one",py::arg("obj1"),py::arg("obj2"));
+  "Add the second image to the first one",py::arg("obj1"),py::arg("obj2"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - combine RGB channels                                                *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -66,7 +66,7 @@ void OpCombineChannels::bindPython(void* mod) const
     auto img = combine(rimg,gimg,bimg);
     return std::make_shared<FitsObject>(img);
   },
-  "Combine RGB channels",py::arg("rimg"),py::arg("gimg"),py::arg("bimg"));
+  "Combine RGB channels",py::arg("rimg"),py::arg("gimg"),py::arg("bimg"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
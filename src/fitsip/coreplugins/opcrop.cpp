@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - crop image                                                          *
  *                                                                              *
- * modified: 2025-02-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -69,7 +69,7 @@ void OpCrop::bindPython(void* mod) const
       obj->getImage().log(QString("OpCrop: %1,%2 %3x%4").arg(x).arg(y).arg(w).arg(h));
       return OK;
     },
-    "Crop the image",py::arg("obj"),py::arg("x"),py::arg("y"),py::arg("w"),py::arg("h"));
+    "Crop the image",py::arg("obj"),py::arg("x"),py::arg("y"),py::arg("w"),py::arg("h"),py::call_guard<py::gil_scoped_release>());
   m->def("autocrop",[this](std::shared_ptr<FitsObject> obj, ValueType threshold, int border){
       QRect r = findArea(obj->getImage(),threshold,border);
       if (!r.isValid()) return ERROR;
@@ -79,7 +79,7 @@ void OpCrop::bindPython(void* mod) const
       obj->getImage().log(QString("OpCrop: %1,%2 %3x%4").arg(r.x()).arg(r.y()).arg(r.width()).arg(r.height()));
       return OK;
     },
-    "Automatically crop the image",py::arg("obj"),py::arg("threshold"),py::arg("border"));
+    "Automatically crop the image",py::arg("obj"),py::arg("threshold"),py::arg("border"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
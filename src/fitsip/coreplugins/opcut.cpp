@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - cut low and high values                                             *
  *                                                                              *
- * modified: 2025-05-25                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -65,7 +65,7 @@ void OpCut::bindPython(void* mod) const
     obj->getImage().log(QString("cut values ouside range: lower=%1 upper=%2").arg(lo).arg(hi));
     return OK;
   },
-  "Cut values outside a given range",py::arg("obj"),py::arg("lo"),py::arg("hi"));
+  "Cut values outside a given range",py::arg("obj"),py::arg("lo"),py::arg("hi"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -84,3 +84,36 @@ OpPlugin::ResultType OpCut::execute(std::shared_ptr<FitsObject> image, const OpP
   }
   return CANCELLED;
 }
+
+bool OpCut::supportsBatch() const
+{
+  return true;
+}
+
+QStringList OpCut::getBatchParameters() const
+{
+  return {"lower  lower limit",
+          "upper  upper limit"};
+}
+
+OpPlugin::ResultType OpCut::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params)
+{
+  if (!params.contains("lower") || !params.contains("upper"))
+  {
+    setError("OpCut: parameters lower and upper are required");
+    return ERROR;
+  }
+  double lower, upper;
+  if (!readBatchParameter(params,"lower",0.0,lower) || !readBatchParameter(params,"upper",0.0,upper)) return ERROR;
+  if (lower > upper)
+  {
+    setError("OpCut: lower limit exceeds the upper limit");
+    return ERROR;
+  }
+  profiler.start();
+  image->getImage().cut(lower,upper);
+  profiler.stop();
+  log(image,QString("cut values ouside range: lower=%1 upper=%2").arg(lower).arg(upper));
+  logProfiler(image);
+  return OK;
+}
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - cut low and high values                                             *
  *                                                                              *
- * modified: 2025-05-25                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -47,6 +47,12 @@ public:
 
   virtual ResultType execute(std::shared_ptr<FitsObject> image, const OpPluginData& data=OpPluginData()) override;
 
+  virtual bool supportsBatch() const override;
+
+  virtual QStringList getBatchParameters() const override;
+
+  virtual ResultType executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params) override;
+
 private:
   TwoValueDialog dlg;
 
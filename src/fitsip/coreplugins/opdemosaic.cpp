@@ -0,0 +1,278 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - demosaic raw color filter array images                              *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "opdemosaic.h"
+#include "opdemosaicdialog.h"
+#include <fitsip/core/fitsimage.h>
+#include <fitsip/core/parallel.h>
+#include <QDebug>
+#include <stdexcept>
+
+#ifdef USE_PYTHON
+#undef SLOT
+#undef slot
+#undef slots
+#include <pybind11/pybind11.h>
+namespace py = pybind11;
+#endif
+
+namespace
+{
+
+/* reflect indices at the border; this keeps the parity and thus the color of
+   the pixel in the CFA pattern */
+inline int mirror(int i, int n)
+{
+  if (i < 0) return -i;
+  if (i >= n) return 2 * (n - 1) - i;
+  return i;
+}
+
+/* cfa holds the colors (0=red, 1=green, 2=blue) of the 2x2 cell row by row */
+void bilinearRow(const ValueType* src, int w, int h, int y, const int* cfa, ValueType* const* dst)
+{
+  const ValueType* m1 = src + static_cast<size_t>(mirror(y-1,h)) * w;
+  const ValueType* r = src + static_cast<size_t>(y) * w;
+  const ValueType* p1 = src + static_cast<size_t>(mirror(y+1,h)) * w;
+  const int* crow = cfa + ((y & 1) << 1);
+  const int* cvert = cfa + (((y + 1) & 1) << 1);
+  size_t offset = static_cast<size_t>(y) * w;
+  ValueType* out[3] = {dst[0]+offset,dst[1]+offset,dst[2]+offset};
+  for (int x=0;x<w;x++)
+  {
+    int xm1 = mirror(x-1,w);
+    int xp1 = mirror(x+1,w);
+    int c = crow[x&1];
+    out[c][x] = r[x];
+    if (c == 1)
+    {
+      out[crow[(x+1)&1]][x] = (r[xm1] + r[xp1]) * ValueType(0.5);
+      out[cvert[x&1]][x] = (m1[x] + p1[x]) * ValueType(0.5);
+    }
+    else
+    {
+      out[1][x] = (r[xm1] + r[xp1] + m1[x] + p1[x]) * ValueType(0.25);
+      out[2-c][x] = (m1[xm1] + m1[xp1] + p1[xm1] + p1[xp1]) * ValueType(0.25);
+    }
+  }
+}
+
+/* gradient corrected linear interpolation after Malvar, He and Cutler */
+void gradientRow(const ValueType* src, int w, int h, int y, const int* cfa, ValueType* const* dst)
+{
+  const ValueType* m2 = src + static_cast<size_t>(mirror(y-2,h)) * w;
+  const ValueType* m1 = src + static_cast<size_t>(mirror(y-1,h)) * w;
+  const ValueType* r = src + static_cast<size_t>(y) * w;
+  const ValueType* p1 = src + static_cast<size_t>(mirror(y+1,h)) * w;
+  const ValueType* p2 = src + static_cast<size_t>(mirror(y+2,h)) * w;
+  const int* crow = cfa + ((y & 1) << 1);
+  const int* cvert = cfa + (((y + 1) & 1) << 1);
+  size_t offset = static_cast<size_t>(y) * w;
+  ValueType* out[3] = {dst[0]+offset,dst[1]+offset,dst[2]+offset};
+  for (int x=0;x<w;x++)
+  {
+    int xm2 = mirror(x-2,w);
+    int xm1 = mirror(x-1,w);
+    int xp1 = mirror(x+1,w);
+    int xp2 = mirror(x+2,w);
+    ValueType center = r[x];
+    ValueType vert = m1[x] + p1[x];
+    ValueType horz = r[xm1] + r[xp1];
+    ValueType vert2 = m2[x] + p2[x];
+    ValueType horz2 = r[xm2] + r[xp2];
+    ValueType diag = m1[xm1] + m1[xp1] + p1[xm1] + p1[xp1];
+    int c = crow[x&1];
+    out[c][x] = center;
+    if (c == 1)
+    {
+      out[crow[(x+1)&1]][x] = (5 * center + 4 * horz - horz2 - diag + ValueType(0.5) * vert2) * ValueType(0.125);
+      out[cvert[x&1]][x] = (5 * center + 4 * vert - vert2 - diag + ValueType(0.5) * horz2) * ValueType(0.125);
+    }
+    else
+    {
+      out[1][x] = (4 * center + 2 * (vert + horz) - (vert2 + horz2)) * ValueType(0.125);
+      out[2-c][x] = (6 * center + 2 * diag - ValueType(1.5) * (vert2 + horz2)) * ValueType(0.125);
+    }
+  }
+}
+
+}
+
+OpDemosaic::OpDemosaic():
+  dlg(nullptr)
+{
+  profiler = SimpleProfiler("OpDemosaic");
+}
+
+OpDemosaic::~OpDemosaic()
+{
+  if (dlg) dlg->deleteLater();
+}
+
+QString OpDemosaic::getMenuEntry() const
+{
+  return "Image/Color/Demosaic...";
+}
+
+#ifdef USE_PYTHON
+void OpDemosaic::bindPython(void* mod) const
+{
+  py::module_* m = reinterpret_cast<py::module_*>(mod);
+  m->def("demosaic",[this](std::shared_ptr<FitsObject> obj, const std::string& cfa, char mode){
+    if (obj->getImage().getDepth() != 1) return ERROR;
+    QString pattern = QString::fromStdString(cfa);
+    if (pattern.isEmpty()) pattern = getPattern(obj->getImage());
+    obj->setImage(demosaic(obj->getImage(),pattern,mode == 'g' ? GRADIENT_CORRECTED : BILINEAR));
+    obj->getImage().log(QString("Demosaic: pattern=%1").arg(pattern));
+    return OK;
+  },
+  "Interpolate a CFA image to an RGB image; mode 'b'=bilinear 'g'=gradient corrected",py::arg("obj"),py::arg("pattern")="",py::arg("mode")='b',py::call_guard<py::gil_scoped_release>());
+}
+#endif
+
+OpPlugin::ResultType OpDemosaic::execute(std::shared_ptr<FitsObject> image, const OpPluginData& /*data*/)
+{
+  if (image->getImage().getDepth() != 1)
+  {
+    setError("Not a single layer CFA image");
+    return ERROR;
+  }
+  if (dlg == nullptr)
+  {
+    dlg = new OpDemosaicDialog();
+  }
+  dlg->setImagePattern(getPattern(image->getImage()));
+  if (dlg->exec())
+  {
+    QString pattern = dlg->getPattern();
+    Method method = dlg->isGradientCorrected() ? GRADIENT_CORRECTED : BILINEAR;
+    profiler.start();
+    try
+    {
+      image->setImage(demosaic(image->getImage(),pattern,method));
+      profiler.stop();
+      log(image,QString("Demosaic: pattern=%1 %2").arg(pattern,method == GRADIENT_CORRECTED ? "gradient corrected" : "bilinear"));
+      logProfiler(image);
+    }
+    catch (const std::exception& ex)
+    {
+      setError(ex.what());
+      qWarning() << ex.what();
+      return ERROR;
+    }
+    return OK;
+  }
+  return CANCELLED;
+}
+
+bool OpDemosaic::supportsBatch() const
+{
+  return true;
+}
+
+QStringList OpDemosaic::getBatchParameters() const
+{
+  return {"pattern  RGGB, BGGR, GRBG or GBRG; default from image header",
+          "method=bilinear  bilinear or gradient"};
+}
+
+OpPlugin::ResultType OpDemosaic::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params)
+{
+  if (image->getImage().getDepth() != 1)
+  {
+    setError("Not a single layer CFA image");
+    return ERROR;
+  }
+  QString pattern = params.value("pattern",getPattern(image->getImage())).toString().toUpper();
+  QString name;
+  if (!readBatchParameter(params,"method","bilinear",{"bilinear","gradient"},name)) return ERROR;
+  Method method = name == "gradient" ? GRADIENT_CORRECTED : BILINEAR;
+  profiler.start();
+  try
+  {
+    image->setImage(demosaic(image->getImage(),pattern,method));
+    profiler.stop();
+    log(image,QString("Demosaic: pattern=%1 %2").arg(pattern,method == GRADIENT_CORRECTED ? "gradient corrected" : "bilinear"));
+    logProfiler(image);
+  }
+  catch (const std::exception& ex)
+  {
+    setError(ex.what());
+    return ERROR;
+  }
+  return OK;
+}
+
+FitsImage OpDemosaic::demosaic(const FitsImage& image, const QString& pattern, Method method) const
+{
+  if (pattern.size() != 4 || pattern.count('R') != 1 || pattern.count('G') != 2 || pattern.count('B') != 1)
+  {
+    throw std::runtime_error("Invalid Bayer pattern: "+pattern.toStdString());
+  }
+  int cfa[4];
+  for (int i=0;i<4;i++)
+  {
+    cfa[i] = pattern[i] == 'R' ? 0 : (pattern[i] == 'G' ? 1 : 2);
+  }
+  int w = image.getWidth();
+  int h = image.getHeight();
+  if (w < 4 || h < 4) throw std::runtime_error("Image too small for demosaicing");
+  FitsImage rgb(image.getName(),w,h,3);
+  std::map<QString,ImageMetadata::Entry> entries = image.getMetadata().getEntries();
+  entries.erase("BAYERPAT");
+  entries.erase("XBAYROFF");
+  entries.erase("YBAYROFF");
+  ImageMetadata meta = image.getMetadata();
+  meta.setEntries(entries);
+  rgb.setMetadata(meta);
+  const ValueType* src = image.getLayer(0).getData();
+  ValueType* dst[3] = {rgb.getLayer(0).getData(),rgb.getLayer(1).getData(),rgb.getLayer(2).getData()};
+  parallel::forRange(h,[&](int y0, int y1){
+    for (int y=y0;y<y1;y++)
+    {
+      if (method == GRADIENT_CORRECTED)
+        gradientRow(src,w,h,y,cfa,dst);
+      else
+        bilinearRow(src,w,h,y,cfa,dst);
+    }
+  },16);
+  return rgb;
+}
+
+QString OpDemosaic::getPattern(const FitsImage& image)
+{
+  QString pattern = image.getMetadata().getValue("BAYERPAT").trimmed().toUpper();
+  pattern.remove('\'');
+  pattern = pattern.trimmed();
+  if (pattern.size() != 4) return "";
+  int xoffset = image.getMetadata().getValue("XBAYROFF").toInt() & 1;
+  int yoffset = image.getMetadata().getValue("YBAYROFF").toInt() & 1;
+  QString shifted = pattern;
+  for (int y=0;y<2;y++)
+  {
+    for (int x=0;x<2;x++)
+    {
+      shifted[y*2+x] = pattern[((y+yoffset)&1)*2+((x+xoffset)&1)];
+    }
+  }
+  return shifted;
+}
@@ -0,0 +1,82 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - demosaic raw color filter array images                              *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef OPDEMOSAIC_H
+#define OPDEMOSAIC_H
+
+#include <fitsip/core/opplugin.h>
+#include <QObject>
+
+class OpDemosaicDialog;
+
+class OpDemosaic: public OpPlugin
+{
+  Q_OBJECT
+  Q_INTERFACES(OpPlugin)
+public:
+
+  enum Method { BILINEAR=0, GRADIENT_CORRECTED };
+
+  OpDemosaic();
+  virtual ~OpDemosaic() override;
+
+  virtual QString getMenuEntry() const override;
+
+#ifdef USE_PYTHON
+  virtual void bindPython(void* m) const override;
+#endif
+
+  virtual ResultType execute(std::shared_ptr<FitsObject> image, const OpPluginData& data=OpPluginData()) override;
+
+  virtual bool supportsBatch() const override;
+
+  virtual QStringList getBatchParameters() const override;
+
+  virtual ResultType executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params) override;
+
+  /**
+   * @brief Interpolate a single layer CFA image to a 3 layer RGB image.
+   *
+   * The pattern lists the colors of the top left 2x2 pixels row by row,
+   * e.g. "RGGB". Rows are processed in parallel.
+   * @param image the CFA image
+   * @param pattern the Bayer pattern
+   * @param method the interpolation method
+   * @return the RGB image
+   */
+  FitsImage demosaic(const FitsImage& image, const QString& pattern, Method method) const;
+
+  /**
+   * @brief Get the Bayer pattern stored in the image metadata.
+   *
+   * The pattern is read from the BAYERPAT keyword and adjusted by the
+   * optional XBAYROFF and YBAYROFF offsets.
+   * @param image the image
+   * @return the pattern or an empty string if the image has none
+   */
+  static QString getPattern(const FitsImage& image);
+
+private:
+  OpDemosaicDialog* dlg;
+};
+
+#endif // OPDEMOSAIC_H
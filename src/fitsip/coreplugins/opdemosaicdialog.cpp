@@ -0,0 +1,61 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - demosaic dialog                                                     *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "opdemosaicdialog.h"
+#include "ui_opdemosaicdialog.h"
+
+OpDemosaicDialog::OpDemosaicDialog(QWidget *parent):QDialog(parent),
+  ui(new Ui::OpDemosaicDialog)
+{
+  ui->setupUi(this);
+}
+
+OpDemosaicDialog::~OpDemosaicDialog()
+{
+  delete ui;
+}
+
+void OpDemosaicDialog::setImagePattern(const QString& pattern)
+{
+  imagePattern = pattern;
+  if (imagePattern.isEmpty())
+  {
+    ui->patternBox->setItemText(0,"From image (not available)");
+    if (ui->patternBox->currentIndex() == 0) ui->patternBox->setCurrentIndex(1);
+  }
+  else
+  {
+    ui->patternBox->setItemText(0,QString("From image (%1)").arg(imagePattern));
+    ui->patternBox->setCurrentIndex(0);
+  }
+}
+
+QString OpDemosaicDialog::getPattern() const
+{
+  if (ui->patternBox->currentIndex() == 0) return imagePattern;
+  return ui->patternBox->currentText();
+}
+
+bool OpDemosaicDialog::isGradientCorrected() const
+{
+  return ui->gradientButton->isChecked();
+}
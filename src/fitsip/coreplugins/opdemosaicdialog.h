@@ -0,0 +1,51 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - demosaic dialog                                                     *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef OPDEMOSAICDIALOG_H
+#define OPDEMOSAICDIALOG_H
+
+#include <QDialog>
+
+namespace Ui {
+class OpDemosaicDialog;
+}
+
+class OpDemosaicDialog : public QDialog
+{
+  Q_OBJECT
+
+public:
+  explicit OpDemosaicDialog(QWidget *parent = nullptr);
+  ~OpDemosaicDialog();
+
+  void setImagePattern(const QString& pattern);
+
+  QString getPattern() const;
+
+  bool isGradientCorrected() const;
+
+private:
+  Ui::OpDemosaicDialog *ui;
+  QString imagePattern;
+};
+
+#endif // OPDEMOSAICDIALOG_H
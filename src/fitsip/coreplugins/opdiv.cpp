@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - divide two images                                                   *
  *                                                                              *
- * modified: 2025-01-31                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -65,7 +65,7 @@ void OpDiv::bindPython(void* mod) const
     obj1->getImage().log("Divided by image "+obj2->getImage().getName());
     return OK;
   },
-  "Divide the first image by the second one",py::arg("obj1"),py::arg("obj2"));
+  "Divide the first image by the second one",py::arg("obj1"),py::arg("obj2"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
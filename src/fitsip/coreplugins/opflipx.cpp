@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - flip image horizontally                                             *
  *                                                                              *
- * modified: 2025-02-05                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -60,7 +60,7 @@ void OpFlipX::bindPython(void* mod) const
     obj->getImage().log("flipped in X");
     return OK;
   },
-  "Flip in x",py::arg("obj"));
+  "Flip in x",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -74,6 +74,16 @@ OpPlugin::ResultType OpFlipX::execute(std::shared_ptr<FitsObject> image, const O
   return OK;
 }
 
+bool OpFlipX::supportsBatch() const
+{
+  return true;
+}
+
+OpPlugin::ResultType OpFlipX::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& /*params*/)
+{
+  return execute(image);
+}
+
 void OpFlipX::flip(FitsImage* img) const
 {
   for (int y=0;y<img->getHeight();y++)
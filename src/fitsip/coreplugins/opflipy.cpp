@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - flip image vertically                                               *
  *                                                                              *
- * modified: 2025-02-05                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -60,7 +60,7 @@ void OpFlipY::bindPython(void* mod) const
     obj->getImage().log("flipped in Y");
     return OK;
   },
-  "Flip in y",py::arg("obj"));
+  "Flip in y",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -74,6 +74,16 @@ OpPlugin::ResultType OpFlipY::execute(std::shared_ptr<FitsObject> image, const O
   return OK;
 }
 
+bool OpFlipY::supportsBatch() const
+{
+  return true;
+}
+
+OpPlugin::ResultType OpFlipY::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& /*params*/)
+{
+  return execute(image);
+}
+
 void OpFlipY::flip(FitsImage* img) const
 {
   for (int y=0;y<img->getHeight()/2;y++)
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - flip image vertically                                               *
  *                                                                              *
- * modified: 2025-02-05                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -45,6 +45,10 @@ public:
 
   virtual ResultType execute(std::shared_ptr<FitsObject> image, const OpPluginData& data=OpPluginData()) override;
 
+  virtual bool supportsBatch() const override;
+
+  virtual ResultType executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params) override;
+
 private:
   void flip(FitsImage* img) const;
 
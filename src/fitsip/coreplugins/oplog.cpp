@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - scale image by logarithm                                            *
  *                                                                              *
- * modified: 2025-02-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -61,7 +61,7 @@ void OpLog::bindPython(void* mod) const
     obj->getImage().log("log10 of image");
     return OK;
   },
-  "Take logarithm of image",py::arg("obj"));
+  "Take logarithm of image",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -75,6 +75,16 @@ OpPlugin::ResultType OpLog::execute(std::shared_ptr<FitsObject> image, const OpP
   return OK;
 }
 
+bool OpLog::supportsBatch() const
+{
+  return true;
+}
+
+OpPlugin::ResultType OpLog::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& /*params*/)
+{
+  return execute(image);
+}
+
 void OpLog::calcLog(FitsImage* img) const
 {
   PixelIterator p = img->getPixelIterator();
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - resize image                                                        *
  *                                                                              *
- * modified: 2025-02-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -62,12 +62,12 @@ void OpResize::bindPython(void* mod) const
     scriptResize(obj,factor,factor,mode);
     return OK;
   },
-  "Resize the image by a given factor",py::arg("obj"),py::arg("factor"),py::arg("mode")='b');
+  "Resize the image by a given factor",py::arg("obj"),py::arg("factor"),py::arg("mode")='b',py::call_guard<py::gil_scoped_release>());
   m->def("resize",[this](std::shared_ptr<FitsObject> obj, double factorx, double factory, char mode){
     scriptResize(obj,factorx,factory,mode);
     return OK;
   },
-  "Resize the image by a given factor",py::arg("obj"),py::arg("factorx"),py::arg("factory"),py::arg("mode")='b');
+  "Resize the image by a given factor",py::arg("obj"),py::arg("factorx"),py::arg("factory"),py::arg("mode")='b',py::call_guard<py::gil_scoped_release>());
 
   //  m->def("shrink",[this](std::shared_ptr<FitsObject> obj, double factor){
 //    auto img = shrink(obj->getImage(),factor,factor);
@@ -133,6 +133,39 @@ OpPlugin::ResultType OpResize::execute(std::shared_ptr<FitsObject> image, const
   return CANCELLED;
 }
 
+bool OpResize::supportsBatch() const
+{
+  return true;
+}
+
+QStringList OpResize::getBatchParameters() const
+{
+  return {"factor=1  resize factor for both directions",
+          "factorx  resize factor in x direction",
+          "factory  resize factor in y direction",
+          "mode=bilinear  none, nearest or bilinear"};
+}
+
+OpPlugin::ResultType OpResize::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params)
+{
+  double factor, factorx, factory;
+  QString mode;
+  if (!readBatchParameter(params,"factor",1.0,factor,0.01,100) ||
+      !readBatchParameter(params,"factorx",factor,factorx,0.01,100) ||
+      !readBatchParameter(params,"factory",factor,factory,0.01,100) ||
+      !readBatchParameter(params,"mode","bilinear",{"none","nearest","bilinear"},mode))
+  {
+    return ERROR;
+  }
+  int m = mode == "nearest" ? 1 : mode == "bilinear" ? 2 : 0;
+  profiler.start();
+  image->setImage(resize(image->getImage(),factorx,factory,m));
+  profiler.stop();
+  log(image,QString("Resize: factor x=%1 y=%2 %3").arg(factorx).arg(factory).arg(m == 1 ? "nearest neighbor" : m == 2 ? "bilinear" : "no scaling"));
+  logProfiler(image);
+  return OK;
+}
+
 FitsImage OpResize::resize(const FitsImage& image, double factorx, double factory, int mode) const
 {
   if (mode == 0)
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - resize image                                                        *
  *                                                                              *
- * modified: 2023-02-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -43,6 +43,12 @@ public:
 
   virtual ResultType execute(std::shared_ptr<FitsObject> image, const OpPluginData& data=OpPluginData()) override;
 
+  virtual bool supportsBatch() const override;
+
+  virtual QStringList getBatchParameters() const override;
+
+  virtual ResultType executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params) override;
+
 #ifdef USE_PYTHON
   virtual void bindPython(void* m) const override;
 #endif
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - rotate images                                                       *
  *                                                                              *
- * modified: 2025-02-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -65,19 +65,19 @@ void OpRotate::bindPython(void* mod) const
     obj->getImage().log("OpRotate: 90deg cw");
     return OK;
   },
-  "Rotate image 90° clock wise",py::arg("obj"));
+  "Rotate image 90° clock wise",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
   m->def("rotate90ccw",[this](std::shared_ptr<FitsObject> obj){
     rotate90ccw(&obj->getImage());
     obj->getImage().log("OpRotate: 90deg ccw");
     return OK;
   },
-  "Rotate image 90° counter clock wise",py::arg("obj"));
+  "Rotate image 90° counter clock wise",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
   m->def("rotate",[this](std::shared_ptr<FitsObject> obj, double angle, bool crop){
     rotate(&obj->getImage(),angle,crop);
-    obj->getImage().log(QString("OpRotate: %1deg").arg(static_cast<ValueType>(dlg->getAngle())));
+    obj->getImage().log(QString("OpRotate: %1deg").arg(angle));
     return OK;
   },
-  "Rotate image",py::arg("obj"),py::arg("angle"),py::arg("crop"));
+  "Rotate image",py::arg("obj"),py::arg("angle"),py::arg("crop"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -114,6 +114,44 @@ OpPlugin::ResultType OpRotate::execute(std::shared_ptr<FitsObject> image, const
   return CANCELLED;
 }
 
+bool OpRotate::supportsBatch() const
+{
+  return true;
+}
+
+QStringList OpRotate::getBatchParameters() const
+{
+  return {"angle=0  rotation angle in degree, or cw / ccw for 90 degree steps"};
+}
+
+OpPlugin::ResultType OpRotate::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params)
+{
+  QString angle = params.value("angle","0").toString();
+  double a = 0;
+  if (angle != "cw" && angle != "ccw" && !readBatchParameter(params,"angle",0.0,a,-360,360)) return ERROR;
+  profiler.start();
+  if (angle == "cw")
+  {
+    rotate90cw(&image->getImage());
+    profiler.stop();
+    log(image,"OpRotate: 90deg cw");
+  }
+  else if (angle == "ccw")
+  {
+    rotate90ccw(&image->getImage());
+    profiler.stop();
+    log(image,"OpRotate: 90deg ccw");
+  }
+  else
+  {
+    rotate(&image->getImage(),a,false);
+    profiler.stop();
+    log(image,QString("OpRotate: %1deg").arg(a));
+  }
+  logProfiler(image);
+  return OK;
+}
+
 void OpRotate::rotate90cw(FitsImage* image) const
 {
   FitsImage img(image->getName(),image->getHeight(),image->getWidth(),image->getDepth());
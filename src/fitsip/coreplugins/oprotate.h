@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - rotate images                                                       *
  *                                                                              *
- * modified: 2025-02-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -48,6 +48,12 @@ public:
 
   virtual ResultType execute(std::shared_ptr<FitsObject> image, const OpPluginData& data=OpPluginData()) override;
 
+  virtual bool supportsBatch() const override;
+
+  virtual QStringList getBatchParameters() const override;
+
+  virtual ResultType executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params) override;
+
   void rotate90cw(FitsImage* image) const;
 
   void rotate90ccw(FitsImage* image) const;
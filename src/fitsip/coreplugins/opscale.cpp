@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - linear scaling of image intensity                                   *
  *                                                                              *
- * modified: 2023-01-31                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -59,7 +59,7 @@ void OpScale::bindPython(void* mod) const
     obj->getImage().log(QString("scaled image: scale=%1 bias=%2").arg(scale).arg(bias));
     return OK;
   },
-  "Scale an image",py::arg("obj"),py::arg("scale"),py::arg("bias"));
+  "Scale an image",py::arg("obj"),py::arg("scale"),py::arg("bias"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -79,6 +79,29 @@ OpPlugin::ResultType OpScale::execute(std::shared_ptr<FitsObject> image, const O
   return CANCELLED;
 }
 
+bool OpScale::supportsBatch() const
+{
+  return true;
+}
+
+QStringList OpScale::getBatchParameters() const
+{
+  return {"scale=1  scale factor",
+          "bias=0  value added after scaling"};
+}
+
+OpPlugin::ResultType OpScale::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params)
+{
+  double bias, scale;
+  if (!readBatchParameter(params,"bias",0.0,bias) || !readBatchParameter(params,"scale",1.0,scale)) return ERROR;
+  profiler.start();
+  scaleImage(&image->getImage(),scale,bias);
+  profiler.stop();
+  log(image,QString("scaled image: scale=%1 bias=%2").arg(scale).arg(bias));
+  logProfiler(image);
+  return OK;
+}
+
 void OpScale::scaleImage(FitsImage* img, ValueType scale, ValueType bias) const
 {
   int n = img->getWidth() * img->getHeight();
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - linear scaling of image intensity                                   *
  *                                                                              *
- * modified: 2025-01-31                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -45,6 +45,12 @@ public:
 
   virtual ResultType execute(std::shared_ptr<FitsObject> image, const OpPluginData& data=OpPluginData()) override;
 
+  virtual bool supportsBatch() const override;
+
+  virtual QStringList getBatchParameters() const override;
+
+  virtual ResultType executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params) override;
+
 private:
   void scaleImage(FitsImage* img, ValueType scale, ValueType bias) const;
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - shift image with subpixel accuracy                                  *
  *                                                                              *
- * modified: 2025-02-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -64,7 +64,7 @@ void OpShift::bindPython(void* mod) const
     obj->getImage().log(QString("OpShift: dx=%1  dy=%2").arg(dx).arg(dy));
     return OK;
   },
-  "Shift image",py::arg("obj"),py::arg("dx"),py::arg("dy"));
+  "Shift image",py::arg("obj"),py::arg("dx"),py::arg("dy"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -86,6 +86,29 @@ OpPlugin::ResultType OpShift::execute(std::shared_ptr<FitsObject> image, const O
   return CANCELLED;
 }
 
+bool OpShift::supportsBatch() const
+{
+  return true;
+}
+
+QStringList OpShift::getBatchParameters() const
+{
+  return {"dx=0  shift in x direction",
+          "dy=0  shift in y direction"};
+}
+
+OpPlugin::ResultType OpShift::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& params)
+{
+  double dx, dy;
+  if (!readBatchParameter(params,"dx",0.0,dx) || !readBatchParameter(params,"dy",0.0,dy)) return ERROR;
+  profiler.start();
+  shift(&image->getImage(),dx,dy);
+  profiler.stop();
+  log(image,QString("OpShift: dx=%1  dy=%2").arg(dx).arg(dy));
+  logProfiler(image);
+  return OK;
+}
+
 void OpShift::shift(FitsImage* image, ValueType dx, ValueType dy) const
 {
   FitsImage img(*image);
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - split channels of a multilayer image                                *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -75,7 +75,7 @@ void OpSplitChannels::bindPython(void* mod) const
     return list;
 //    return std::make_tuple(list[0],list[1],list[2]);
   },
-  "Shift image",py::arg("obj"));
+  "Shift image",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
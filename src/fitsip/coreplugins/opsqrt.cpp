@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - scale image intensity by square root                                *
  *                                                                              *
- * modified: 2025-02-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -62,7 +62,7 @@ void OpSqrt::bindPython(void* mod) const
     obj->getImage().log("Square Root of image");
     return OK;
   },
-  "Take square root of image",py::arg("obj"));
+  "Take square root of image",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -76,6 +76,16 @@ OpPlugin::ResultType OpSqrt::execute(std::shared_ptr<FitsObject> image, const Op
   return OK;
 }
 
+bool OpSqrt::supportsBatch() const
+{
+  return true;
+}
+
+OpPlugin::ResultType OpSqrt::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& /*params*/)
+{
+  return execute(image);
+}
+
 void OpSqrt::calcSqrt(FitsImage* img) const
 {
   PixelIterator p = img->getPixelIterator();
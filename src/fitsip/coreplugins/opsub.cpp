@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - subtract to images                                                  *
  *                                                                              *
- * modified: 2025-01-31                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -65,7 +65,7 @@ void OpSub::bindPython(void* mod) const
     obj1->getImage().log("Subtracted image "+obj2->getImage().getName());
     return OK;
   },
-  "Subtract the second image from the first",py::arg("obj1"),py::arg("obj2"));
+  "Subtract the second image from the first",py::arg("obj1"),py::arg("obj2"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
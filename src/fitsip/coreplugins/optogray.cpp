@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - convert image to gray scale image                                   *
  *                                                                              *
- * modified: 2025-02-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -58,7 +58,7 @@ void OpToGray::bindPython(void* mod) const
     obj->getImage().log("Converted to gray image");
     return OK;
   },
-  "Convert image to gray",py::arg("obj"));
+  "Convert image to gray",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -77,6 +77,16 @@ OpPlugin::ResultType OpToGray::execute(std::shared_ptr<FitsObject> image, const
   return OK;
 }
 
+bool OpToGray::supportsBatch() const
+{
+  return true;
+}
+
+OpPlugin::ResultType OpToGray::executeBatch(std::shared_ptr<FitsObject> image, const QVariantMap& /*params*/)
+{
+  return execute(image);
+}
+
 std::shared_ptr<FitsObject>  OpToGray::toGray(std::shared_ptr<FitsObject> image) const
 {
   return std::make_shared<FitsObject>(image->getImage().toGray());
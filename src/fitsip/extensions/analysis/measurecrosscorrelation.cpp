@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - perform cross carrelation                                           *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -23,7 +23,9 @@
 #include "measurecrosscorrelation.h"
 #include <fitsip/core/imagecollection.h>
 #include <fitsip/core/fitsobject.h>
+#include <fitsip/core/parallel.h>
 #include <fftw3.h>
+#include <QMutexLocker>
 
 #ifdef USE_PYTHON
 #undef SLOT
@@ -61,7 +63,7 @@ void MeasureCrossCorrelation::bindPython(void* mod) const
     return correlate(obj1,obj2);
     obj1->getImage().log("Cross correlation between: "+obj1->getImage().getName()+" and "+obj2->getImage().getName());
   },
-  "Cross correlation between to images",py::arg("obj1"),py::arg("obj2"));
+  "Cross correlation between to images",py::arg("obj1"),py::arg("obj2"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -98,8 +100,13 @@ std::shared_ptr<FitsObject> MeasureCrossCorrelation::correlate(std::shared_ptr<F
   auto img2 = i2.subImage(r1);
   fftw_complex *s2c = new fftw_complex[img1.getHeight()*(img1.getWidth()/2+1)];
   double *in = new double[img1.getHeight()*img1.getWidth()];
-  fftw_plan f = fftw_plan_dft_r2c_2d(img1.getHeight(),img1.getWidth(),in,s2c,FFTW_ESTIMATE);
-  fftw_plan b = fftw_plan_dft_c2r_2d(img1.getHeight(),img1.getWidth(),s2c,in,FFTW_ESTIMATE);
+  fftw_plan f;
+  fftw_plan b;
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    f = fftw_plan_dft_r2c_2d(img1.getHeight(),img1.getWidth(),in,s2c,FFTW_ESTIMATE);
+    b = fftw_plan_dft_c2r_2d(img1.getHeight(),img1.getWidth(),s2c,in,FFTW_ESTIMATE);
+  }
   ConstPixelIterator it = img1.getConstPixelIterator();
   double* ptr = in;
   for (int i=0;i<img1.getHeight()*img1.getWidth();i++)
@@ -143,8 +150,11 @@ std::shared_ptr<FitsObject> MeasureCrossCorrelation::correlate(std::shared_ptr<F
     ++rptr;
     ++it2;
   }
-  fftw_destroy_plan(b);
-  fftw_destroy_plan(f);
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    fftw_destroy_plan(b);
+    fftw_destroy_plan(f);
+  }
   delete [] s2c;
   delete [] c1;
   delete [] sin;
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - measure the sharpness of images                                     *
  *                                                                              *
- * modified: 2025-10-24                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -27,7 +27,7 @@
 #include <fitsip/core/fitsimage.h>
 #include <fitsip/core/imagestatistics.h>
 #include <fitsip/core/dialogs/progressdialog.h>
-#include <fitsip/core/io/iofactory.h>
+#include <fitsip/core/io/framesequence.h>
 #include <fitsip/core/math/average.h>
 #include <algorithm>
 #include <QApplication>
@@ -80,36 +80,41 @@ void MeasureSharpness::bindPython(void* mod) const
   m->def("calc_sharpness",[this](std::shared_ptr<FitsObject> obj){
         return calculateSharpness(obj->getImage());
       },
-      "Calculate sharpness",py::arg("obj"));
+      "Calculate sharpness",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
   m->def("calc_sharpness",[this](std::shared_ptr<FitsObject> obj, int x, int y, int w, int h){
         return calculateSharpness(obj->getImage(),QRect(x,y,w,h));
       },
-      "Calculate sharpness",py::arg("obj"),py::arg("x"),py::arg("y"),py::arg("w"),py::arg("h"));
+      "Calculate sharpness",py::arg("obj"),py::arg("x"),py::arg("y"),py::arg("w"),py::arg("h"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
 OpPlugin::ResultType MeasureSharpness::execute(const std::vector<QFileInfo>& list, const OpPluginData& data)
 {
-  if (list.empty()) return CANCELLED;
-  ProgressDialog* prog = list.size() > 2 ? new ProgressDialog() : nullptr;
+  FrameSequence frames(list);
+  if (!frames.getErrors().isEmpty())
+  {
+    setError("MeasureSharpness: "+frames.getErrors().join("\n"));
+    return ERROR;
+  }
+  if (frames.empty()) return CANCELLED;
+  ProgressDialog* prog = frames.size() > 2 ? new ProgressDialog() : nullptr;
   if (prog)
   {
-    prog->setMaximum(list.size());
+    prog->setMaximum(frames.size());
     prog->show();
   }
   results.clear();
   Average normvaravg;
-  int n = 0;
-  for (const QFileInfo& info : list)
+  for (size_t i=0;i<frames.size();++i)
   {
     if (prog)
     {
-      prog->setProgress(n++);
-      prog->appendMessage(info.fileName());
+      prog->setProgress(i);
+      prog->appendMessage(frames.getName(i));
       QApplication::processEvents();
       if (prog->isCancelled()) break;
     }
-    SharpnessData entry = evaluate(info,data.aoi);
+    SharpnessData entry = evaluate(frames,i,data.aoi);
     if (entry.info.exists())
     {
       results.push_back(entry);
@@ -167,16 +172,14 @@ OpPlugin::ResultType MeasureSharpness::execute(const std::vector<std::shared_ptr
 
 
 
-SharpnessData MeasureSharpness::evaluate(const QFileInfo info, QRect selection) const
+SharpnessData MeasureSharpness::evaluate(const FrameSequence& frames, size_t index, QRect selection) const
 {
-  IOHandler* handler = IOFactory::getInstance()->getHandler(info.absoluteFilePath());
-  if (!handler) return SharpnessData();
   try
   {
-    auto img = handler->read(info.absoluteFilePath()).front()->getImage();
-    SharpnessData data = calculateSharpness(img,selection);
-    data.info = info;
-    data.filename = info.absoluteFilePath().toStdString();
+    SharpnessData data = calculateSharpness(frames.getImage(index),selection);
+    data.info = frames.getFileInfo(index);
+    data.filename = data.info.absoluteFilePath().toStdString();
+    data.frame = frames.getFrameIndex(index);
     return data;
   }
   catch (std::exception& ex)
@@ -234,7 +237,9 @@ void MeasureSharpness::copyToLog()
   QString s = "";
   for (const SharpnessData& entry : results)
   {
-    s += entry.info.fileName() + ": " + QString::number(entry.variance) + "\n";
+    s += entry.info.fileName();
+    if (entry.frame >= 0) s += QString(" [%1]").arg(entry.frame);
+    s += ": " + QString::number(entry.variance) + "\n";
   }
   log(nullptr,s);
 }
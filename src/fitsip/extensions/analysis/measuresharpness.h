@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - measure the sharpness of images                                     *
  *                                                                              *
- * modified: 2025-02-21                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -28,12 +28,14 @@
 #include <QObject>
 #include <vector>
 
+class FrameSequence;
 class MeasureSharpnessResultDialog;
 
 struct SharpnessData
 {
   QFileInfo info;
   std::string filename;
+  int frame = -1;           //!< frame index for videos, -1 for images
   double min = 0;
   double max = 0;
   double mean = 0;
@@ -70,7 +72,7 @@ public:
   virtual ResultType execute(const std::vector<std::shared_ptr<FitsObject>>& list, const OpPluginData& data=OpPluginData()) override;
 
 private:
-  SharpnessData evaluate(const QFileInfo info, QRect selection) const;
+  SharpnessData evaluate(const FrameSequence& frames, size_t index, QRect selection) const;
   SharpnessData calculateSharpness(const FitsImage& img, QRect selection=QRect()) const;
   void copyToLog();
 
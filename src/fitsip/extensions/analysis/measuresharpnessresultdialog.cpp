@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - measure the sharpness of images - result dialog                     *
  *                                                                              *
- * modified: 2025-02-12                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -27,6 +27,7 @@
 #include <fitsip/core/io/iofactory.h>
 #include <fitsip/core/math/average.h>
 #include <QTextStream>
+#include <algorithm>
 
 MeasureSharpnessResultDialog::MeasureSharpnessResultDialog(QWidget *parent):QDialog(parent),
     ui(new Ui::MeasureSharpnessResultDialog)
@@ -49,7 +50,9 @@ void MeasureSharpnessResultDialog::setResult(const std::vector<SharpnessData> &l
   int32_t row = 0;
   for (const SharpnessData& entry : entries)
   {
-    ui->resultTable->setItem(row,0,new QTableWidgetItem(entry.info.fileName()));
+    QString name = entry.info.fileName();
+    if (entry.frame >= 0) name += QString(" [%1]").arg(entry.frame);
+    ui->resultTable->setItem(row,0,new QTableWidgetItem(name));
     ui->resultTable->setItem(row,1,new QTableWidgetItem(QString::number(entry.min)));
     ui->resultTable->setItem(row,2,new QTableWidgetItem(QString::number(entry.max)));
     ui->resultTable->setItem(row,3,new QTableWidgetItem(QString::number(entry.mean)));
@@ -70,6 +73,8 @@ std::vector<QFileInfo> MeasureSharpnessResultDialog::getFileList() const
   filelist.clear();
   for (const SharpnessData& e : entries)
   {
+    /* the frames of a video are listed as the video file once */
+    if (e.frame >= 0 && std::any_of(filelist.begin(),filelist.end(),[&e](const QFileInfo& info){return info == e.info;})) continue;
     filelist.push_back(e.info);
   }
   return filelist;
@@ -105,16 +110,16 @@ void MeasureSharpnessResultDialog::on_saveButton_clicked()
       QTextStream s(&file);
       if (filter == IOFactory::filelist_filter)
       {
-        for (const SharpnessData& entry : entries)
+        for (const QFileInfo& info : getFileList())
         {
-          s << entry.info.absoluteFilePath() << Qt::endl;
+          s << info.absoluteFilePath() << Qt::endl;
         }
       }
       else
       {
         for (const SharpnessData& entry : entries)
         {
-          s << entry.info.absoluteFilePath() << "," << entry.min << "," << entry.max << "," << entry.mean << "," << entry.variance << "," << entry.minPixel << "," << entry.maxPixel << "," << entry.normalizedVariance << Qt::endl;
+          s << entry.info.absoluteFilePath() << "," << entry.min << "," << entry.max << "," << entry.mean << "," << entry.variance << "," << entry.minPixel << "," << entry.maxPixel << "," << entry.normalizedVariance << "," << entry.frame << Qt::endl;
         }
       }
       s.flush();
@@ -9,9 +9,11 @@
 #include <fitsip/core/io/iofactory.h>
 #include <fitsip/core/math/average.h>
 #include <fitsip/core/math/window/hanningwindow.h>
+#include <fitsip/core/parallel.h>
 #include <algorithm>
 #include <cmath>
 #include <QApplication>
+#include <QMutexLocker>
 
 #ifdef USE_PYTHON
 #undef SLOT
@@ -79,7 +81,7 @@ void S3Sharpness::bindPython(void* mod) const
       return std::make_tuple(result.s3,result.images[0],result.images[1],result.images[2]);
     }
   },
-  "Calculate sharpness",py::arg("obj"));
+  "Calculate sharpness",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -258,7 +260,11 @@ std::pair<Layer*,std::vector<XYData>>  S3Sharpness::calculateSpectralSharpness(c
   std::vector<XYData> data;
   fftw_complex *s2c = new fftw_complex[m*(m/2+1)];
   double *in = new double[m*m];
-  fftw_plan f = fftw_plan_dft_r2c_2d(m,m,in,s2c,FFTW_ESTIMATE);
+  fftw_plan f;
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    f = fftw_plan_dft_r2c_2d(m,m,in,s2c,FFTW_ESTIMATE);
+  }
   int y = 0;
   auto cl = calculateContrast(layer,m,t1,t2);
   HanningWindow w(m);
@@ -308,7 +314,10 @@ std::pair<Layer*,std::vector<XYData>>  S3Sharpness::calculateSpectralSharpness(c
     }
     y += m - o;
   }
-  fftw_destroy_plan(f);
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    fftw_destroy_plan(f);
+  }
   delete [] s2c;
   delete [] in;
   return std::make_pair(sl,data);
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - synthesize background from image                                    *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -57,6 +57,23 @@ OpPlugin::ResultType SynthesizeBackground::execute(std::shared_ptr<FitsObject> i
   if (dlg->exec())
   {
     profiler.start();
+    if (dlg->getSelectionMode() == 2)
+    {
+      /* interpolated mesh of local background levels instead of a polynomial */
+      try
+      {
+        img = FitsImage("Background",image->getBackgroundMap()->getBackground());
+      }
+      catch (const std::exception& ex)
+      {
+        setError(ex.what());
+        return ERROR;
+      }
+      profiler.stop();
+      log(&img,"Synthesized Background (mesh)");
+      logProfiler(img);
+      return OK;
+    }
     std::vector<Pixel> list;
     double bkg = dlg->getBackground();
     uint32_t n = dlg->getPointsCount();
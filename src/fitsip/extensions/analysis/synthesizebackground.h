@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - synthesize background from image                                    *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -37,7 +37,9 @@ class SynthesizeBackgroundDialog;
  * Synthesize the sky background as a polynomial of arbitrary order, though
  * order 2 is usually good. The algorithm is based on the algorithm and Pascal
  * code by Philippe Martinole. The synthesized sky background is stored in
- * a new ImageBuffer.
+ * a new ImageBuffer. Alternatively the interpolated mesh of local background
+ * levels (see BackgroundMap) is used, which also follows gradients that are
+ * not described by a low order polynomial.
  *
  * @author hbr
  *
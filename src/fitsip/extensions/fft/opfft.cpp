@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - calculate the FFT of an image                                       *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -22,7 +22,9 @@
 
 #include "opfft.h"
 #include <fitsip/core/fitsimage.h>
+#include <fitsip/core/parallel.h>
 #include <fftw3.h>
+#include <QMutexLocker>
 
 /**
  * @note: FFTW requires arrays in row-major (or C) format with the last
@@ -72,7 +74,7 @@ void OpFFT::bindPython(void* mod) const
     auto img = fft(tmp);
     return std::make_shared<FitsObject>(img);
   },
-  "Calculate FFT of the image",py::arg("obj"));
+  "Calculate FFT of the image",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -98,7 +100,11 @@ FitsImage OpFFT::fft(const FitsImage& image) const
 {
   fftw_complex *s2c = new fftw_complex[image.getHeight()*(image.getWidth()/2+1)];
   double *in = new double[image.getHeight()*image.getWidth()];
-  fftw_plan f = fftw_plan_dft_r2c_2d(image.getHeight(),image.getWidth(),in,s2c,FFTW_ESTIMATE);
+  fftw_plan f;
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    f = fftw_plan_dft_r2c_2d(image.getHeight(),image.getWidth(),in,s2c,FFTW_ESTIMATE);
+  }
   ConstPixelIterator it = image.getConstPixelIterator();
   double* ptr = in;
   for (int i=0;i<image.getHeight()*image.getWidth();i++)
@@ -175,7 +181,10 @@ FitsImage OpFFT::fft(const FitsImage& image) const
     ++it2;
   }
 #endif
-  fftw_destroy_plan(f);
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    fftw_destroy_plan(f);
+  }
   delete [] s2c;
   delete [] in;
   return fftimg;
@@ -1,7 +1,9 @@
 #include "opfftconvolution.h"
 #include "opfftconvolutiondialog.h"
+#include <fitsip/core/parallel.h>
 #include <fitsip/core/psf/psffactory.h>
 #include <fftw3.h>
+#include <QMutexLocker>
 
 #ifdef USE_PYTHON
 #undef SLOT
@@ -95,8 +97,11 @@ FitsImage OpFFTConvolution::fftconvolution(const FitsImage& img, const PSF* psf,
   auto h = psf->createPSF(w0,h0,par);
   data.cinout = new fftw_complex[data.fftsize];
   data.rinout = new double[h0*w0];
-  data.r2c = fftw_plan_dft_r2c_2d(h0,w0,data.rinout,data.cinout,FFTW_ESTIMATE);
-  data.c2r = fftw_plan_dft_c2r_2d(h0,w0,data.cinout,data.rinout,FFTW_ESTIMATE);
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    data.r2c = fftw_plan_dft_r2c_2d(h0,w0,data.rinout,data.cinout,FFTW_ESTIMATE);
+    data.c2r = fftw_plan_dft_c2r_2d(h0,w0,data.cinout,data.rinout,FFTW_ESTIMATE);
+  }
   fft(data,h,0);
   fftw_complex* hfft = new fftw_complex[data.fftsize];
   memcpy(hfft,data.cinout,data.fftsize*sizeof(fftw_complex));
@@ -127,8 +132,11 @@ FitsImage OpFFTConvolution::fftconvolution(const FitsImage& img, const PSF* psf,
     delete [] offt2;
     delete [] offt3;
   }
-  fftw_destroy_plan(data.r2c);
-  fftw_destroy_plan(data.c2r);
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    fftw_destroy_plan(data.r2c);
+    fftw_destroy_plan(data.c2r);
+  }
   delete [] data.rinout;
   delete [] data.cinout;
   delete [] hfft;
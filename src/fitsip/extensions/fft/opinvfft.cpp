@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - calculate the inverse FFT                                           *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -22,7 +22,9 @@
 
 #include "opinvfft.h"
 #include <fitsip/core/fitsimage.h>
+#include <fitsip/core/parallel.h>
 #include <fftw3.h>
+#include <QMutexLocker>
 
 #ifdef USE_PYTHON
 #undef SLOT
@@ -67,7 +69,7 @@ void OpInvFFT::bindPython(void* mod) const
     auto img = invfft(obj->getImage());
     return std::make_shared<FitsObject>(img);
   },
-  "Calculate inverse FFT of the image",py::arg("obj"));
+  "Calculate inverse FFT of the image",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -100,7 +102,11 @@ FitsImage OpInvFFT::invfft(const FitsImage& image) const
   int preFFTHeight = image.getHeight();
   fftw_complex* in = new fftw_complex[image.getHeight()*image.getWidth()];
   double *out = new double[preFFTHeight*preFFTWidth];
-  fftw_plan f = fftw_plan_dft_c2r_2d(preFFTHeight,preFFTWidth,in,out,FFTW_ESTIMATE);
+  fftw_plan f;
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    f = fftw_plan_dft_c2r_2d(preFFTHeight,preFFTWidth,in,out,FFTW_ESTIMATE);
+  }
   ConstPixelIterator it = image.getConstPixelIterator();
   fftw_complex* cptr = in;
   for (int i=0;i<image.getHeight()*image.getWidth();i++)
@@ -120,7 +126,10 @@ FitsImage OpInvFFT::invfft(const FitsImage& image) const
     ++ptr;
     ++it2;
   }
-  fftw_destroy_plan(f);
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    fftw_destroy_plan(f);
+  }
   delete [] out;
   delete [] in;
   fftimg /= fftimg.getHeight() * fftimg.getWidth();
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - digital development processing                                      *
  *                                                                              *
- * modified: 2025-03-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -58,7 +58,7 @@ void OpDDP::bindPython(void* mod) const
     obj->getImage().log(QString::asprintf("DDP: sigma=%f  bkg=%f  a=%f  b=%f",sigma,bkg,a,b));
     return OK;
   },
-  "DDP processing",py::arg("obj"),py::arg("sigma"),py::arg("bkg"),py::arg("a"),py::arg("b"));
+  "DDP processing",py::arg("obj"),py::arg("sigma"),py::arg("bkg"),py::arg("a"),py::arg("b"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - gaussian blur                                                       *
  *                                                                              *
- * modified: 2025-02-07                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -61,7 +61,7 @@ void OpGaussBlur::bindPython(void* mod) const
     obj->getImage().log(QString::asprintf("Gaussian blur: sigmax=%f  sigmay=%f  accuracy=%f",sigmax,sigmay,accuracy));
     return OK;
   },
-  "Blur an image by a gaussian",py::arg("obj"),py::arg("sigmax"),py::arg("sigmay"),py::arg("accuracy"));
+  "Blur an image by a gaussian",py::arg("obj"),py::arg("sigmax"),py::arg("sigmay"),py::arg("accuracy"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
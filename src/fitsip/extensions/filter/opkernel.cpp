@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - kernel filter                                                       *
  *                                                                              *
- * modified: 2025-03-18                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -59,7 +59,7 @@ void OpKernel::bindPython(void* mod) const
     obj->getImage().log("Convolution with kernel "+kernel.getName());
     return OK;
   },
-  "Convolution with kernel",py::arg("obj"),py::arg("kernel"));
+  "Convolution with kernel",py::arg("obj"),py::arg("kernel"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - median filter                                                       *
  *                                                                              *
- * modified: 2025-02-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -23,7 +23,10 @@
 #include "opmedian.h"
 #include "opmediandialog.h"
 #include <fitsip/core/fitsimage.h>
+#include <fitsip/core/parallel.h>
 #include <algorithm>
+#include <cmath>
+#include <limits>
 #include <QApplication>
 
 #ifdef USE_PYTHON
@@ -58,7 +61,7 @@ void OpMedian::bindPython(void* mod) const
     obj->getImage().log(QString::asprintf("Median filter: size=%d threshold=%f",size,threshold));
     return OK;
   },
-  "Apply median filter",py::arg("obj"),py::arg("size"),py::arg("threshold"));
+  "Apply median filter",py::arg("obj"),py::arg("size"),py::arg("threshold"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -82,46 +85,102 @@ OpPlugin::ResultType OpMedian::execute(std::shared_ptr<FitsObject> image, const
   return CANCELLED;
 }
 
+/*
+ * NaN is sorted as infinity, so the order is total and every value can be
+ * found again in the window.
+ */
+static inline ValueType value(ValueType v)
+{
+  return std::isnan(v) ? std::numeric_limits<ValueType>::infinity() : v;
+}
+
 void OpMedian::filter(FitsImage* image, ValueType threshold, int size) const
 {
-  FitsImage tmp(*image);
-//  PixelIterator it1 = img.getPixelIterator();
+  int w = image->getWidth();
+  int h = image->getHeight();
   int s2 = size / 2;
-//  it1 += hk2 * img.getWidth();
-  for (int y0=s2;y0<image->getHeight()-s2;y0++)
+  if (size < 2 || w < size || h < size) return;
+  FitsImage tmp(*image);
+  size_t n = static_cast<size_t>(size) * size;
+  for (int d=0;d<image->getDepth();d++)
   {
-//    it1 += wk2;
-    for (int x0=s2;x0<image->getWidth()-s2;x0++)
-    {
-      std::vector<ValueType> neighbors[image->getDepth()];
-      int y = y0 - s2;
-      for (int32_t rk=0;rk<size;rk++)
+    const ValueType* src = tmp.getLayer(d).getData();
+    ValueType* dst = image->getLayer(d).getData();
+    /* The rows are independent. Along a row the window is kept sorted:
+       moving one pixel to the right, the sorted leaving column is removed
+       and the sorted entering column merged in a single pass, so the cost
+       per pixel is linear in the window size. */
+    parallel::forRange(h-2*s2,[=](int r0, int r1){
+      std::vector<ValueType> window(n);
+      std::vector<ValueType> next(n);
+      /* sorted columns of the window, column x in slot x%size, each followed by a NaN */
+      std::vector<ValueType> columns((size+1)*size,std::numeric_limits<ValueType>::quiet_NaN());
+      std::vector<ValueType> entering(size+1,std::numeric_limits<ValueType>::quiet_NaN());
+      for (int r=r0;r<r1;++r)
       {
-        ConstPixelIterator it2 = tmp.getConstPixelIterator(x0-s2,y);
-        for (int32_t ck=0;ck<size;ck++)
+        int y0 = r + s2;
+        const ValueType* top = src + static_cast<size_t>(y0-s2) * w;
+        for (int x=0;x<size;++x)
         {
-          for (int d=0;d<image->getDepth();d++)
+          sortedColumn(top+x,w,size,&columns[x*(size+1)]);
+          std::copy_n(&columns[x*(size+1)],size,&window[x*size]);
+        }
+        std::sort(window.begin(),window.end());
+        for (int x0=s2;x0<w-s2;x0++)
+        {
+          if (x0 > s2)
           {
-            neighbors[d].push_back(it2[d]);
+            ValueType* leaving = &columns[((x0-s2-1)%size)*(size+1)];
+            sortedColumn(top+x0-s2+size-1,w,size,entering.data());
+            slide(window.data(),n,leaving,entering.data(),size,next.data());
+            std::swap(window,next);
+            std::copy_n(entering.begin(),size,leaving);
           }
-          ++it2;
+          ValueType median = window[n/2];
+          ValueType sigma = (window[3*n/4] - window[n/4]) / 2;
+          ValueType& v = dst[static_cast<size_t>(y0)*w+x0];
+          if (v > median + threshold*sigma || v < median - threshold*sigma) v = median;
         }
-        y++;
       }
-      PixelIterator it1 = image->getPixelIterator(x0,y0);
-      for (int d=0;d<image->getDepth();d++)
-      {
-        std::sort(neighbors[d].begin(),neighbors[d].end());
-        ValueType sigma = (3*neighbors[d][neighbors->size()/4] - neighbors[d][neighbors->size()/4]) / 2;
-        if (it1[d] > neighbors[d][neighbors->size()/2] + threshold*sigma)
-          it1[d] = neighbors[d][neighbors->size()/2];
-        if (it1[d] < neighbors[d][neighbors->size()/2] - threshold*sigma)
-          it1[d] = neighbors[d][neighbors->size()/2];
-      }
-//      ++it1;
-    }
-//    it1 += wk2;
+    },4);
   }
 }
 
+/*
+ * Sorted values of a column of the window.
+ */
+void OpMedian::sortedColumn(const ValueType* data, int width, int size, ValueType* column)
+{
+  for (int i=0;i<size;++i)
+  {
+    ValueType v = value(data[static_cast<size_t>(i)*width]);
+    int j = i;
+    for (;j>0 && column[j-1]>v;--j) column[j] = column[j-1];
+    column[j] = v;
+  }
+}
 
+/*
+ * Moves the sorted window by one column. The leaving values are removed
+ * in the order of their occurrence and the entering values are merged.
+ * Both columns are followed by a NaN, which is never equal to or less
+ * than a window value, so no bounds checks are needed.
+ */
+void OpMedian::slide(const ValueType* window, size_t n, const ValueType* leaving, const ValueType* entering, int size, ValueType* next)
+{
+  size_t m = 0;
+  int l = 0;
+  int e = 0;
+  for (size_t i=0;i<n;++i)
+  {
+    ValueType v = window[i];
+    if (v == leaving[l])
+    {
+      ++l;
+      continue;
+    }
+    while (entering[e] < v) next[m++] = entering[e++];
+    next[m++] = v;
+  }
+  while (e < size) next[m++] = entering[e++];
+}
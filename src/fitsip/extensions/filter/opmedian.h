@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - median filter                                                       *
  *                                                                              *
- * modified: 2025-02-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -46,9 +46,23 @@ public:
   virtual void bindPython(void* m) const override;
 #endif
 
+  /**
+   * @brief Median filter with a threshold.
+   *
+   * A pixel is replaced by the median of the size x size window around it,
+   * if it deviates by more than threshold times sigma from the median; sigma
+   * is half the interquartile range of the window. A threshold of 0 gives a
+   * plain median filter. The border of size/2 pixels is not changed.
+   * @param image the image to filter
+   * @param threshold the threshold in units of sigma
+   * @param size the size of the window
+   */
   void filter(FitsImage* image, ValueType threshold, int size) const;
 
 private:
+  static void sortedColumn(const ValueType* data, int width, int size, ValueType* column);
+  static void slide(const ValueType* window, size_t n, const ValueType* leaving, const ValueType* entering, int size, ValueType* next);
+
   OpMedianDialog* dlg;
 };
 
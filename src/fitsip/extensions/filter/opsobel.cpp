@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - apply Sobel filter                                                  *
  *                                                                              *
- * modified: 2025-02-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -55,7 +55,7 @@ void OpSobel::bindPython(void* mod) const
     obj->getImage().log("Applied edge (Sobel) filter");
     return OK;
   },
-  "Apply edge (Sobel) filter",py::arg("obj"));
+  "Apply edge (Sobel) filter",py::arg("obj"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - unsharp masking                                                     *
  *                                                                              *
- * modified: 2025-02-06                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -57,7 +57,7 @@ void OpUnsharpMask::bindPython(void* mod) const
     obj->getImage().log(QString::asprintf("Unsharp mask: sigma=%f  strength=%f",sigma,strength));
     return OK;
   },
-  "Apply unsharp mask",py::arg("obj"),py::arg("sigma"),py::arg("strength"));
+  "Apply unsharp mask",py::arg("obj"),py::arg("sigma"),py::arg("strength"),py::call_guard<py::gil_scoped_release>());
 }
 #endif
 
@@ -0,0 +1,402 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - asterism star matching                                              *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "asterismmatcher.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <random>
+#include <set>
+#include <stdexcept>
+
+namespace
+{
+
+/* neighbours of a star forming triangles with it */
+const int neighbours = 6;
+/* tolerance of the triangle invariants */
+const double invariantTolerance = 0.01;
+/* triangles with a shorter longest side are ignored */
+const double minTriangleSize = 10;
+const int maxIterations = 1000;
+
+std::vector<QPointF> positions(const std::vector<AsterismMatcher::Point>& stars)
+{
+  std::vector<QPointF> list;
+  list.reserve(stars.size());
+  for (const AsterismMatcher::Point& p : stars) list.emplace_back(p.x,p.y);
+  return list;
+}
+
+inline Eigen::Vector2d map(const Eigen::Matrix3d& h, double x, double y)
+{
+  double w = h(2,0) * x + h(2,1) * y + h(2,2);
+  return Eigen::Vector2d((h(0,0)*x+h(0,1)*y+h(0,2))/w,(h(1,0)*x+h(1,1)*y+h(1,2))/w);
+}
+
+/* translation and scale to center the points at the origin with a mean distance of sqrt(2) */
+Eigen::Matrix3d normalization(const std::vector<Eigen::Vector2d>& p)
+{
+  Eigen::Vector2d c(0,0);
+  for (const auto& v : p) c += v;
+  c /= p.size();
+  double d = 0;
+  for (const auto& v : p) d += (v - c).norm();
+  d /= p.size();
+  double s = d > 0 ? sqrt(2.0) / d : 1;
+  Eigen::Matrix3d t;
+  t << s, 0, -s*c.x(),
+       0, s, -s*c.y(),
+       0, 0, 1;
+  return t;
+}
+
+}
+
+AsterismMatcher::AsterismMatcher():
+  model(Similarity),
+  brightStars(40),
+  tolerance(3),
+  transform(Eigen::Matrix3d::Identity()),
+  matchCount(0),
+  residual(0)
+{
+}
+
+AsterismMatcher::Model AsterismMatcher::getModel(const QString& name)
+{
+  if (name == "similarity") return Similarity;
+  if (name == "affine") return Affine;
+  if (name == "homography") return Homography;
+  throw std::invalid_argument(("unknown transformation model '"+name+"'").toStdString());
+}
+
+void AsterismMatcher::setModel(Model m)
+{
+  model = m;
+}
+
+AsterismMatcher::Model AsterismMatcher::getModel() const
+{
+  return model;
+}
+
+void AsterismMatcher::setBrightStars(int n)
+{
+  brightStars = std::max(n,4);
+}
+
+void AsterismMatcher::setTolerance(double pixels)
+{
+  tolerance = pixels;
+}
+
+void AsterismMatcher::setReference(const std::vector<Point>& stars)
+{
+  reference = stars;
+  referenceIndex.build(positions(reference));
+  referenceBright = brightest(stars,brightStars);
+  triangles = createTriangles(referenceBright);
+  std::sort(triangles.begin(),triangles.end(),[](const Triangle& t1, const Triangle& t2){ return t1.u < t2.u; });
+}
+
+bool AsterismMatcher::match(const std::vector<Point>& stars)
+{
+  transform = Eigen::Matrix3d::Identity();
+  matchCount = 0;
+  residual = 0;
+  int m = getMinimalSample();
+  std::vector<Point> frame = brightest(stars,brightStars);
+  if (static_cast<int>(referenceBright.size()) < m || static_cast<int>(frame.size()) < m) return false;
+  /* every pair of similar triangles votes for its vertices */
+  size_t nf = frame.size();
+  std::vector<int> votes(referenceBright.size()*nf,0);
+  for (const Triangle& t : createTriangles(frame))
+  {
+    auto it = std::lower_bound(triangles.begin(),triangles.end(),t.u-invariantTolerance,
+                               [](const Triangle& t1, double u){ return t1.u < u; });
+    for (;it!=triangles.end() && it->u<=t.u+invariantTolerance;++it)
+    {
+      if (fabs(it->v - t.v) > invariantTolerance) continue;
+      for (int k=0;k<3;++k) votes[it->vertex[k]*nf+t.vertex[k]]++;
+    }
+  }
+  /* the best voted reference star of every frame star is a candidate */
+  std::vector<std::pair<int,std::pair<int,int>>> voted;
+  for (size_t j=0;j<nf;++j)
+  {
+    int best = -1;
+    for (size_t i=0;i<referenceBright.size();++i)
+    {
+      if (votes[i*nf+j] > 1 && (best < 0 || votes[i*nf+j] > votes[best*nf+j])) best = static_cast<int>(i);
+    }
+    if (best >= 0) voted.push_back({votes[best*nf+j],{best,static_cast<int>(j)}});
+  }
+  std::stable_sort(voted.begin(),voted.end(),[](const auto& v1, const auto& v2){ return v1.first > v2.first; });
+  Pairs candidates;
+  for (const auto& v : voted) candidates.push_back({v.second.second,v.second.first});
+  if (static_cast<int>(candidates.size()) < m) return false;
+  /* RANSAC with a fixed seed, so the result is reproducible */
+  std::mt19937 rng(4711);
+  std::uniform_int_distribution<int> pick(0,static_cast<int>(candidates.size())-1);
+  Pairs best;
+  int iterations = maxIterations;
+  for (int it=0;it<iterations;++it)
+  {
+    Pairs sample;
+    while (static_cast<int>(sample.size()) < m)
+    {
+      const auto& c = candidates[pick(rng)];
+      if (std::find(sample.begin(),sample.end(),c) == sample.end()) sample.push_back(c);
+    }
+    Eigen::Matrix3d h;
+    if (!fit(frame,referenceBright,sample,h)) continue;
+    Pairs inliers = getInliers(frame,referenceBright,candidates,h);
+    if (inliers.size() > best.size())
+    {
+      best = inliers;
+      double w = static_cast<double>(best.size()) / candidates.size();
+      if (w >= 1) break;
+      double n = log(0.001) / log(1 - pow(w,m));
+      if (n < iterations) iterations = std::max(static_cast<int>(n)+1,it+1);
+    }
+  }
+  if (static_cast<int>(best.size()) < m + 1) return false;
+  Eigen::Matrix3d h;
+  if (!fit(frame,referenceBright,best,h)) return false;
+  /* refine with all stars of the catalogs */
+  const std::vector<Point>* ref = &referenceBright;
+  for (int pass=0;pass<2;++pass)
+  {
+    Pairs pairs = getNearest(stars,h);
+    if (pairs.size() < best.size()) break;
+    Eigen::Matrix3d refined;
+    if (!fit(stars,reference,pairs,refined)) break;
+    h = refined;
+    best = pairs;
+    frame = stars;
+    ref = &reference;
+  }
+  transform = h;
+  matchCount = static_cast<int>(best.size());
+  double sum = 0;
+  for (const auto& p : best)
+  {
+    Eigen::Vector2d q = map(h,frame[p.first].x,frame[p.first].y);
+    sum += (q - Eigen::Vector2d((*ref)[p.second].x,(*ref)[p.second].y)).squaredNorm();
+  }
+  residual = sqrt(sum/best.size());
+  return true;
+}
+
+const Eigen::Matrix3d& AsterismMatcher::getTransform() const
+{
+  return transform;
+}
+
+int AsterismMatcher::getMatchCount() const
+{
+  return matchCount;
+}
+
+double AsterismMatcher::getResidual() const
+{
+  return residual;
+}
+
+std::vector<AsterismMatcher::Point> AsterismMatcher::brightest(const std::vector<Point>& stars, size_t n)
+{
+  std::vector<Point> list(stars);
+  std::stable_sort(list.begin(),list.end(),[](const Point& p1, const Point& p2){ return p1.flux > p2.flux; });
+  if (list.size() > n) list.resize(n);
+  return list;
+}
+
+/*
+ * Creates the triangles of every star with each pair of its nearest neighbours.
+ */
+std::vector<AsterismMatcher::Triangle> AsterismMatcher::createTriangles(const std::vector<Point>& stars)
+{
+  int n = static_cast<int>(stars.size());
+  auto dist = [&](int i, int j){ return hypot(stars[i].x-stars[j].x,stars[i].y-stars[j].y); };
+  SpatialIndex index(positions(stars));
+  std::set<std::array<int,3>> used;
+  std::vector<Triangle> list;
+  for (int i=0;i<n;++i)
+  {
+    /* the star itself is among the results */
+    std::vector<int> near;
+    for (size_t j : index.findNearest(QPointF(stars[i].x,stars[i].y),neighbours+1))
+    {
+      if (static_cast<int>(j) != i) near.push_back(static_cast<int>(j));
+    }
+    int k = std::min(neighbours,static_cast<int>(near.size()));
+    for (int a=0;a<k;++a)
+    {
+      for (int b=a+1;b<k;++b)
+      {
+        std::array<int,3> v = {i,near[a],near[b]};
+        std::sort(v.begin(),v.end());
+        if (!used.insert(v).second) continue;
+        /* side i is opposite to vertex i */
+        std::array<std::pair<double,int>,3> sides = {{{dist(v[1],v[2]),v[0]},{dist(v[0],v[2]),v[1]},{dist(v[0],v[1]),v[2]}}};
+        std::sort(sides.begin(),sides.end(),[](const auto& s1, const auto& s2){ return s1.first > s2.first; });
+        if (sides[0].first < minTriangleSize) continue;
+        Triangle t;
+        t.u = sides[1].first / sides[0].first;
+        t.v = sides[2].first / sides[0].first;
+        for (int s=0;s<3;++s) t.vertex[s] = sides[s].second;
+        list.push_back(t);
+      }
+    }
+  }
+  return list;
+}
+
+int AsterismMatcher::getMinimalSample() const
+{
+  switch (model)
+  {
+    case Similarity:
+      return 2;
+    case Affine:
+      return 3;
+    case Homography:
+    default:
+      return 4;
+  }
+}
+
+/*
+ * Least squares fit of the model to the pairs (frame index, reference index).
+ */
+bool AsterismMatcher::fit(const std::vector<Point>& frame, const std::vector<Point>& ref, const Pairs& pairs, Eigen::Matrix3d& h) const
+{
+  int n = static_cast<int>(pairs.size());
+  if (n < getMinimalSample()) return false;
+  h = Eigen::Matrix3d::Identity();
+  switch (model)
+  {
+    case Similarity:
+    {
+      Eigen::MatrixXd a(2*n,4);
+      Eigen::VectorXd b(2*n);
+      for (int i=0;i<n;++i)
+      {
+        const Point& p = frame[pairs[i].first];
+        const Point& q = ref[pairs[i].second];
+        a.row(2*i) << p.x, -p.y, 1, 0;
+        a.row(2*i+1) << p.y, p.x, 0, 1;
+        b(2*i) = q.x;
+        b(2*i+1) = q.y;
+      }
+      Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(a);
+      if (qr.rank() < 4) return false;
+      Eigen::VectorXd s = qr.solve(b);
+      h << s(0), -s(1), s(2),
+           s(1), s(0), s(3),
+           0, 0, 1;
+      break;
+    }
+    case Affine:
+    {
+      Eigen::MatrixXd a(2*n,6);
+      Eigen::VectorXd b(2*n);
+      for (int i=0;i<n;++i)
+      {
+        const Point& p = frame[pairs[i].first];
+        const Point& q = ref[pairs[i].second];
+        a.row(2*i) << p.x, p.y, 1, 0, 0, 0;
+        a.row(2*i+1) << 0, 0, 0, p.x, p.y, 1;
+        b(2*i) = q.x;
+        b(2*i+1) = q.y;
+      }
+      Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(a);
+      if (qr.rank() < 6) return false;
+      Eigen::VectorXd s = qr.solve(b);
+      h << s(0), s(1), s(2),
+           s(3), s(4), s(5),
+           0, 0, 1;
+      break;
+    }
+    case Homography:
+    {
+      /* normalized direct linear transformation */
+      std::vector<Eigen::Vector2d> p1;
+      std::vector<Eigen::Vector2d> p2;
+      for (const auto& p : pairs)
+      {
+        p1.emplace_back(frame[p.first].x,frame[p.first].y);
+        p2.emplace_back(ref[p.second].x,ref[p.second].y);
+      }
+      Eigen::Matrix3d t1 = normalization(p1);
+      Eigen::Matrix3d t2 = normalization(p2);
+      Eigen::MatrixXd a(2*n,9);
+      for (int i=0;i<n;++i)
+      {
+        Eigen::Vector2d u = map(t1,p1[i].x(),p1[i].y());
+        Eigen::Vector2d v = map(t2,p2[i].x(),p2[i].y());
+        a.row(2*i) << -u.x(), -u.y(), -1, 0, 0, 0, v.x()*u.x(), v.x()*u.y(), v.x();
+        a.row(2*i+1) << 0, 0, 0, -u.x(), -u.y(), -1, v.y()*u.x(), v.y()*u.y(), v.y();
+      }
+      /* the solution is the eigenvector of the smallest eigenvalue of A'A */
+      Eigen::Matrix<double,9,9> ata = a.transpose() * a;
+      Eigen::SelfAdjointEigenSolver<Eigen::Matrix<double,9,9>> solver(ata);
+      Eigen::Matrix<double,9,1> s = solver.eigenvectors().col(0);
+      Eigen::Matrix3d hn;
+      hn << s(0), s(1), s(2),
+            s(3), s(4), s(5),
+            s(6), s(7), s(8);
+      h = t2.inverse() * hn * t1;
+      if (fabs(h(2,2)) < 1.0E-12) return false;
+      h /= h(2,2);
+      break;
+    }
+  }
+  return h.allFinite();
+}
+
+AsterismMatcher::Pairs AsterismMatcher::getInliers(const std::vector<Point>& frame, const std::vector<Point>& ref, const Pairs& candidates, const Eigen::Matrix3d& h) const
+{
+  Pairs inliers;
+  for (const auto& c : candidates)
+  {
+    Eigen::Vector2d q = map(h,frame[c.first].x,frame[c.first].y);
+    if (hypot(q.x()-ref[c.second].x,q.y()-ref[c.second].y) <= tolerance) inliers.push_back(c);
+  }
+  return inliers;
+}
+
+/*
+ * Pairs every frame star with the nearest reference star within the tolerance.
+ */
+AsterismMatcher::Pairs AsterismMatcher::getNearest(const std::vector<Point>& frame, const Eigen::Matrix3d& h) const
+{
+  Pairs pairs;
+  for (size_t j=0;j<frame.size();++j)
+  {
+    Eigen::Vector2d q = map(h,frame[j].x,frame[j].y);
+    long best = referenceIndex.findClosest(QPointF(q.x(),q.y()),tolerance);
+    if (best >= 0) pairs.push_back({static_cast<int>(j),static_cast<int>(best)});
+  }
+  return pairs;
+}
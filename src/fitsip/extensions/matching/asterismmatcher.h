@@ -0,0 +1,137 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - asterism star matching                                              *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef ASTERISMMATCHER_H
+#define ASTERISMMATCHER_H
+
+#include <fitsip/core/spatialindex.h>
+#include <Eigen/Dense>
+#include <QString>
+#include <vector>
+
+/**
+ * @brief Matches two star catalogs by triangle asterisms.
+ *
+ * Triangles are formed from every one of the brightest stars and its
+ * nearest neighbours. The ratios of their sides are invariant to shift,
+ * rotation and scale. The triangles of a frame are looked up among the
+ * triangles of the reference, and every hit votes for the three vertex
+ * pairs. The best voted pairs are the candidates for a RANSAC fit of the
+ * transformation, which is finally refined by least squares over all
+ * stars of the catalogs found within the tolerance.
+ *
+ * No seeding with selected stars is needed and the match does not depend
+ * on the previous frame, so dropped stars, large drifts and meridian
+ * flips are handled.
+ */
+class AsterismMatcher
+{
+public:
+  enum Model { Similarity, Affine, Homography };
+
+  struct Point
+  {
+    double x;
+    double y;
+    double flux;
+  };
+
+  AsterismMatcher();
+
+  /**
+   * @brief Get the model for a name used in parameters.
+   *
+   * Throws a std::invalid_argument for unknown names.
+   * @param name similarity, affine or homography
+   * @return the model
+   */
+  static Model getModel(const QString& name);
+
+  void setModel(Model m);
+
+  Model getModel() const;
+
+  /**
+   * @brief Set the number of brightest stars used for the asterisms.
+   * @param n the number of stars (default 40)
+   */
+  void setBrightStars(int n);
+
+  /**
+   * @brief Set the maximum distance of matched stars.
+   * @param pixels the distance in pixel (default 3)
+   */
+  void setTolerance(double pixels);
+
+  void setReference(const std::vector<Point>& stars);
+
+  /**
+   * @brief Match a catalog to the reference.
+   * @param stars the stars of the frame
+   * @return true if a transformation was found
+   */
+  bool match(const std::vector<Point>& stars);
+
+  /**
+   * @brief Get the transformation.
+   * @return the matrix mapping homogeneous frame coordinates to the reference
+   */
+  const Eigen::Matrix3d& getTransform() const;
+
+  int getMatchCount() const;
+
+  /**
+   * @brief Get the residual of the fit.
+   * @return the RMS distance of the matched stars in pixel
+   */
+  double getResidual() const;
+
+private:
+  struct Triangle
+  {
+    double u;          // second longest side / longest side
+    double v;          // shortest side / longest side
+    int vertex[3];     // vertices opposite to the sides in decreasing length
+  };
+
+  using Pairs = std::vector<std::pair<int,int>>;
+
+  static std::vector<Point> brightest(const std::vector<Point>& stars, size_t n);
+  static std::vector<Triangle> createTriangles(const std::vector<Point>& stars);
+  int getMinimalSample() const;
+  bool fit(const std::vector<Point>& frame, const std::vector<Point>& ref, const Pairs& pairs, Eigen::Matrix3d& h) const;
+  Pairs getInliers(const std::vector<Point>& frame, const std::vector<Point>& ref, const Pairs& candidates, const Eigen::Matrix3d& h) const;
+  Pairs getNearest(const std::vector<Point>& frame, const Eigen::Matrix3d& h) const;
+
+  Model model;
+  int brightStars;
+  double tolerance;
+  std::vector<Point> reference;           // all reference stars
+  SpatialIndex referenceIndex;            // positions of the reference stars
+  std::vector<Point> referenceBright;     // brightest first
+  std::vector<Triangle> triangles;        // sorted by u
+  Eigen::Matrix3d transform;
+  int matchCount;
+  double residual;
+};
+
+#endif // ASTERISMMATCHER_H
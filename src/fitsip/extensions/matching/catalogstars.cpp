@@ -0,0 +1,171 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - plugin to catalog the stars of a list of files                      *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "catalogstars.h"
+#include <fitsip/core/dialogs/progressdialog.h>
+#include <fitsip/core/io/framesequence.h>
+#include <QApplication>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+
+CatalogStars::CatalogStars()
+{
+  profiler = SimpleProfiler("CatalogStars");
+}
+
+CatalogStars::~CatalogStars()
+{
+}
+
+QString CatalogStars::getMenuEntry() const
+{
+  return "Analyse/Catalog Stars";
+}
+
+bool CatalogStars::requiresFileList() const
+{
+  return true;
+}
+
+OpPlugin::ResultType CatalogStars::execute(const std::vector<QFileInfo>& list, const OpPluginData& /*data*/)
+{
+  FrameSequence frames(list);
+  if (!frames.getErrors().isEmpty())
+  {
+    setError("CatalogStars: "+frames.getErrors().join("\n"));
+    return ERROR;
+  }
+  if (frames.empty()) return CANCELLED;
+  ProgressDialog* prog = new ProgressDialog();
+  prog->setMaximum(frames.size());
+  prog->setProgress(0);
+  prog->appendMessage("cataloguing "+QString::number(frames.size())+" frames");
+  prog->show();
+  /* the detection runs in the background, the dialog is updated here */
+  std::atomic<size_t> done(0);
+  uint64_t hits = catalog.getHits();
+  profiler.start();
+  auto result = std::async(std::launch::async,[&](){
+    return catalog.catalogue(frames,[&done](size_t n){
+      size_t last = done;
+      while (n > last && !done.compare_exchange_weak(last,n)) {}
+    });
+  });
+  while (result.wait_for(std::chrono::milliseconds(50)) != std::future_status::ready)
+  {
+    prog->setProgress(done);
+    QApplication::processEvents();
+  }
+  std::vector<StarCatalog::Catalog> catalogs = result.get();
+  profiler.stop();
+  report(frames,catalogs,catalog.getHits()-hits);
+  prog->deleteLater();
+  return OK;
+}
+
+bool CatalogStars::supportsBatch() const
+{
+  return true;
+}
+
+QStringList CatalogStars::getBatchParameters() const
+{
+  return {"threshold=3  detection threshold in standard deviations of the background noise",
+          "blur=false  convolve the frames with a gaussian before the detection",
+          "psf=none  fit a gaussian or moffat PSF to every star for position, FWHM and ellipticity",
+          "cache=true  read and write the catalogs in sidecar files (<file>.stars)"};
+}
+
+OpPlugin::ResultType CatalogStars::executeBatch(const std::vector<QFileInfo>& list, const QVariantMap& params)
+{
+  FrameSequence frames(list);
+  if (!frames.getErrors().isEmpty())
+  {
+    setError("CatalogStars: "+frames.getErrors().join("\n"));
+    return ERROR;
+  }
+  if (frames.empty())
+  {
+    setError("CatalogStars: no files to catalog");
+    return ERROR;
+  }
+  double threshold;
+  bool blur, cache;
+  QString psf;
+  if (!readBatchParameter(params,"threshold",3.0,threshold,0.5,100) ||
+      !readBatchParameter(params,"blur",false,blur) ||
+      !readBatchParameter(params,"cache",true,cache))
+  {
+    return ERROR;
+  }
+  psf = params.value("psf","none").toString();
+  catalog.setThreshold(threshold);
+  catalog.setBlur(blur);
+  try
+  {
+    catalog.setPSFFit(psf != "none",psf != "none" ? PSFFitter::getModel(psf) : PSFFitter::Moffat);
+  }
+  catch (const std::exception& ex)
+  {
+    setError(QString("CatalogStars: ")+ex.what());
+    return ERROR;
+  }
+  catalog.setCacheEnabled(cache);
+  uint64_t hits = catalog.getHits();
+  profiler.start();
+  std::vector<StarCatalog::Catalog> catalogs = catalog.catalogue(frames);
+  profiler.stop();
+  report(frames,catalogs,catalog.getHits()-hits);
+  return OK;
+}
+
+/*
+ * median of a list of star properties, 0 for an empty list
+ */
+static double median(std::vector<float>& values)
+{
+  if (values.empty()) return 0;
+  std::nth_element(values.begin(),values.begin()+values.size()/2,values.end());
+  return values[values.size()/2];
+}
+
+void CatalogStars::report(const FrameSequence& frames, const std::vector<StarCatalog::Catalog>& catalogs, uint64_t cached)
+{
+  QString s;
+  for (size_t i=0;i<frames.size();++i)
+  {
+    std::vector<float> fwhm;
+    std::vector<float> ellipticity;
+    for (const StarCatalog::Entry& star : catalogs[i])
+    {
+      fwhm.push_back(star.fwhm);
+      ellipticity.push_back(star.ellipticity);
+    }
+    s += QString::asprintf("%s: %d stars, FWHM %.2f, ellipticity %.2f\n",frames.getName(i).toUtf8().data(),static_cast<int>(catalogs[i].size()),
+                           median(fwhm),median(ellipticity));
+  }
+  log(s);
+  log(QString::asprintf("catalogued %d frames in %.1f s (%d from sidecar files)",static_cast<int>(frames.size()),
+                        profiler.getDuration()/1.0e6,static_cast<int>(cached)));
+}
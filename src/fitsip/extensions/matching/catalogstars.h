@@ -0,0 +1,65 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - plugin to catalog the stars of a list of files                      *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef CATALOGSTARS_H
+#define CATALOGSTARS_H
+
+#include "starcatalog.h"
+#include <fitsip/core/opplugin.h>
+#include <QObject>
+#include <vector>
+
+class FrameSequence;
+
+/**
+ * @brief Detects the stars of all frames of a file list in parallel.
+ *
+ * The catalogs are written to the sidecar files of StarCatalog, where
+ * alignment and quality ranking of the stacking read them.
+ */
+class CatalogStars: public OpPlugin
+{
+  Q_OBJECT
+  Q_INTERFACES(OpPlugin)
+public:
+  CatalogStars();
+  virtual ~CatalogStars() override;
+
+  virtual QString getMenuEntry() const override;
+
+  virtual bool requiresFileList() const override;
+
+  virtual ResultType execute(const std::vector<QFileInfo>& list, const OpPluginData& data=OpPluginData()) override;
+
+  virtual bool supportsBatch() const override;
+
+  virtual QStringList getBatchParameters() const override;
+
+  virtual ResultType executeBatch(const std::vector<QFileInfo>& list, const QVariantMap& params) override;
+
+private:
+  void report(const FrameSequence& frames, const std::vector<StarCatalog::Catalog>& catalogs, uint64_t cached);
+
+  StarCatalog catalog;
+};
+
+#endif // CATALOGSTARS_H
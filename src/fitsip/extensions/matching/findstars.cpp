@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - star detection class                                                *
  *                                                                              *
- * modified: 2025-10-26                                                         *
+ * modified: 2026-10-19                                                         *
  ********************************************************************************
  * Copyright (C) by Harald Braeuning.                                           *
  ********************************************************************************
@@ -38,6 +38,7 @@
 #include <fitsip/core/histogram.h>
 #include <fitsip/core/starlist.h>
 #include <fitsip/core/math/gaussfit.h>
+#include <fitsip/core/parallel.h>
 #include <cmath>
 #include <algorithm>
 #include <QDebug>
@@ -71,6 +72,7 @@ FindStars::FindStars():OpPlugin(),
   movemax(1.0),
   sky(0),
   quickflag(true),
+  meshflag(false),
   peakrad(1.0*starfwhm),
   tinysize(9),
   maxiter(20)
@@ -119,6 +121,22 @@ std::vector<Star> FindStars::findStars(const FitsImage& image)
   c_hot = 0;
   c_star = 0;
 
+  /* with a background map the background is removed first and the
+     threshold is scaled by the local noise relative to the mean noise */
+  bool local = bkgmap && rmsmap && bkgmap.getWidth() == image.getWidth() && bkgmap.getHeight() == image.getHeight();
+  FitsImage subtracted;
+  if (local)
+  {
+    subtracted = image;
+    subtracted -= bkgmap;
+    sky = 0;
+    double sum = 0;
+    for (ConstPixelIterator it=rmsmap.getConstPixelIterator();it.hasNext();++it) sum += it.getAbs();
+    skysig = sum / (rmsmap.getWidth() * rmsmap.getHeight());
+  }
+  const FitsImage& source = local ? subtracted : image;
+  const ValueType* noise = local ? rmsmap.getLayer(0).getData() : nullptr;
+
   /* first, create and initialize to zero the bit map */
   bitmap = std::vector<uint8_t>(image.getWidth()*image.getHeight(),0);
   /* if (quickflag == false), convolve the image with a gaussian and put
@@ -127,7 +145,7 @@ std::vector<Star> FindStars::findStars(const FitsImage& image)
   double signif;
   if (quickflag)
   {
-    conv_img = image;
+    conv_img = source;
     signif = sky + (minsig * skysig);
   }
   else
@@ -139,7 +157,7 @@ std::vector<Star> FindStars::findStars(const FitsImage& image)
      */
 //    double conv_sig = skysig;
 //    signif = sky + minsig * skysig;
-    conv_img = convolve(image,starfwhm);
+    conv_img = convolve(source,starfwhm);
     double conv_sig = find_skysig(conv_img,skysig);
     signif = minsig * conv_sig;
     sky = 0;
@@ -147,121 +165,120 @@ std::vector<Star> FindStars::findStars(const FitsImage& image)
     maxsharp = cmaxsharp;
   }
   qDebug() << "signif" << signif;
-  /* next, go through the image looking for peaks which haven't been marked yet */
-  ConstPixelIterator it = conv_img.getConstPixelIterator();
-  for (int y=0;y<conv_img.getHeight();++y)
+  /* next, go through the image looking for peaks. The search and the shape
+     analysis of the candidates run in parallel on stripes of rows; the
+     candidates are accepted afterwards in raster order, so that the bitmap
+     of used pixels gives the same result as a serial scan. */
+  struct Candidate
   {
-    for (int x=0;x<conv_img.getWidth();++x,++it)
+    int x, y;
+    double xc, yc, fwhm, xwidth, ywidth;
+    double round, sharp, hot;
+  };
+  int w = conv_img.getWidth();
+  int h = conv_img.getHeight();
+  std::vector<std::vector<Candidate>> candidates(h);
+  std::vector<int> abovesig(h,0);
+  std::vector<int> peaks(h,0);
+  double noisescale = (local && skysig > 0) ? (signif - sky) / skysig : 0;
+  parallel::forRange(h,[&](int y0, int y1){
+    for (int y=y0;y<y1;++y)
     {
-//      qDebug() << x << "," << y << ": " << it.getAbs();
-      if (it.getAbs() < signif)
+      ConstPixelIterator it = conv_img.getConstPixelIterator(0,y);
+      const ValueType* rms = noise ? noise + static_cast<size_t>(y) * w : nullptr;
+      for (int x=0;x<w;++x,++it)
       {
-        continue;
+        double threshold = rms ? sky + noisescale * rms[x] : signif;
+        if (it.getAbs() < threshold) continue;
+        abovesig[y]++;
+        /* first, let's see if this data value is a peak */
+        if (!is_peak(conv_img,x,y)) continue;
+        peaks[y]++;
+        Candidate c;
+        c.x = x;
+        c.y = y;
+        int tsx,tsy;
+        calc_box(x,y,w,h,&tsx,&tsy,wtiny,htiny);
+        star_axes(conv_img,tsx,tsy,wtiny,htiny,sky,&c.xc,&c.yc,&c.fwhm,&c.xwidth,&c.ywidth,maxiter);
+        /* added checks on 'irow' and 'icol' to make sure they're
+           inside the image.  MWR 12/13/92 */
+        int iy = (int)(c.yc + 0.5);
+        if (iy >= h) iy = h - 1;
+        int ix = (int)(c.xc + 0.5);
+        if (ix >= w) ix = w - 1;
+        c.round = 2.0 * ((c.xwidth - c.ywidth) / (c.xwidth + c.ywidth));
+        c.sharp = sharpness(conv_img,ix,iy);
+        /* check to see if the peak pixel looks like a hot pixel/CR */
+        c.hot = hotness(conv_img,x,y);
+        candidates[y].push_back(c);
       }
-      c_abovesig++;
-      /* first, let's see if this data value is a peak */
-      if (!is_peak(conv_img,x,y))
-      {
-        continue;
-      }
-      c_peak++;
-
-      int tsx,tsy;
-      calc_box(x,y,conv_img.getWidth(),conv_img.getHeight(),&tsx,&tsy,wtiny,htiny);
-
-      double xc,yc,fwhm,xwidth,ywidth;
-      star_axes(conv_img,tsx,tsy,wtiny,htiny,sky,&xc,&yc,&fwhm,&xwidth,&ywidth,maxiter);
-
-      if ((fabs(xc-x) > movemax) || (fabs(yc-y) > movemax))
+    }
+  },16);
+  for (int y=0;y<h;++y)
+  {
+    c_abovesig += abovesig[y];
+    c_peak += peaks[y];
+    for (const Candidate& c : candidates[y])
+    {
+      if ((fabs(c.xc-c.x) > movemax) || (fabs(c.yc-c.y) > movemax))
       {
-        qDebug() << "candidate" << x << "," << y << "has moved outside limits: " << std::max(fabs(xc-x),fabs(yc-y));
+        qDebug() << "candidate" << c.x << "," << c.y << "has moved outside limits: " << std::max(fabs(c.xc-c.x),fabs(c.yc-c.y));
         continue;
       }
 
       /* depending on the results, call it a star or don't */
-      if (!validFWHM(fwhm))
+      if (!validFWHM(c.fwhm))
       {
-        qDebug() << "candidate" << x << "," << y << "has FWHM outside limits:" << fwhm;
+        qDebug() << "candidate" << c.x << "," << c.y << "has FWHM outside limits:" << c.fwhm;
         continue;
       }
       c_1validfwhm++;
 
       /* there used to be a loop here, but I deleted it - it slowed
          things down and threw out some good stars.  MWR */
-      /* added checks on 'irow' and 'icol' to make sure they're
-         inside the image.  MWR 12/13/92 */
-      int iy = (int)(yc + 0.5);
-      if (iy >= conv_img.getHeight()) iy = conv_img.getHeight() - 1;
-      int ix = (int)(xc + 0.5);
-      if (ix >= conv_img.getWidth()) ix = conv_img.getWidth() - 1;
+      int iy = (int)(c.yc + 0.5);
+      if (iy >= h) iy = h - 1;
+      int ix = (int)(c.xc + 0.5);
+      if (ix >= w) ix = w - 1;
 
       if (bitmap[iy*image.getWidth()+ix])
       {
         c_biton++;
         continue;
       }
-      if (!validFWHM(fwhm))
-      {
-        c_2validfwhm++;
-        continue;
-      }
 
-      double round = 2.0 * ((xwidth - ywidth) / (xwidth + ywidth));
-      if ((round < minround) || (round > maxround))
+      if ((c.round < minround) || (c.round > maxround))
       {
-        qDebug() << "candidate" << x << "," << y << "has roundness outside limits:" << round;
+        qDebug() << "candidate" << c.x << "," << c.y << "has roundness outside limits:" << c.round;
         c_round++;
         continue;
       }
 
-      double sharp = sharpness(conv_img,ix,iy);
-      if (sharp == NAN || (sharp < minsharp) || (sharp > maxsharp))
+      if (std::isnan(c.sharp) || (c.sharp < minsharp) || (c.sharp > maxsharp))
       {
-        qDebug() << "candidate" << x << "," << y << "has sharpness outside limits:" << sharp;
+        qDebug() << "candidate" << c.x << "," << c.y << "has sharpness outside limits:" << c.sharp;
         c_sharp++;
         continue;
       }
 
-      /* check to see if the peak pixel looks like a hot pixel/CR */
-      double hot_factor = hotness(conv_img,x,y);
-      if ((hot_factor < minhot) || (hot_factor > maxhot))
+      if ((c.hot < minhot) || (c.hot > maxhot))
       {
-        qDebug() << "candidate" << x << "," << y << "has hotness outside limits:" << hot_factor;
+        qDebug() << "candidate" << c.x << "," << c.y << "has hotness outside limits:" << c.hot;
         c_hot++;
         continue;
       }
 
-//      if (showflag) {
-//#ifdef XWINDOWS
-//        do_crosshair(irow, icol);
-//#endif
-//      }
-
-//      /*
-//       * should we print out the FWHM for each detected object,
-//       *   or a width based on the second moments?   The default is
-//       *   to print FWHM, but the user can request the second-moment-
-//       *   based value via a command-line option "secondmom".
-//       */
-//      if (moment_flag == 0) {
-//        width_value = fwhm;
-//      }
-//      else {
-//        width_value = 0.5*(xwidth + ywidth);
-//      }
 #ifdef DEBUG
       printf("%5d %7.2f   %7.2f   %7.2f   %6.3f    %6.3f   %6.3f \n",
-          ++num_star, xc, yc,	conv_img->getConstPixelIterator(ix,iy).getAbs() - sky,
-          fwhm, round, sharp);
+          ++num_star, c.xc, c.yc, conv_img.getConstPixelIterator(ix,iy).getAbs() - sky,
+          c.fwhm, c.round, c.sharp);
 #endif
-      Star star(xc,yc,fwhm,xwidth,ywidth,round,sharp,hot_factor);
+      Star star(c.xc,c.yc,c.fwhm,c.xwidth,c.ywidth,c.round,c.sharp,c.hot);
       stars.push_back(star);
       c_star++;
 
       /* if it WAS a star, mark out all the pixels around it */
-      markpix(image,xc,yc,fwhm);
-//       if(num_star == maxstars)
-//      error(1,"stars: too many stars found");
+      markpix(image,c.xc,c.yc,c.fwhm);
     }
   }
   return stars;
@@ -307,6 +324,35 @@ void FindStars::starAxes(const FitsImage& image, const QRect &box, double sky, d
 
 
 
+void FindStars::setSky(double mean, double sigma)
+{
+  sky = mean;
+  skysig = sigma;
+}
+
+void FindStars::setBackground(const FitsImage& background, const FitsImage& rms)
+{
+  bkgmap = background;
+  rmsmap = rms;
+}
+
+void FindStars::setThreshold(double sigma)
+{
+  minsig = sigma;
+}
+
+void FindStars::setBlur(bool flag)
+{
+  quickflag = !flag;
+}
+
+QString FindStars::getParameterKey() const
+{
+  return QString::asprintf("minsig=%g starfwhm=%g fwhm=%g..%g round=%g..%g sharp=%g..%g csharp=%g..%g hot=%g..%g movemax=%g blur=%d tinysize=%d maxiter=%d",
+                           minsig,starfwhm,minfwhm,maxfwhm,minround,maxround,minsharp,maxsharp,cminsharp,cmaxsharp,
+                           minhot,maxhot,movemax,quickflag?0:1,tinysize,maxiter);
+}
+
 OpPlugin::ResultType FindStars::execute1(std::shared_ptr<FitsObject> image, const OpPluginData& data)
 {
   Histogram hist;
@@ -327,6 +373,7 @@ OpPlugin::ResultType FindStars::execute1(std::shared_ptr<FitsObject> image, cons
   d.setTinyboxSize(tinysize);
   d.setMoveMax(movemax);
   d.setBlur(!quickflag);
+  d.setBackgroundMap(meshflag);
   d.setIterations(maxiter);
   if (d.exec())
   {
@@ -344,14 +391,34 @@ OpPlugin::ResultType FindStars::execute1(std::shared_ptr<FitsObject> image, cons
     tinysize = d.getTinyboxSize();
     movemax = d.getMoveMax();
     quickflag = !d.isBlur();
+    meshflag = d.isBackgroundMap();
     maxiter = d.getIterations();
 
     profiler.start();
     FitsImage img = image->getImage().toGray();
+    FitsImage bkg;
+    FitsImage rms;
+    if (meshflag)
+    {
+      try
+      {
+        auto map = image->getBackgroundMap();
+        bkg = map->getBackground().toGray();
+        rms = map->getRMS().toGray();
+      }
+      catch (const std::exception& ex)
+      {
+        setError(ex.what());
+        return ERROR;
+      }
+    }
     if (!data.aoi.isEmpty())
     {
       img = img.subImage(data.aoi);
+      if (bkg) bkg = bkg.subImage(data.aoi);
+      if (rms) rms = rms.subImage(data.aoi);
     }
+    setBackground(bkg,rms);
     //    if (image->getDepth() > 1)
     //    {
     //image = OpToGray().toGray(image);
@@ -407,58 +474,88 @@ OpPlugin::ResultType FindStars::execute2(std::shared_ptr<FitsObject> image, cons
   return CANCELLED;
 }
 
+/* The gaussian is separable: the 2D kernel is the product of the 1D
+   profile in x and y, and the box sum needed for the "extra" bit is the
+   product of two 1D box sums. The image is processed in stripes of rows;
+   each stripe first filters its rows (including the kernel halo)
+   horizontally and then combines them vertically. */
 FitsImage FindStars::convolve(const FitsImage& image, double fwhm)
 {
   Gaussian gauss(fwhm);
-  FitsImage conv_img("tmp",image.getWidth(),image.getHeight(),1);
-  int offset = gauss.n / 2;
+  int w = image.getWidth();
+  int h = image.getHeight();
+  FitsImage conv_img("tmp",w,h,1);
+  int n = gauss.n;
+  int offset = n / 2;
+  if (w < n || h < n) return conv_img;
+  /* the middle row of the 2D kernel is the 1D profile */
+  std::vector<double> g(gauss.data.begin()+offset*n,gauss.data.begin()+(offset+1)*n);
+  ValueType* out = conv_img.getLayer(0).getData();
   /* now, write real numbers to all of the image that we can */
-  for (int y=offset;y<image.getHeight()-offset;y++)
-  {
-    PixelIterator it = conv_img.getPixelIterator(offset,y);
-    for (int x=offset;x<image.getWidth()-offset;x++)
+  parallel::forRange(h-2*offset,[&](int r0, int r1){
+    int rows = r1 - r0 + 2 * offset;
+    std::vector<double> gray(w);
+    std::vector<double> hgauss(static_cast<size_t>(rows)*w);
+    std::vector<double> hbox(static_cast<size_t>(rows)*w);
+    for (int k=0;k<rows;k++)
+    {
+      ConstPixelIterator it = image.getConstPixelIterator(0,r0+k);
+      for (int x=0;x<w;x++,++it) gray[x] = it.getAbs();
+      double* pg = hgauss.data() + static_cast<size_t>(k) * w;
+      double* pb = hbox.data() + static_cast<size_t>(k) * w;
+      for (int x=offset;x<w-offset;x++)
+      {
+        const double* v = gray.data() + x - offset;
+        double sum = 0;
+        double dsum = 0;
+        for (int j=0;j<n;j++)
+        {
+          sum += v[j] * g[j];
+          dsum += v[j];
+        }
+        pg[x] = sum;
+        pb[x] = dsum;
+      }
+    }
+    std::vector<double> sum(w);
+    std::vector<double> dsum(w);
+    for (int r=r0;r<r1;r++)
     {
-      double v = do_gauss(image,x,y,gauss);
-      /*
-       * tests on TASS images show that the negative
-       * "moats" around star centers in the convolved
-       * image can cause the centroiding routine to go
-       * haywire.  Let's replace negative values with zero
-       * in the convolved image, to avoid this.
-       *     MWR 3/16/1997
-       */
+      std::fill(sum.begin(),sum.end(),0.0);
+      std::fill(dsum.begin(),dsum.end(),0.0);
+      for (int i=0;i<n;i++)
+      {
+        const double* pg = hgauss.data() + static_cast<size_t>(r-r0+i) * w;
+        const double* pb = hbox.data() + static_cast<size_t>(r-r0+i) * w;
+        double gi = g[i];
+        for (int x=offset;x<w-offset;x++)
+        {
+          sum[x] += gi * pg[x];
+          dsum[x] += pb[x];
+        }
+      }
+      ValueType* po = out + static_cast<size_t>(r+offset) * w;
+      for (int x=offset;x<w-offset;x++)
+      {
+        double v = (sum[x] - dsum[x] * gauss.gsum) / gauss.gnum;		/* this is the "extra" bit */
+        /*
+         * tests on TASS images show that the negative
+         * "moats" around star centers in the convolved
+         * image can cause the centroiding routine to go
+         * haywire.  Let's replace negative values with zero
+         * in the convolved image, to avoid this.
+         *     MWR 3/16/1997
+         */
 #ifdef CLIPNEGATIVE
-      if (v < 0) v = 0;
+        if (v < 0) v = 0;
 #endif
-      it[0] = v;
-      ++it;
+        po[x] = v;
+      }
     }
-  }
+  },32);
   return conv_img;
 }
 
-double FindStars::do_gauss(const FitsImage& image, uint32_t x, uint32_t y, const Gaussian& gauss)
-{
-  uint32_t sx = x - gauss.n / 2;
-  uint32_t sy = y - gauss.n / 2;
-  double sum = 0;
-  double dsum = 0;
-  const double* dq = gauss.data.data();
-  for (uint32_t i=0;i<gauss.n;i++)
-  {
-    ConstPixelIterator it = image.getConstPixelIterator(sx,sy+i);
-    for (uint32_t j=0;j<gauss.n;j++)
-    {
-      double v = it.getAbs();
-      sum += v * (*dq++);
-      dsum += v;
-      ++it;
-    }
-  }
-  sum = (sum - dsum * gauss.gsum) / gauss.gnum;		/* this is the "extra" bit */
-  return sum;
-}
-
 #define CLIPSIG    3.0        /* clip values more than this many stdev */
                               /* from 0.0 when calculating sky-sig in  */
                               /* sg_skysig routine. */
@@ -484,21 +581,37 @@ double FindStars::do_gauss(const FitsImage& image, uint32_t x, uint32_t y, const
 */
 double FindStars::find_skysig(const FitsImage& image, double rough_sig)
 {
-  double total = 0.0;
-  int pixnum = 0;
-  double sumsq = 0.0;
   double minval = -CLIPSIG * rough_sig;
   double maxval = CLIPSIG * rough_sig;
-  ConstPixelIterator it = image.getConstPixelIterator();
-  for (int i=0;i<image.getWidth()*image.getHeight();i++)
-  {
-    double number = it.getAbs();
-    if ((number >= minval) && (number <= maxval))
+  /* partial sums per row, added up in order */
+  int h = image.getHeight();
+  std::vector<double> rowtotal(h,0.0);
+  std::vector<double> rowsumsq(h,0.0);
+  std::vector<long> rowpixnum(h,0);
+  parallel::forRange(h,[&](int y0, int y1){
+    for (int y=y0;y<y1;y++)
     {
-      total += (double)number;
-      sumsq += (double)number*(double)number;
-      pixnum++;
+      ConstPixelIterator it = image.getConstPixelIterator(0,y);
+      for (int x=0;x<image.getWidth();x++,++it)
+      {
+        double number = it.getAbs();
+        if ((number >= minval) && (number <= maxval))
+        {
+          rowtotal[y] += number;
+          rowsumsq[y] += number * number;
+          rowpixnum[y]++;
+        }
+      }
     }
+  },16);
+  double total = 0.0;
+  long pixnum = 0;
+  double sumsq = 0.0;
+  for (int y=0;y<h;y++)
+  {
+    total += rowtotal[y];
+    sumsq += rowsumsq[y];
+    pixnum += rowpixnum[y];
   }
   if (pixnum < 2) return 1.0;
   double mean = total / pixnum;
@@ -926,9 +1039,9 @@ void FindStars::markpix(const FitsImage& image, double xc, double yc, double fwh
   int msx = xc < peakrad ? 0 : static_cast<int>(xc-peakrad);
   int msy = yc < peakrad ? 0 : static_cast<int>(yc-peakrad);
   int mex = static_cast<int>(xc+peakrad);
-  if (mex < image.getWidth()-1)	mex = image.getWidth() - 1;
+  if (mex > image.getWidth()-1)	mex = image.getWidth() - 1;
   int mey = static_cast<int>(yc+peakrad);
-  if (mey < image.getHeight()-1)	mey = image.getHeight() - 1;
+  if (mey > image.getHeight()-1)	mey = image.getHeight() - 1;
   for (int i=msy;i<=mey;i++)
   {
     for (int j=msx;j<=mex;j++)
@@ -1018,7 +1131,7 @@ double FindStars::sharpness(const FitsImage& image, uint32_t x, uint32_t y)
   for (uint32_t i = ssy;i<sey;i++)
   {
     ConstPixelIterator it = image.getConstPixelIterator(ssx,i);
-    for (uint32_t j=ssx;j<sey;j++)
+    for (uint32_t j=ssx;j<sex;j++)
     {
       sum += it.getAbs() - sky;
       ++it;
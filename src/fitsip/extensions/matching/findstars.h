@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - star detection class                                                *
  *                                                                              *
- * modified: 2025-08-27                                                         *
+ * modified: 2026-10-19                                                         *
  ********************************************************************************
  * Copyright (C) by Harald Braeuning.                                           *
  ********************************************************************************
@@ -57,6 +57,44 @@ public:
 
   std::vector<Star> findStars(const FitsImage& image, PixelList* pixels, ValueType sky, int box);
 
+  /**
+   * @brief Set the sky background used by findStars(const FitsImage&).
+   * @param mean the mean sky value
+   * @param sigma the standard deviation of the sky
+   */
+  void setSky(double mean, double sigma);
+
+  /**
+   * @brief Use a background and noise map instead of the global sky values.
+   *
+   * The background is subtracted before the detection and the detection
+   * threshold follows the local noise. Empty images restore the use of the
+   * global sky values.
+   * @param background the background map (see BackgroundMap)
+   * @param rms the noise map
+   */
+  void setBackground(const FitsImage& background, const FitsImage& rms);
+
+  /**
+   * @brief Set the detection threshold.
+   * @param sigma the minimum number of standard deviations above the sky
+   */
+  void setThreshold(double sigma);
+
+  /**
+   * @brief Convolve the image with a gaussian before the detection.
+   * @param flag true to convolve (slower, but finds fainter stars)
+   */
+  void setBlur(bool flag);
+
+  /**
+   * @brief Get a description of all parameters affecting the detection.
+   *
+   * Used as key for cached star catalogs.
+   * @return the parameters as text
+   */
+  QString getParameterKey() const;
+
   [[deprecated]]
   void starAxes(const FitsImage& image, const QRect& box, double sky,
                 double *xc, double *yc, double *fwhm, double *xwidth, double *ywidth, int maxiter);
@@ -79,7 +117,6 @@ private:
   ResultType execute1(std::shared_ptr<FitsObject> image, const OpPluginData& data=OpPluginData());
   ResultType execute2(std::shared_ptr<FitsObject> image, const OpPluginData& data=OpPluginData());
   FitsImage convolve(const FitsImage& image, double fwhm);
-  double do_gauss(const FitsImage& image, uint32_t x, uint32_t y, const Gaussian& gauss);
   double find_skysig(const FitsImage& image, double rough_sig);
   bool is_peak(const FitsImage& image, uint32_t xc, uint32_t yc);
   void calc_box(int x, int y, int w, int h, int *tsx, int *tsy, int wsize2, int hsize2);
@@ -120,11 +157,14 @@ private:
   double movemax;         /* max difference between brightest pixel and center of light */
   double sky;             /* background sky value */
   bool quickflag;         /* if true, no guassian convolution is done */
+  bool meshflag;          /* if true, a background map is used (interactive use) */
   uint32_t peakrad;       /* peak radius (in pixel) for search algorithms */
   int tinysize;           /* size of area on which to perform analysis (>= maxfwhm) */
   int maxiter;
   std::vector<uint8_t> bitmap;        /* bitmap to flag pixel as used */
   FitsImage conv_img;
+  FitsImage bkgmap;                   /* local background */
+  FitsImage rmsmap;                   /* local noise */
 
 };
 
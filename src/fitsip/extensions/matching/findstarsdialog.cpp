@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - dialog for star detection                                           *
  *                                                                              *
- * modified: 2022-12-01                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -174,6 +174,16 @@ void FindStarsDialog::setBlur(bool flag)
   ui->blurBox->setChecked(flag);
 }
 
+bool FindStarsDialog::isBackgroundMap() const
+{
+  return ui->backgroundMapBox->isChecked();
+}
+
+void FindStarsDialog::setBackgroundMap(bool flag)
+{
+  ui->backgroundMapBox->setChecked(flag);
+}
+
 int FindStarsDialog::getIterations() const
 {
   return ui->iterationBox->value();
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - dialog for star detection                                           *
  *                                                                              *
- * modified: 2022-12-01                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -93,6 +93,10 @@ public:
 
   void setBlur(bool flag);
 
+  bool isBackgroundMap() const;
+
+  void setBackgroundMap(bool flag);
+
   int getIterations() const;
 
   void setIterations(int v);
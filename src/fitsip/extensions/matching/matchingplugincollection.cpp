@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - plugins to match images                                             *
  *                                                                              *
- * modified: 2025-10-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -21,6 +21,7 @@
  ********************************************************************************/
 
 #include "matchingplugincollection.h"
+#include "catalogstars.h"
 #include "findstars.h"
 #include "measurematch.h"
 #include "starmatcher.h"
@@ -30,6 +31,7 @@ MatchingPluginCollection::MatchingPluginCollection()
   plugins.push_back(new FindStars());
   plugins.push_back(new MeasureMatch());
   plugins.push_back(new StarMatcher());
+  plugins.push_back(new CatalogStars());
 }
 
 MatchingPluginCollection::~MatchingPluginCollection()
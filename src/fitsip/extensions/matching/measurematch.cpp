@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - plugin to match two images                                          *
  *                                                                              *
- * modified: 2025-02-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -26,6 +26,7 @@
 #include <fitsip/core/imagecollection.h>
 #include <fitsip/core/fitsobject.h>
 #include <fitsip/core/fitsimage.h>
+#include <fitsip/core/parallel.h>
 #include <cmath>
 #include <algorithm>
 #include <limits>
@@ -40,6 +41,7 @@ namespace py = pybind11;
 #endif
 
 MeasureMatch::MeasureMatch():
+  method(Fourier),
   matchFull(true),
   matchRange(100),
   subsample(1),
@@ -82,9 +84,12 @@ void MeasureMatch::bindPython(void* mod) const
       .def("shift_aoi",[](MeasureMatch& op, int dx, int dy){op.shiftAOI(dx,dy);},
         "Shift the range of interest based on the original value",py::arg("dx"),py::arg("dy"))
       .def_property_readonly("x",&MeasureMatch::getX,"x value of best match")
-      .def_property_readonly("y",&MeasureMatch::getX,"y value of best match")
-      .def_property_readonly("dx",&MeasureMatch::getX,"shift in x for best match")
-      .def_property_readonly("dy",&MeasureMatch::getX,"shift in y for best match")
+      .def_property_readonly("y",&MeasureMatch::getY,"y value of best match")
+      .def_property_readonly("dx",&MeasureMatch::getDx,"shift in x for best match")
+      .def_property_readonly("dy",&MeasureMatch::getDy,"shift in y for best match")
+      .def_property("phase_correlation",[](const MeasureMatch& op){ return op.getMethod() == MeasureMatch::Fourier; },
+                    [](MeasureMatch& op, bool flag){ op.setMethod(flag ? MeasureMatch::Fourier : MeasureMatch::Spatial); },
+                    "use FFT phase correlation instead of the spatial cross correlation")
       .def_property("match_full",&MeasureMatch::isMatchFull,&MeasureMatch::setMatchFull)
       .def_property("match_range",&MeasureMatch::getMatchRange,&MeasureMatch::setMatchRange)
       .def_property("first_pass_delta",&MeasureMatch::getFirstPassDelta,&MeasureMatch::setFirstPassDelta)
@@ -103,6 +108,7 @@ OpPlugin::ResultType MeasureMatch::execute(std::shared_ptr<FitsObject> image, co
   }
   if (dlg->exec())
   {
+    method = static_cast<Method>(dlg->getMethod());
     matchFull = dlg->isMatchFullImage();
     matchRange = dlg->getMatchRange();
     firstPassDelta = dlg->getFirstPassDelta();
@@ -140,6 +146,16 @@ void MeasureMatch::setTemplate(const FitsImage& image, QRect a)
     qWarning() << "AOI not fully contained in image! Creating intersection.";
     aoi = r.intersected(aoi);
   }
+  if (method == Fourier)
+  {
+    /* works on the original pixels, the subpixel peak replaces the scaling */
+    phase.setReference(image,aoi,matchFull ? std::max(image.getWidth(),image.getHeight()) : matchRange);
+    aoi = QRect(aoi.x()*factor,aoi.y()*factor,aoi.width()*factor,aoi.height()*factor);
+    initialAOI = aoi;
+    aoiShiftX = 0;
+    aoiShiftY = 0;
+    return;
+  }
   FitsImage img;
   if (factor > 1)
   {
@@ -151,18 +167,14 @@ void MeasureMatch::setTemplate(const FitsImage& image, QRect a)
   {
     img = image;
   }
-  R.clear();
-  for (int i=0;i<aoi.height();i++)
-  {
-    R.push_back(std::vector<ValueType>(aoi.width(),0.0));
-  }
+  R.assign(static_cast<size_t>(aoi.width())*aoi.height(),0.0);
   for (int i=0;i<aoi.width();i++)
   {
     for (int j=0;j<aoi.height();j++)
     {
       {
         double v = img.getConstPixelIterator(i+aoi.x(),j+aoi.y()).getAbs();
-        R[j][i] = v;
+        R[static_cast<size_t>(i)*aoi.height()+j] = v;
         sumR += v;
         sumR2 += v * v;
       }
@@ -180,6 +192,16 @@ void MeasureMatch::setTemplate(const FitsImage& image, QRect a)
  */
 void MeasureMatch::computeMatch(const FitsImage& image)
 {
+  if (method == Fourier)
+  {
+    phase.match(image,static_cast<int>(std::lround(aoiShiftX/static_cast<double>(factor))),static_cast<int>(std::lround(aoiShiftY/static_cast<double>(factor))));
+    max = phase.getPeak();
+    dx = phase.getDx() * factor - aoiShiftX;
+    dy = phase.getDy() * factor - aoiShiftY;
+    x = static_cast<int>(std::lround(aoi.x() + aoi.width() / 2 + dx));
+    y = static_cast<int>(std::lround(aoi.y() + aoi.height() / 2 + dy));
+    return;
+  }
   createI(image);
   int xMax = width - aoi.width();
   int yMax = height - aoi.height();
@@ -188,40 +210,60 @@ void MeasureMatch::computeMatch(const FitsImage& image)
   max = -std::numeric_limits<double>::max();
   x = -1;
   y = -1;
-  int delta = firstPassDelta;
-  for (int r=0;r<xMax;r+=delta)
-  {
-    for (int s=0;s<yMax;s+=delta)
-    {
-      double q = getMatchValue(r,s,subsample);
-      if (q > max)
+  /* The columns of offsets are searched in parallel. Every column keeps its
+     first maximum and the columns are reduced in order, so the result is
+     the same as scanning the offsets one after the other. */
+  auto search = [&](int r0, int r1, int s0, int s1, int delta, int n){
+    if (r0 >= r1 || s0 >= s1) return;
+    int columns = (r1 - r0 + delta - 1) / delta;
+    std::vector<double> best(columns,-std::numeric_limits<double>::max());
+    std::vector<int> bestS(columns,-1);
+    parallel::forRange(columns,[&](int c0, int c1){
+      for (int c=c0;c<c1;++c)
       {
-        max = q;
-        x = r + roiXC + offsetX;
-        y = s + roiYC + offsetY;
+        int r = r0 + c * delta;
+        for (int s=s0;s<s1;s+=delta)
+        {
+          double q = getMatchValue(r,s,n);
+          if (q > best[c])
+          {
+            best[c] = q;
+            bestS[c] = s;
+          }
+        }
       }
-    }
-  }
-  if (delta > 1)
-  {
-    for (int r=std::max(x-roiXC-offsetX-2*delta,0);r<std::min(x-roiXC-offsetX+2*delta,xMax);r++)
+    });
+    for (int c=0;c<columns;++c)
     {
-      for (int s=std::max(y-roiYC-offsetY-2*delta,0);s<std::min(y-roiYC-offsetY+2*delta,yMax);s++)
+      if (best[c] > max)
       {
-        double q = getMatchValue(r,s,1);
-        if (q > max)
-        {
-          max = q;
-          x = r + roiXC + offsetX;
-          y = s + roiYC + offsetY;
-        }
+        max = best[c];
+        x = r0 + c * delta + roiXC + offsetX;
+        y = bestS[c] + roiYC + offsetY;
       }
     }
+  };
+  int delta = firstPassDelta;
+  search(0,xMax,0,yMax,delta,subsample);
+  if (delta > 1)
+  {
+    search(std::max(x-roiXC-offsetX-2*delta,0),std::min(x-roiXC-offsetX+2*delta,xMax),
+           std::max(y-roiYC-offsetY-2*delta,0),std::min(y-roiYC-offsetY+2*delta,yMax),1,1);
   }
   dx = x - aoi.x() - roiXC;
   dy = y - aoi.y() - roiYC;
 }
 
+void MeasureMatch::setMethod(Method m)
+{
+  method = m;
+}
+
+MeasureMatch::Method MeasureMatch::getMethod() const
+{
+  return method;
+}
+
 void MeasureMatch::setMatchFull(bool flag)
 {
   matchFull = flag;
@@ -327,19 +369,16 @@ void MeasureMatch::createI(const FitsImage& image)
     height = std::min(aoi.height()+2*matchRange,static_cast<int>(img.getHeight())-offsetY);
     width = std::min(aoi.width()+2*matchRange,static_cast<int>(img.getWidth())-offsetX);
   }
-  I.clear();// = hmath::Matrix(height,width);
-  for (int iy=0;iy<height;iy++)
-  {
-    if (offsetY+iy < 0) continue;
-    if (offsetY+iy >= img.getHeight()) break;
-    I.push_back(std::vector<ValueType>(width,0.0));
-    for (int ix=0;ix<width;ix++)
+  I.assign(static_cast<size_t>(width)*height,0.0);
+  parallel::forRange(height,[&](int y0, int y1){
+    for (int iy=y0;iy<y1;iy++)
     {
-      if (offsetX+ix < 0) continue;
-      if (offsetX+ix >= img.getWidth()) break;
-      I[iy][ix] = img.getConstPixelIterator(offsetX+ix,offsetY+iy).getAbs();
+      if (offsetY+iy < 0 || offsetY+iy >= img.getHeight() || offsetX >= img.getWidth()) continue;
+      ValueType* p = &I[iy];
+      ConstPixelIterator it = img.getConstPixelIterator(offsetX,offsetY+iy);
+      for (int ix=0;ix<width && offsetX+ix<img.getWidth();ix++,++it) p[static_cast<size_t>(ix)*height] = it.getAbs();
     }
-  }
+  },16);
 }
 
 /**
@@ -350,17 +389,23 @@ void MeasureMatch::createI(const FitsImage& image)
  * @param n take only every n-th pixel for matching
  * @return the correlation value
  */
-double MeasureMatch::getMatchValue(int r, int s, int n)
+double MeasureMatch::getMatchValue(int r, int s, int n) const
 {
+  /* The sums are formed column by column in the original order, so the
+     match values are bit for bit the same as before; the column major
+     buffers keep the inner loop contiguous. */
   double sumI = 0;
-  double sumI2= 0;
+  double sumI2 = 0;
   double covIR = 0;
+  int h = aoi.height();
   for (int ix=0;ix<aoi.width();ix+=n)
   {
-    for (int iy=0;iy<aoi.height();iy+=n)
+    const ValueType* pI = &I[static_cast<size_t>(r+ix)*height+s];
+    const ValueType* pR = &R[static_cast<size_t>(ix)*h];
+    for (int iy=0;iy<h;iy+=n)
     {
-      double vR = R[iy][ix];
-      double vI = I[s+iy][r+ix];
+      double vR = pR[iy];
+      double vI = pI[iy];
       sumI += vI;
       sumI2 += vI * vI;
       covIR += vI * vR;
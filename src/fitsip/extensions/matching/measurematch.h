@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - plugin to match two images                                          *
  *                                                                              *
- * modified: 2025-02-08                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -23,6 +23,7 @@
 #ifndef MEASUREMATCH_H
 #define MEASUREMATCH_H
 
+#include "phasecorrelation.h"
 #include <fitsip/core/fitstypes.h>
 #include <fitsip/core/opplugin.h>
 #include <QObject>
@@ -35,6 +36,9 @@ class MeasureMatchDialog;
  *
  * It uses only the gray intensity values of both images. The location of the
  * maximum correlation is printed in the logbook.
+ * The default method is FFT phase correlation (see PhaseCorrelation), which
+ * measures the shift to subpixel accuracy. The spatial cross correlation
+ * evaluates every offset in the search range.
  * Algorithm taken from: W.Burger and M.J. Burge, Digitale Bildverarbeitung
  */
 class MeasureMatch: public OpPlugin
@@ -42,6 +46,8 @@ class MeasureMatch: public OpPlugin
   Q_OBJECT
   Q_INTERFACES(OpPlugin)
 public:
+  enum Method { Fourier, Spatial };
+
   MeasureMatch();
   virtual ~MeasureMatch() override;
 
@@ -57,6 +63,10 @@ public:
 
   void computeMatch(const FitsImage& image);
 
+  void setMethod(Method m);
+
+  Method getMethod() const;
+
   void setMatchFull(bool flag);
 
   bool isMatchFull() const;
@@ -99,22 +109,24 @@ public:
 
 private:
   void createI(const FitsImage& image);
-  double getMatchValue(int r, int s, int n);
+  double getMatchValue(int r, int s, int n) const;
 
+  Method method;
+  PhaseCorrelation phase;
   bool matchFull;
   int matchRange;
   int subsample;
   int firstPassDelta;
   int factor;
-  std::vector<std::vector<ValueType>> R;
-  std::vector<std::vector<ValueType>> I;
+  std::vector<ValueType> R;     // template, column by column
+  std::vector<ValueType> I;     // searched region of the image, column by column
   double meanR;
   double sigmaR;
   double max;
   int x;
   int y;
-  int dx;
-  int dy;
+  double dx;
+  double dy;
   int offsetX;
   int offsetY;
   int height;
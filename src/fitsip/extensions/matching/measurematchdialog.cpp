@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - dialog for plugin to match two images                               *
  *                                                                              *
- * modified: 2025-06-04                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -72,3 +72,8 @@ int MeasureMatchDialog::getSubsample() const
 {
   return ui->subsampleBox->value();
 }
+
+int MeasureMatchDialog::getMethod() const
+{
+  return ui->methodBox->currentIndex();
+}
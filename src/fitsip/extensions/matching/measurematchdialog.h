@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - dialog for plugin to match two images                               *
  *                                                                              *
- * modified: 2022-12-01                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -56,6 +56,8 @@ public:
 
   int getSubsample() const;
 
+  int getMethod() const;
+
 private:
   Ui::MeasureMatchDialog *ui;
   ImageSelectWidget *imageSelectWidget;
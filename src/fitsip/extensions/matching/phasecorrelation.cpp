@@ -0,0 +1,280 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - FFT phase correlation                                               *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "phasecorrelation.h"
+#include <fitsip/core/fitsimage.h>
+#include <fitsip/core/parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+
+/* the size of the coarsest level */
+const int maxLevelSize = 512;
+/* margin around the AOI and search range of the finer levels in binned pixels */
+const int refineMargin = 8;
+const int refineRange = 4;
+
+int nextPowerOfTwo(int n)
+{
+  int p = 1;
+  while (p < n) p *= 2;
+  return p;
+}
+
+/* in-place iterative radix-2 transform, n must be a power of 2; the inverse is not normalized */
+void fft(std::complex<double>* a, int n, bool inverse)
+{
+  for (int i=1,j=0;i<n;++i)
+  {
+    int bit = n >> 1;
+    for (;j&bit;bit>>=1) j ^= bit;
+    j ^= bit;
+    if (i < j) std::swap(a[i],a[j]);
+  }
+  for (int len=2;len<=n;len<<=1)
+  {
+    double angle = (inverse ? 2 : -2) * M_PI / len;
+    std::complex<double> wl(cos(angle),sin(angle));
+    int half = len / 2;
+    for (int i=0;i<n;i+=len)
+    {
+      std::complex<double> w(1,0);
+      for (int k=0;k<half;++k)
+      {
+        std::complex<double> u = a[i+k];
+        std::complex<double> v = a[i+k+half] * w;
+        a[i+k] = u + v;
+        a[i+k+half] = u - v;
+        w *= wl;
+      }
+    }
+  }
+}
+
+/* the rows and then the columns are transformed in parallel */
+void fft2(std::vector<std::complex<double>>& data, int width, int height, bool inverse)
+{
+  parallel::forRange(height,[&](int y0, int y1){
+    for (int y=y0;y<y1;++y) fft(&data[static_cast<size_t>(y)*width],width,inverse);
+  },8);
+  parallel::forRange(width,[&](int x0, int x1){
+    std::vector<std::complex<double>> column(height);
+    for (int x=x0;x<x1;++x)
+    {
+      for (int y=0;y<height;++y) column[y] = data[static_cast<size_t>(y)*width+x];
+      fft(column.data(),height,inverse);
+      for (int y=0;y<height;++y) data[static_cast<size_t>(y)*width+x] = column[y];
+    }
+  },8);
+}
+
+std::vector<double> hann(int n)
+{
+  std::vector<double> w(n);
+  for (int i=0;i<n;++i) w[i] = 0.5 - 0.5 * cos(2 * M_PI * (i + 0.5) / n);
+  return w;
+}
+
+/* vertex of the parabola through three equidistant values relative to the center */
+double vertex(double left, double center, double right)
+{
+  double d = left - 2 * center + right;
+  if (d >= 0) return 0;
+  return std::clamp((left - right) / (2 * d),-0.5,0.5);
+}
+
+}
+
+PhaseCorrelation::PhaseCorrelation():
+  dx(0),
+  dy(0),
+  peak(0)
+{
+}
+
+void PhaseCorrelation::setReference(const FitsImage& image, QRect aoi, int range)
+{
+  levels.clear();
+  QRect bounds(0,0,image.getWidth(),image.getHeight());
+  aoi = aoi.intersected(bounds);
+  if (aoi.isEmpty()) throw std::runtime_error("PhaseCorrelation: AOI outside of image");
+  QRect full = aoi.adjusted(-range,-range,range,range).intersected(bounds);
+  int bin = 1;
+  while (std::max(full.width(),full.height()) > maxLevelSize * bin) bin *= 2;
+  Level coarse;
+  coarse.bin = bin;
+  coarse.window = full;
+  coarse.range = range / bin + 1;
+  levels.push_back(coarse);
+  for (bin/=2;bin>=1;bin/=2)
+  {
+    Level level;
+    level.bin = bin;
+    int margin = refineMargin * bin;
+    level.window = aoi.adjusted(-margin,-margin,margin,margin).intersected(bounds);
+    level.range = refineRange;
+    levels.push_back(level);
+  }
+  for (Level& level : levels)
+  {
+    int w = level.window.width() / level.bin;
+    int h = level.window.height() / level.bin;
+    level.width = nextPowerOfTwo(w);
+    level.height = nextPowerOfTwo(h);
+    level.taperX = hann(w);
+    level.taperY = hann(h);
+    extract(image,level,0,0,level.spectrum);
+    fft2(level.spectrum,level.width,level.height,false);
+    for (auto& c : level.spectrum) c = std::conj(c);
+  }
+}
+
+void PhaseCorrelation::match(const FitsImage& image, int x0, int y0)
+{
+  if (levels.empty()) throw std::runtime_error("PhaseCorrelation: no reference set");
+  double sx = x0;
+  double sy = y0;
+  std::vector<std::complex<double>> data;
+  for (const Level& level : levels)
+  {
+    int ix = static_cast<int>(std::lround(sx));
+    int iy = static_cast<int>(std::lround(sy));
+    extract(image,level,ix,iy,data);
+    fft2(data,level.width,level.height,false);
+    /* normalized cross power spectrum */
+    for (size_t i=0;i<data.size();++i)
+    {
+      std::complex<double> c = data[i] * level.spectrum[i];
+      double m = std::abs(c);
+      data[i] = m > 1.0E-20 ? c / m : 0;
+    }
+    fft2(data,level.width,level.height,true);
+    int w = level.width;
+    int h = level.height;
+    auto at = [&](int u, int v){ return data[static_cast<size_t>((v+h)%h)*w+(u+w)%w].real(); };
+    int r = std::min(level.range,std::min(w,h)/2-1);
+    double best = -std::numeric_limits<double>::max();
+    int bu = 0;
+    int bv = 0;
+    for (int v=-r;v<=r;++v)
+    {
+      for (int u=-r;u<=r;++u)
+      {
+        double q = at(u,v);
+        if (q > best)
+        {
+          best = q;
+          bu = u;
+          bv = v;
+        }
+      }
+    }
+    double fu = vertex(at(bu-1,bv),best,at(bu+1,bv));
+    double fv = vertex(at(bu,bv-1),best,at(bu,bv+1));
+    sx = ix + (bu + fu) * level.bin;
+    sy = iy + (bv + fv) * level.bin;
+    peak = best / (static_cast<double>(w) * h);
+  }
+  dx = sx;
+  dy = sy;
+}
+
+double PhaseCorrelation::getDx() const
+{
+  return dx;
+}
+
+double PhaseCorrelation::getDy() const
+{
+  return dy;
+}
+
+double PhaseCorrelation::getPeak() const
+{
+  return peak;
+}
+
+int PhaseCorrelation::getLevelCount() const
+{
+  return static_cast<int>(levels.size());
+}
+
+/*
+ * Cuts the window of the level shifted by [x0,y0] out of the image, bins
+ * it, removes the mean and applies the taper. Pixels outside of the image
+ * are set to the mean.
+ */
+void PhaseCorrelation::extract(const FitsImage& image, const Level& level, int x0, int y0, std::vector<std::complex<double>>& data) const
+{
+  int ww = static_cast<int>(level.taperX.size());
+  int hh = static_cast<int>(level.taperY.size());
+  int left = level.window.x() + x0;
+  int top = level.window.y() + y0;
+  int bin = level.bin;
+  std::vector<double> sum(static_cast<size_t>(ww)*hh,0);
+  std::vector<int> count(sum.size(),0);
+  parallel::forRange(hh,[&](int j0, int j1){
+    int xa = std::max(left,0);
+    int xb = std::min(left+ww*bin,image.getWidth());
+    for (int j=j0;j<j1;++j)
+    {
+      for (int by=0;by<bin;++by)
+      {
+        int y = top + j * bin + by;
+        if (y < 0 || y >= image.getHeight() || xa >= xb) continue;
+        ConstPixelIterator it = image.getConstPixelIterator(xa,y);
+        for (int x=xa;x<xb;++x,++it)
+        {
+          size_t i = static_cast<size_t>(j) * ww + (x - left) / bin;
+          sum[i] += it.getAbs();
+          count[i]++;
+        }
+      }
+    }
+  },8);
+  double mean = 0;
+  int valid = 0;
+  for (size_t i=0;i<sum.size();++i)
+  {
+    if (count[i] > 0)
+    {
+      sum[i] /= count[i];
+      mean += sum[i];
+      valid++;
+    }
+  }
+  if (valid > 0) mean /= valid;
+  data.assign(static_cast<size_t>(level.width)*level.height,0);
+  for (int j=0;j<hh;++j)
+  {
+    for (int i=0;i<ww;++i)
+    {
+      size_t k = static_cast<size_t>(j) * ww + i;
+      double v = count[k] > 0 ? sum[k] - mean : 0;
+      data[static_cast<size_t>(j)*level.width+i] = v * level.taperX[i] * level.taperY[j];
+    }
+  }
+}
@@ -0,0 +1,102 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - FFT phase correlation                                               *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef PHASECORRELATION_H
+#define PHASECORRELATION_H
+
+#include <fitsip/core/fitstypes.h>
+#include <QRect>
+#include <complex>
+#include <vector>
+
+class FitsImage;
+
+/**
+ * @brief Measures the shift between two images by FFT phase correlation.
+ *
+ * The region around the AOI is cut out of the reference image, tapered by
+ * a Hann window and its spectrum is cached. A frame is matched by
+ * transforming the same region, normalizing the cross power spectrum and
+ * locating the peak of its inverse transform, which is refined to
+ * subpixel accuracy by a parabola fit.
+ *
+ * Large search regions are matched coarse to fine: the first level works
+ * on a block averaged copy of at most 512 pixels on a side, every further
+ * level halves the binning and only searches a few pixels around the
+ * shift found so far. The cost per frame is O(N log N) in the size of
+ * the region instead of O(search area x template area).
+ */
+class PhaseCorrelation
+{
+public:
+  PhaseCorrelation();
+
+  /**
+   * @brief Set the reference region.
+   * @param image the reference image
+   * @param aoi the region to align
+   * @param range the maximum shift searched in x and y
+   */
+  void setReference(const FitsImage& image, QRect aoi, int range);
+
+  /**
+   * @brief Measure the shift of an image against the reference.
+   * @param image the image to match
+   * @param x0 expected shift in x, the search is centered on it
+   * @param y0 expected shift in y, the search is centered on it
+   */
+  void match(const FitsImage& image, int x0=0, int y0=0);
+
+  double getDx() const;
+
+  double getDy() const;
+
+  /**
+   * @brief Get the height of the correlation peak.
+   * @return 1 for a perfect match down to 0 for no correlation
+   */
+  double getPeak() const;
+
+  int getLevelCount() const;
+
+private:
+  struct Level
+  {
+    int bin;                                   // binning of the level
+    QRect window;                              // region in the reference image
+    int range;                                 // search range in binned pixels
+    int width;                                 // size of the transform
+    int height;
+    std::vector<double> taperX;
+    std::vector<double> taperY;
+    std::vector<std::complex<double>> spectrum;  // conjugated reference spectrum
+  };
+
+  void extract(const FitsImage& image, const Level& level, int x0, int y0, std::vector<std::complex<double>>& data) const;
+
+  std::vector<Level> levels;
+  double dx;
+  double dy;
+  double peak;
+};
+
+#endif // PHASECORRELATION_H
@@ -0,0 +1,379 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - batch PSF fitting of stars                                          *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "psffitter.h"
+#include <fitsip/core/parallel.h>
+#include <Eigen/Dense>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace
+{
+
+  /* The cutout is limited, so the border sample fits on the stack */
+  constexpr int MAX_BOX = 63;
+
+  /*
+   * Elliptical Gaussian
+   * parameters: background, amplitude, x0, y0, a, b, c
+   */
+  struct GaussianModel
+  {
+    static constexpr int N = 7;
+    using Vector = Eigen::Matrix<double,N,1>;
+
+    static Vector initialize(const Eigen::Matrix<double,7,1>& g)
+    {
+      return g;
+    }
+
+    static double evaluate(const Vector& p, double x, double y, Vector& j)
+    {
+      double dx = x - p[2];
+      double dy = y - p[3];
+      double e = exp(-0.5*(p[4]*dx*dx+2*p[5]*dx*dy+p[6]*dy*dy));
+      double ae = p[1] * e;
+      j << 1, e, ae*(p[4]*dx+p[5]*dy), ae*(p[5]*dx+p[6]*dy), -0.5*ae*dx*dx, -ae*dx*dy, -0.5*ae*dy*dy;
+      return p[0] + ae;
+    }
+
+    static bool isValid(const Vector& p)
+    {
+      return p[1] > 0 && p[4] > 0 && p[6] > 0 && p[4]*p[6] > p[5]*p[5];
+    }
+
+    static double getBeta(const Vector& /*p*/)
+    {
+      return 0;
+    }
+
+    /* value of the quadratic form at half maximum */
+    static double getHalfMaximum(const Vector& /*p*/)
+    {
+      return 2 * M_LN2;
+    }
+  };
+
+  /*
+   * Elliptical Moffat profile
+   * parameters: background, amplitude, x0, y0, a, b, c, beta
+   */
+  struct MoffatModel
+  {
+    static constexpr int N = 8;
+    using Vector = Eigen::Matrix<double,N,1>;
+
+    /* starts with beta=3 and the FWHM of the gaussian guess */
+    static Vector initialize(const Eigen::Matrix<double,7,1>& g)
+    {
+      const double beta = 3;
+      double scale = (pow(2,1/beta)-1) / (2*M_LN2);
+      Vector p;
+      p << g[0], g[1], g[2], g[3], g[4]*scale, g[5]*scale, g[6]*scale, beta;
+      return p;
+    }
+
+    static double evaluate(const Vector& p, double x, double y, Vector& j)
+    {
+      double dx = x - p[2];
+      double dy = y - p[3];
+      double u = 1 + p[4]*dx*dx + 2*p[5]*dx*dy + p[6]*dy*dy;
+      double lu = log(u);
+      double v = exp(-p[7]*lu);
+      double t = p[1] * v;
+      double s = p[7] * t / u;
+      j << 1, v, 2*s*(p[4]*dx+p[5]*dy), 2*s*(p[5]*dx+p[6]*dy), -s*dx*dx, -2*s*dx*dy, -s*dy*dy, -t*lu;
+      return p[0] + t;
+    }
+
+    static bool isValid(const Vector& p)
+    {
+      return p[1] > 0 && p[4] > 0 && p[6] > 0 && p[4]*p[6] > p[5]*p[5] && p[7] > 0.5 && p[7] < 50;
+    }
+
+    static double getBeta(const Vector& p)
+    {
+      return p[7];
+    }
+
+    static double getHalfMaximum(const Vector& p)
+    {
+      return pow(2,1/p[7]) - 1;
+    }
+  };
+
+  struct Cutout
+  {
+    const ValueType* data;
+    int width;                         // row stride
+    int x0;
+    int y0;
+    int x1;                            // exclusive
+    int y1;
+
+    int size() const
+    {
+      return (x1 - x0) * (y1 - y0);
+    }
+  };
+
+  /*
+   * Builds the normal equations J^T J and J^T r at p.
+   * Returns the sum of the squared residuals.
+   */
+  template <class M>
+  double normalEquations(const Cutout& c, const typename M::Vector& p,
+                         Eigen::Matrix<double,M::N,M::N>& jtj, typename M::Vector& jtr)
+  {
+    typename M::Vector j;
+    jtj.setZero();
+    jtr.setZero();
+    double chisq = 0;
+    for (int y=c.y0;y<c.y1;++y)
+    {
+      const ValueType* row = c.data + static_cast<size_t>(y) * c.width;
+      for (int x=c.x0;x<c.x1;++x)
+      {
+        double r = row[x] - M::evaluate(p,x,y,j);
+        jtj.template selfadjointView<Eigen::Lower>().rankUpdate(j);
+        jtr += r * j;
+        chisq += r * r;
+      }
+    }
+    jtj.template triangularView<Eigen::StrictlyUpper>() = jtj.transpose();
+    return chisq;
+  }
+
+  /*
+   * Levenberg-Marquardt with the damping scaled by the diagonal of J^T J.
+   * Returns true if converged; p holds the best parameters found.
+   */
+  template <class M>
+  bool levenbergMarquardt(const Cutout& c, typename M::Vector& p, int maxIterations, int& iterations, double& chisq)
+  {
+    using Vector = typename M::Vector;
+    using Matrix = Eigen::Matrix<double,M::N,M::N>;
+    Matrix jtj;
+    Vector jtr;
+    chisq = normalEquations<M>(c,p,jtj,jtr);
+    double lambda = 1.0e-3;
+    for (iterations=1;iterations<=maxIterations;++iterations)
+    {
+      Matrix a = jtj;
+      a.diagonal() += lambda * jtj.diagonal().cwiseMax(1.0e-12);
+      Vector trial = p + a.ldlt().solve(jtr);
+      Matrix jtj1;
+      Vector jtr1;
+      double chisq1 = M::isValid(trial) ? normalEquations<M>(c,trial,jtj1,jtr1) : chisq;
+      if (chisq1 < chisq)
+      {
+        bool done = chisq - chisq1 <= 1.0e-8 * chisq;
+        p = trial;
+        chisq = chisq1;
+        jtj = jtj1;
+        jtr = jtr1;
+        if (done) return true;
+        lambda = std::max(lambda/10,1.0e-12);
+      }
+      else
+      {
+        /* no step downhill even with strong damping: at the minimum */
+        lambda *= 10;
+        if (lambda > 1.0e10) return true;
+      }
+    }
+    return false;
+  }
+
+  /*
+   * Initial gaussian parameters from the moments of the cutout. The
+   * background is the median of the border pixels.
+   */
+  bool guess(const Cutout& c, Eigen::Matrix<double,7,1>& g)
+  {
+    std::array<double,4*MAX_BOX> border{};
+    size_t n = 0;
+    double peak = -std::numeric_limits<double>::max();
+    for (int y=c.y0;y<c.y1;++y)
+    {
+      const ValueType* row = c.data + static_cast<size_t>(y) * c.width;
+      for (int x=c.x0;x<c.x1;++x)
+      {
+        peak = std::max(peak,static_cast<double>(row[x]));
+        if ((y == c.y0 || y == c.y1-1 || x == c.x0 || x == c.x1-1) && n < border.size()) border[n++] = row[x];
+      }
+    }
+    std::nth_element(border.begin(),border.begin()+n/2,border.begin()+n);
+    double background = border[n/2];
+    double amplitude = peak - background;
+    if (amplitude <= 0) return false;
+    /* pixels above a quarter of the peak, so the noise does not widen the moments */
+    double threshold = background + 0.25 * amplitude;
+    double sum = 0, sx = 0, sy = 0, sxx = 0, sxy = 0, syy = 0;
+    for (int y=c.y0;y<c.y1;++y)
+    {
+      const ValueType* row = c.data + static_cast<size_t>(y) * c.width;
+      for (int x=c.x0;x<c.x1;++x)
+      {
+        if (row[x] <= threshold) continue;
+        double w = row[x] - background;
+        sum += w;
+        sx += w * x;
+        sy += w * y;
+        sxx += w * x * x;
+        sxy += w * x * y;
+        syy += w * y * y;
+      }
+    }
+    double xc = sx / sum;
+    double yc = sy / sum;
+    double vxx = sxx / sum - xc * xc;
+    double vxy = sxy / sum - xc * yc;
+    double vyy = syy / sum - yc * yc;
+    double det = vxx * vyy - vxy * vxy;
+    if (vxx <= 0.1 || vyy <= 0.1 || det <= 0.01)
+    {
+      /* too few pixels; a star of 2 pixel sigma */
+      vxx = 4;
+      vyy = 4;
+      vxy = 0;
+      det = 16;
+    }
+    g << background, amplitude, xc, yc, vyy/det, -vxy/det, vxx/det;
+    return true;
+  }
+
+  template <class M>
+  PSFFitter::Result fitModel(const Cutout& c, int maxIterations)
+  {
+    PSFFitter::Result result;
+    Eigen::Matrix<double,7,1> g;
+    if (!guess(c,g)) return result;
+    typename M::Vector p = M::initialize(g);
+    double chisq;
+    result.converged = levenbergMarquardt<M>(c,p,maxIterations,result.iterations,chisq);
+    result.background = p[0];
+    result.amplitude = p[1];
+    result.x = p[2];
+    result.y = p[3];
+    result.beta = M::getBeta(p);
+    result.rms = sqrt(chisq/c.size());
+    /* the axes of the ellipse from the eigenvalues of the quadratic form */
+    double m = 0.5 * (p[4] + p[6]);
+    double d = sqrt(0.25*(p[4]-p[6])*(p[4]-p[6])+p[5]*p[5]);
+    double lmin = m - d;
+    double lmax = m + d;
+    if (lmin <= 0)
+    {
+      result.converged = false;
+      return result;
+    }
+    double h = M::getHalfMaximum(p);
+    result.fwhmMajor = 2 * sqrt(h/lmin);
+    result.fwhmMinor = 2 * sqrt(h/lmax);
+    result.fwhm = sqrt(result.fwhmMajor*result.fwhmMinor);
+    result.ellipticity = 1 - result.fwhmMinor / result.fwhmMajor;
+    double angle = 0.5 * atan2(2*p[5],p[4]-p[6]) * 180 / M_PI + 90;
+    result.angle = angle > 90 ? angle - 180 : angle;
+    /* a center outside of the cutout is not a fit of this star */
+    if (result.x < c.x0 || result.x >= c.x1 || result.y < c.y0 || result.y >= c.y1) result.converged = false;
+    return result;
+  }
+
+}
+
+PSFFitter::PSFFitter(Model model):
+  model(model),
+  boxSize(15),
+  maxIterations(50)
+{
+}
+
+PSFFitter::Model PSFFitter::getModel(const QString& name)
+{
+  if (name == "gaussian") return Gaussian;
+  if (name == "moffat") return Moffat;
+  throw std::invalid_argument("unknown PSF model '"+name.toStdString()+"'");
+}
+
+void PSFFitter::setModel(Model m)
+{
+  model = m;
+}
+
+PSFFitter::Model PSFFitter::getModel() const
+{
+  return model;
+}
+
+void PSFFitter::setBoxSize(int size)
+{
+  boxSize = std::clamp(size|1,5,MAX_BOX);
+}
+
+int PSFFitter::getBoxSize() const
+{
+  return boxSize;
+}
+
+void PSFFitter::setMaxIterations(int n)
+{
+  maxIterations = std::max(1,n);
+}
+
+PSFFitter::Result PSFFitter::fit(const FitsImage& image, const QPointF& position) const
+{
+  return fit(image.getLayer(0).getData(),image.getWidth(),image.getHeight(),position);
+}
+
+std::vector<PSFFitter::Result> PSFFitter::fit(const FitsImage& image, const std::vector<QPointF>& positions) const
+{
+  FitsImage gray = image.getDepth() > 1 ? image.toGray() : FitsImage();
+  const FitsImage& source = gray ? gray : image;
+  const ValueType* data = source.getLayer(0).getData();
+  std::vector<Result> results(positions.size());
+  parallel::forRange(static_cast<int>(positions.size()),[&](int i0, int i1){
+    for (int i=i0;i<i1;++i) results[i] = fit(data,source.getWidth(),source.getHeight(),positions[i]);
+  },16);
+  return results;
+}
+
+PSFFitter::Result PSFFitter::fit(const ValueType* data, int width, int height, const QPointF& position) const
+{
+  int half = boxSize / 2;
+  int xc = static_cast<int>(floor(position.x()+0.5));
+  int yc = static_cast<int>(floor(position.y()+0.5));
+  Cutout c{data,width,std::max(0,xc-half),std::max(0,yc-half),std::min(width,xc+half+1),std::min(height,yc+half+1)};
+  /* stars at the border are fitted on the remaining part of the cutout */
+  if (c.x1-c.x0 < 5 || c.y1-c.y0 < 5) return Result();
+  switch (model)
+  {
+    case Gaussian:
+      return fitModel<GaussianModel>(c,maxIterations);
+    case Moffat:
+      return fitModel<MoffatModel>(c,maxIterations);
+  }
+  return Result();
+}
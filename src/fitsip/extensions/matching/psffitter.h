@@ -0,0 +1,117 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - batch PSF fitting of stars                                          *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef PSFFITTER_H
+#define PSFFITTER_H
+
+#include <fitsip/core/fitsimage.h>
+#include <QPointF>
+#include <QString>
+#include <vector>
+
+/**
+ * @brief Fits elliptical PSF models to many stars of an image.
+ *
+ * The models are a constant background plus
+ * - Gaussian: A exp(-q/2),
+ * - Moffat: A (1+q)^-beta,
+ *
+ * with q = a dx^2 + 2b dx dy + c dy^2 and dx, dy relative to the center.
+ * The quadratic form describes the ellipse in any orientation.
+ *
+ * Every star is fitted by Levenberg-Marquardt on a square cutout around its
+ * position. The Jacobians are analytic and the normal equations use fixed
+ * size matrices of the number of model parameters, so a fit needs no heap
+ * allocation. The stars are fitted in parallel.
+ */
+class PSFFitter
+{
+public:
+  enum Model { Gaussian, Moffat };
+
+  struct Result
+  {
+    bool converged = false;
+    int iterations = 0;
+    double x = 0;                    // center
+    double y = 0;
+    double background = 0;
+    double amplitude = 0;
+    double beta = 0;                 // Moffat exponent, 0 for Gaussian
+    double fwhmMajor = 0;            // FWHM along the major axis
+    double fwhmMinor = 0;            // FWHM along the minor axis
+    double angle = 0;                // direction of the major axis in degrees
+    double fwhm = 0;                 // geometric mean of major and minor FWHM
+    double ellipticity = 0;          // 1 - minor/major
+    double rms = 0;                  // RMS of the residuals
+  };
+
+  explicit PSFFitter(Model model=Gaussian);
+
+  /**
+   * @brief Get the model for a name used in parameters.
+   *
+   * Throws a std::invalid_argument for unknown names.
+   * @param name gaussian or moffat
+   * @return the model
+   */
+  static Model getModel(const QString& name);
+
+  void setModel(Model m);
+
+  Model getModel() const;
+
+  /**
+   * @brief Set the size of the cutout around a star.
+   * @param size the edge length in pixel, made odd (default 15)
+   */
+  void setBoxSize(int size);
+
+  int getBoxSize() const;
+
+  void setMaxIterations(int n);
+
+  /**
+   * @brief Fit the PSF of a single star.
+   * @param image the image, only the first layer is used
+   * @param position the approximate center of the star
+   * @return the fit result
+   */
+  Result fit(const FitsImage& image, const QPointF& position) const;
+
+  /**
+   * @brief Fit the PSFs of many stars in parallel.
+   * @param image the image, converted to gray
+   * @param positions the approximate centers of the stars
+   * @return the results in the order of the positions
+   */
+  std::vector<Result> fit(const FitsImage& image, const std::vector<QPointF>& positions) const;
+
+private:
+  Result fit(const ValueType* data, int width, int height, const QPointF& position) const;
+
+  Model model;
+  int boxSize;
+  int maxIterations;
+};
+
+#endif // PSFFITTER_H
@@ -0,0 +1,361 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - batch star cataloguing with sidecar cache                           *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "starcatalog.h"
+#include "findstars.h"
+#include <fitsip/core/backgroundmap.h>
+#include <fitsip/core/parallel.h>
+#include <fitsip/core/io/framesequence.h>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDebug>
+#include <QFile>
+#include <QSaveFile>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+static const quint32 SIDECAR_MAGIC = 0x46495053;   // "FIPS"
+static const quint32 SIDECAR_VERSION = 2;
+
+StarCatalog::StarCatalog():
+  threshold(3.0),
+  blur(false),
+  psfFit(false),
+  psfModel(PSFFitter::Moffat),
+  cache(true),
+  hits(0),
+  misses(0)
+{
+}
+
+void StarCatalog::setThreshold(double sigma)
+{
+  threshold = sigma;
+}
+
+void StarCatalog::setBlur(bool flag)
+{
+  blur = flag;
+}
+
+void StarCatalog::setPSFFit(bool flag, PSFFitter::Model model)
+{
+  psfFit = flag;
+  psfModel = model;
+}
+
+void StarCatalog::setCacheEnabled(bool flag)
+{
+  cache = flag;
+}
+
+QByteArray StarCatalog::getParameterHash() const
+{
+  FindStars finder;
+  finder.setThreshold(threshold);
+  finder.setBlur(blur);
+  BackgroundMap map;
+  PSFFitter fitter(psfModel);
+  QString key = QString("catalog=%1 %2 mesh=%3 filter=%4").arg(SIDECAR_VERSION).arg(finder.getParameterKey())
+      .arg(map.getMeshSize()).arg(map.getFilterSize());
+  if (psfFit) key += QString(" psf=%1 box=%2").arg(psfModel).arg(fitter.getBoxSize());
+  return QCryptographicHash::hash(key.toUtf8(),QCryptographicHash::Sha1);
+}
+
+StarCatalog::Catalog StarCatalog::detect(const FitsImage& image) const
+{
+  FitsImage gray = image.toGray();
+  BackgroundMap map;
+  map.build(gray);
+  FindStars finder;
+  finder.setThreshold(threshold);
+  finder.setBlur(blur);
+  finder.setBackground(map.getBackground(),map.getRMS());
+  int w = gray.getWidth();
+  int h = gray.getHeight();
+  const ValueType* p = gray.getLayer(0).getData();
+  const ValueType* b = map.getBackground().getLayer(0).getData();
+  Catalog catalog;
+  std::vector<Star> stars = finder.findStars(gray);
+  std::vector<PSFFitter::Result> fits;
+  if (psfFit)
+  {
+    std::vector<QPointF> positions;
+    for (const Star& star : stars) positions.emplace_back(star.getX(),star.getY());
+    fits = PSFFitter(psfModel).fit(gray,positions);
+  }
+  for (size_t i=0;i<stars.size();++i)
+  {
+    Star star = stars[i];
+    float ellipticity = 0;
+    if (psfFit)
+    {
+      /* the fit replaces the moments, if it stayed close to the detection */
+      const PSFFitter::Result& fit = fits[i];
+      if (fit.converged && std::hypot(fit.x-star.getX(),fit.y-star.getY()) < 2)
+      {
+        star = Star(fit.x,fit.y,fit.fwhm,fit.fwhmMajor,fit.fwhmMinor,star.getRoundness(),star.getSharpness(),star.getHotness());
+        ellipticity = static_cast<float>(fit.ellipticity);
+      }
+    }
+    /* the flux is summed in a circular aperture of 1.5 FWHM */
+    double r = std::max(2.0,1.5*star.getFWHM());
+    int x0 = std::max(0,static_cast<int>(floor(star.getX()-r)));
+    int x1 = std::min(w-1,static_cast<int>(ceil(star.getX()+r)));
+    int y0 = std::max(0,static_cast<int>(floor(star.getY()-r)));
+    int y1 = std::min(h-1,static_cast<int>(ceil(star.getY()+r)));
+    double flux = 0;
+    for (int y=y0;y<=y1;++y)
+    {
+      double dy = y - star.getY();
+      for (int x=x0;x<=x1;++x)
+      {
+        double dx = x - star.getX();
+        if (dx*dx+dy*dy <= r*r) flux += p[y*w+x] - b[y*w+x];
+      }
+    }
+    catalog.push_back({star.getX(),star.getY(),static_cast<float>(flux),static_cast<float>(star.getFWHM()),
+                       static_cast<float>(star.getRoundness()),static_cast<float>(star.getSharpness()),ellipticity});
+  }
+  return catalog;
+}
+
+StarCatalog::Catalog StarCatalog::get(const FrameSequence& frames, size_t index)
+{
+  const QFileInfo& file = frames.getFileInfo(index);
+  if (!cache || file.filePath().isEmpty()) return detect(frames.getImage(index));
+  Key key(getParameterHash(),frames.getFrameIndex(index));
+  {
+    QMutexLocker lock(&mutex);
+    Sidecar sidecar = load(file);
+    auto it = sidecar.catalogs.find(key);
+    if (it != sidecar.catalogs.end())
+    {
+      ++hits;
+      return it->second;
+    }
+  }
+  Catalog catalog = detect(frames.getImage(index));
+  QMutexLocker lock(&mutex);
+  ++misses;
+  /* loaded again, the catalogs of other frames may have been added meanwhile */
+  Sidecar sidecar = load(file);
+  sidecar.catalogs[key] = catalog;
+  save(file,sidecar);
+  return catalog;
+}
+
+std::vector<StarCatalog::Catalog> StarCatalog::catalogue(const FrameSequence& frames, const std::function<void(size_t)>& progress)
+{
+  const size_t none = static_cast<size_t>(-1);
+  QByteArray params = getParameterHash();
+  std::vector<Catalog> catalogs(frames.size());
+  /* the distinct files of the sequence; a video holds many frames */
+  std::vector<QFileInfo> files;
+  std::vector<size_t> fileOf(frames.size(),none);
+  if (cache)
+  {
+    std::map<QString,size_t> fileIndex;
+    for (size_t i=0;i<frames.size();++i)
+    {
+      const QFileInfo& file = frames.getFileInfo(i);
+      if (file.filePath().isEmpty()) continue;
+      auto it = fileIndex.emplace(file.absoluteFilePath(),files.size()).first;
+      if (it->second == files.size()) files.push_back(file);
+      fileOf[i] = it->second;
+    }
+  }
+  QMutexLocker lock(&mutex);
+  std::vector<Sidecar> sidecars(files.size());
+  std::vector<char> loaded(files.size(),0);
+  parallel::forRange(static_cast<int>(files.size()),[&](int i0, int i1){
+    for (int i=i0;i<i1;++i)
+    {
+      try
+      {
+        sidecars[i] = load(files[i]);
+        loaded[i] = 1;
+      }
+      catch (const std::exception& ex)
+      {
+        qWarning() << ex.what();
+      }
+    }
+  });
+  std::vector<size_t> missing;
+  for (size_t i=0;i<frames.size();++i)
+  {
+    if (fileOf[i] != none && loaded[fileOf[i]])
+    {
+      const auto& stored = sidecars[fileOf[i]].catalogs;
+      auto it = stored.find(Key(params,frames.getFrameIndex(i)));
+      if (it != stored.end())
+      {
+        catalogs[i] = it->second;
+        continue;
+      }
+    }
+    missing.push_back(i);
+  }
+  hits += frames.size() - missing.size();
+  misses += missing.size();
+  lock.unlock();
+  /* the detection of the missing frames runs without the lock */
+  std::atomic<size_t> done(frames.size()-missing.size());
+  if (progress && done > 0) progress(done);
+  std::vector<char> detected(missing.size(),0);
+  parallel::forRange(static_cast<int>(missing.size()),[&](int k0, int k1){
+    for (int k=k0;k<k1;++k)
+    {
+      try
+      {
+        catalogs[missing[k]] = detect(frames.getImage(missing[k]));
+        detected[k] = 1;
+      }
+      catch (const std::exception& ex)
+      {
+        qWarning() << ex.what();
+      }
+      if (progress) progress(++done);
+    }
+  });
+  lock.relock();
+  std::vector<char> changed(files.size(),0);
+  for (size_t k=0;k<missing.size();++k)
+  {
+    size_t i = missing[k];
+    if (!detected[k] || fileOf[i] == none || !loaded[fileOf[i]]) continue;
+    sidecars[fileOf[i]].catalogs[Key(params,frames.getFrameIndex(i))] = catalogs[i];
+    changed[fileOf[i]] = 1;
+  }
+  parallel::forRange(static_cast<int>(files.size()),[&](int i0, int i1){
+    for (int i=i0;i<i1;++i)
+    {
+      if (changed[i]) save(files[i],sidecars[i]);
+    }
+  });
+  return catalogs;
+}
+
+QString StarCatalog::getSidecarName(const QFileInfo& file)
+{
+  return file.absoluteFilePath() + ".stars";
+}
+
+QByteArray StarCatalog::getFileHash(const QFileInfo& file)
+{
+  QFile f(file.absoluteFilePath());
+  if (!f.open(QIODevice::ReadOnly)) throw std::runtime_error("Cannot read "+file.absoluteFilePath().toStdString());
+  QCryptographicHash hash(QCryptographicHash::Sha1);
+  if (!hash.addData(&f)) throw std::runtime_error("Cannot read "+file.absoluteFilePath().toStdString());
+  return hash.result();
+}
+
+uint64_t StarCatalog::getHits() const
+{
+  QMutexLocker lock(&mutex);
+  return hits;
+}
+
+uint64_t StarCatalog::getMisses() const
+{
+  QMutexLocker lock(&mutex);
+  return misses;
+}
+
+/*
+ * Reads the sidecar of a file and checks it against the file. The file is
+ * only hashed if its size or modification time changed; the catalogs are
+ * dropped if the content changed.
+ */
+StarCatalog::Sidecar StarCatalog::load(const QFileInfo& file) const
+{
+  QFileInfo info(file.absoluteFilePath());
+  qint64 filesize = info.size();
+  qint64 modified = info.lastModified().toMSecsSinceEpoch();
+  Sidecar sidecar;
+  bool valid = read(getSidecarName(info),sidecar);
+  if (valid && sidecar.filesize == filesize && sidecar.modified == modified) return sidecar;
+  QByteArray hash = getFileHash(info);
+  if (!valid || sidecar.hash != hash) sidecar.catalogs.clear();
+  sidecar.filesize = filesize;
+  sidecar.modified = modified;
+  sidecar.hash = hash;
+  return sidecar;
+}
+
+/*
+ * Writes a sidecar. The cache is optional, so files which cannot be
+ * written (e.g. in read only directories) are only reported.
+ */
+void StarCatalog::save(const QFileInfo& file, const Sidecar& sidecar) const
+{
+  QSaveFile f(getSidecarName(file));
+  if (!f.open(QIODevice::WriteOnly))
+  {
+    qWarning() << "Cannot write" << f.fileName();
+    return;
+  }
+  QDataStream s(&f);
+  s.setVersion(QDataStream::Qt_5_12);
+  s << SIDECAR_MAGIC << SIDECAR_VERSION << sidecar.filesize << sidecar.modified << sidecar.hash
+    << static_cast<quint32>(sidecar.catalogs.size());
+  for (const auto& entry : sidecar.catalogs)
+  {
+    s << entry.first.first << static_cast<qint32>(entry.first.second) << static_cast<quint32>(entry.second.size());
+    for (const Entry& star : entry.second)
+    {
+      s << star.x << star.y << star.flux << star.fwhm << star.roundness << star.sharpness << star.ellipticity;
+    }
+  }
+  if (s.status() != QDataStream::Ok || !f.commit()) qWarning() << "Cannot write" << f.fileName();
+}
+
+bool StarCatalog::read(const QString& filename, Sidecar& sidecar)
+{
+  QFile f(filename);
+  if (!f.open(QIODevice::ReadOnly)) return false;
+  QDataStream s(&f);
+  s.setVersion(QDataStream::Qt_5_12);
+  quint32 magic, version, n;
+  s >> magic >> version;
+  if (s.status() != QDataStream::Ok || magic != SIDECAR_MAGIC || version != SIDECAR_VERSION) return false;
+  s >> sidecar.filesize >> sidecar.modified >> sidecar.hash >> n;
+  for (quint32 i=0;i<n && s.status()==QDataStream::Ok;++i)
+  {
+    QByteArray params;
+    qint32 frame;
+    quint32 count;
+    s >> params >> frame >> count;
+    if (s.status() != QDataStream::Ok || count > (f.size()-f.pos())/56) return false;
+    Catalog& catalog = sidecar.catalogs[Key(params,frame)];
+    catalog.resize(count);
+    for (Entry& star : catalog)
+    {
+      s >> star.x >> star.y >> star.flux >> star.fwhm >> star.roundness >> star.sharpness >> star.ellipticity;
+    }
+  }
+  return s.status() == QDataStream::Ok;
+}
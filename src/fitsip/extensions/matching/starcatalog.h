@@ -0,0 +1,188 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - batch star cataloguing with sidecar cache                           *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef STARCATALOG_H
+#define STARCATALOG_H
+
+#include "psffitter.h"
+#include <fitsip/core/fitsimage.h>
+#include <QByteArray>
+#include <QFileInfo>
+#include <QMutex>
+#include <QString>
+#include <functional>
+#include <map>
+#include <utility>
+#include <vector>
+
+class FrameSequence;
+
+/**
+ * @brief Star catalogs of frames, cached in sidecar files.
+ *
+ * The stars are detected with FindStars on the gray image after the
+ * subtraction of a background map. Optionally a PSF is fitted to every
+ * star (see PSFFitter); the fit then gives position, FWHM and
+ * ellipticity. The catalog of a frame is stored in a
+ * sidecar file next to its image (the file name with ".stars" appended),
+ * so alignment, quality ranking and photometry can read the catalogs
+ * instead of detecting the stars again.
+ *
+ * A sidecar holds the SHA-1 hash of the image file and the catalogs of
+ * all frames (videos have several) for every set of detection parameters,
+ * keyed by a hash of the parameters. Size and modification time of the
+ * file are kept for a quick check; only if they differ the file is hashed
+ * again, so a touched or copied file keeps its catalogs while a modified
+ * one loses them.
+ *
+ * Frames of images in memory have no file and are never cached.
+ *
+ * All methods are thread safe.
+ */
+class StarCatalog
+{
+public:
+  struct Entry
+  {
+    double x;
+    double y;
+    float flux;                      // aperture sum above the background
+    float fwhm;
+    float roundness;
+    float sharpness;
+    float ellipticity;               // of the fitted PSF, 0 without fit
+  };
+
+  using Catalog = std::vector<Entry>;
+
+  StarCatalog();
+
+  /**
+   * @brief Set the detection threshold.
+   * @param sigma the minimum number of standard deviations above the background (default 3)
+   */
+  void setThreshold(double sigma);
+
+  /**
+   * @brief Convolve the images with a gaussian before the detection.
+   * @param flag true to convolve (default false)
+   */
+  void setBlur(bool flag);
+
+  /**
+   * @brief Fit a PSF to every detected star.
+   * @param flag true to fit (default false)
+   * @param model the model of the PSF
+   */
+  void setPSFFit(bool flag, PSFFitter::Model model=PSFFitter::Moffat);
+
+  /**
+   * @brief Use the sidecar files.
+   * @param flag false to always detect the stars (default true)
+   */
+  void setCacheEnabled(bool flag);
+
+  /**
+   * @brief Get the hash of the detection parameters.
+   * @return the key of the catalogs in the sidecar files
+   */
+  QByteArray getParameterHash() const;
+
+  /**
+   * @brief Detect the stars of an image.
+   * @param image the image
+   * @return the catalog
+   */
+  Catalog detect(const FitsImage& image) const;
+
+  /**
+   * @brief Get the catalog of a frame.
+   *
+   * The catalog is read from the sidecar file if present, otherwise it is
+   * detected and stored. Throws a std::runtime_error if the frame cannot be
+   * read. Every call reads and may rewrite the whole sidecar, so the frames
+   * of a sequence should be catalogued at once by catalogue().
+   * @param frames the sequence
+   * @param index the index of the frame in the sequence
+   * @return the catalog
+   */
+  Catalog get(const FrameSequence& frames, size_t index);
+
+  /**
+   * @brief Get the catalogs of all frames of a sequence.
+   *
+   * The frames missing in the sidecar files are detected in parallel, and
+   * every sidecar is written once. Frames which cannot be read get an
+   * empty catalog.
+   * @param frames the sequence
+   * @param progress called with the number of processed frames (from any thread)
+   * @return the catalogs in the order of the sequence
+   */
+  std::vector<Catalog> catalogue(const FrameSequence& frames, const std::function<void(size_t)>& progress=nullptr);
+
+  /**
+   * @brief Get the name of the sidecar file of an image file.
+   * @param file the image file
+   * @return the path of the sidecar
+   */
+  static QString getSidecarName(const QFileInfo& file);
+
+  /**
+   * @brief Calculate the hash of the content of a file.
+   *
+   * Throws a std::runtime_error if the file cannot be read.
+   * @param file the file
+   * @return the SHA-1 hash
+   */
+  static QByteArray getFileHash(const QFileInfo& file);
+
+  uint64_t getHits() const;
+
+  uint64_t getMisses() const;
+
+private:
+  /* key: parameter hash and frame index (-1 for images) */
+  using Key = std::pair<QByteArray,int>;
+
+  struct Sidecar
+  {
+    qint64 filesize = 0;
+    qint64 modified = 0;
+    QByteArray hash;
+    std::map<Key,Catalog> catalogs;
+  };
+
+  Sidecar load(const QFileInfo& file) const;
+  void save(const QFileInfo& file, const Sidecar& sidecar) const;
+  static bool read(const QString& filename, Sidecar& sidecar);
+
+  double threshold;
+  bool blur;
+  bool psfFit;
+  PSFFitter::Model psfModel;
+  bool cache;
+  mutable QMutex mutex;              // serializes the sidecar access
+  uint64_t hits;
+  uint64_t misses;
+};
+
+#endif // STARCATALOG_H
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - plugin to match two images based on stars                           *
  *                                                                              *
- * modified: 2025-10-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -22,11 +22,13 @@
 
 #include "starmatcher.h"
 #include "starmatcherdialog.h"
+#include <fitsip/core/backgroundmap.h>
 #include <fitsip/core/imagecollection.h>
 #include <fitsip/core/fitsobject.h>
 #include <fitsip/core/fitsimage.h>
 #include <cmath>
 #include <algorithm>
+#include <stdexcept>
 #include <QDebug>
 
 #ifdef USE_PYTHON
@@ -43,7 +45,8 @@ StarMatcher::StarMatcher():
   searchbox(100),
   starbox(20),
   maxmove(20),
-  rotate(false)
+  rotate(false),
+  asterismMode(false)
 {
 }
 
@@ -88,10 +91,28 @@ OpPlugin::ResultType StarMatcher::execute(std::shared_ptr<FitsObject> image, con
 OpPlugin::ResultType StarMatcher::prepare(const FitsImage& image, PixelList* pixellist, bool subsky, int searchbox, int starbox, bool rotate, double maxmove)
 {
   this->subsky = subsky;
-  if (pixellist->getPixels().empty())
+  /* without selected stars the images are matched by asterisms */
+  asterismMode = !pixellist || pixellist->getPixels().empty();
+  if (asterismMode)
   {
-    qWarning() << "No stars selected for star matching";
-    return ERROR;
+    this->rotate = rotate;
+    std::vector<AsterismMatcher::Point> catalog;
+    try
+    {
+      catalog = findCatalog(image.toGray());
+    }
+    catch (const std::exception& ex)
+    {
+      qWarning() << ex.what();
+      return ERROR;
+    }
+    if (catalog.size() < 4)
+    {
+      qWarning() << "Not enough stars found for star matching";
+      return ERROR;
+    }
+    asterism.setReference(catalog);
+    return OK;
   }
   if (searchbox <= 0)
   {
@@ -129,6 +150,13 @@ OpPlugin::ResultType StarMatcher::match(const FitsImage& image)
   sigmadx = 0;
   dy = 0;
   sigmady = 0;
+  if (asterismMode)
+  {
+    auto img = image.toGray();
+    ResultType ret = matchAsterism(findCatalog(img),img.getWidth(),img.getHeight());
+    if (ret != OK) qWarning() << img.getName() << "could not be matched by asterisms";
+    return ret;
+  }
   /* save starlist of last image */
   StarList last;
   last.setStars(starlist2.getStars());
@@ -178,6 +206,17 @@ OpPlugin::ResultType StarMatcher::match(const FitsImage& image)
   return OK;
 }
 
+void StarMatcher::setModel(AsterismMatcher::Model model)
+{
+  if (model != AsterismMatcher::Similarity) throw std::invalid_argument("star matching aligns by rotation and shift and supports only the similarity model");
+  asterism.setModel(model);
+}
+
+bool StarMatcher::isAsterismMatch() const
+{
+  return asterismMode;
+}
+
 double StarMatcher::getAngle() const
 {
   return angle;
@@ -214,6 +253,104 @@ double StarMatcher::getSigmady() const
 
 
 
+OpPlugin::ResultType StarMatcher::prepare(const StarCatalog::Catalog& catalog, bool rotate)
+{
+  asterismMode = true;
+  this->rotate = rotate;
+  if (catalog.size() < 4)
+  {
+    qWarning() << "Not enough stars found for star matching";
+    return ERROR;
+  }
+  asterism.setReference(toPoints(catalog));
+  return OK;
+}
+
+OpPlugin::ResultType StarMatcher::match(const StarCatalog::Catalog& catalog, int width, int height)
+{
+  angle = 0;
+  angleSigma = 0;
+  dx = 0;
+  sigmadx = 0;
+  dy = 0;
+  sigmady = 0;
+  return matchAsterism(toPoints(catalog),width,height);
+}
+
+OpPlugin::ResultType StarMatcher::matchAsterism(const std::vector<AsterismMatcher::Point>& catalog, int width, int height)
+{
+  if (!asterism.match(catalog)) return ERROR;
+  /* Expressed as a rotation about the center followed by a shift, as
+     applied by the stacking: the center is mapped to center-[dx,dy]. */
+  const Eigen::Matrix3d& h = asterism.getTransform();
+  int xc = width / 2;
+  int yc = height / 2;
+  double w = h(2,0) * xc + h(2,1) * yc + h(2,2);
+  dx = xc - (h(0,0) * xc + h(0,1) * yc + h(0,2)) / w;
+  dy = yc - (h(1,0) * xc + h(1,1) * yc + h(1,2)) / w;
+  /* The stacking applies only the rotation and the shift. A scale or shear
+     of the fitted transformation, which moves the corners of the frame by
+     more than a pixel, would blur the stack, so the frame is rejected. */
+  double theta = atan2(h(1,0)-h(0,1),h(0,0)+h(1,1));
+  double deviation = 0;
+  for (int x : {0,width})
+  {
+    for (int y : {0,height})
+    {
+      double wc = h(2,0) * x + h(2,1) * y + h(2,2);
+      double tx = (h(0,0) * x + h(0,1) * y + h(0,2)) / wc;
+      double ty = (h(1,0) * x + h(1,1) * y + h(1,2)) / wc;
+      double rx = cos(theta) * (x - xc) - sin(theta) * (y - yc) + xc - dx;
+      double ry = sin(theta) * (x - xc) + cos(theta) * (y - yc) + yc - dy;
+      deviation = std::max(deviation,hypot(tx-rx,ty-ry));
+    }
+  }
+  if (deviation > 1)
+  {
+    qWarning() << "The matched transformation deviates by" << deviation << "pixel from a rotation and shift (scale"
+               << sqrt(fabs(h(0,0)*h(1,1)-h(0,1)*h(1,0))) << ")";
+    return ERROR;
+  }
+  double error = asterism.getResidual() / sqrt(asterism.getMatchCount());
+  sigmadx = error;
+  sigmady = error;
+  if (rotate)
+  {
+    angle = atan2(h(1,0)-h(0,1),h(0,0)+h(1,1)) * 180.0 / M_PI;
+    angleSigma = error / std::max(1,std::min(xc,yc)) * 180.0 / M_PI;
+  }
+  return OK;
+}
+
+/*
+ * Detects the stars of a gray image with its sky background estimated
+ * from the histogram. The flux is the peak value above the sky.
+ */
+std::vector<AsterismMatcher::Point> StarMatcher::findCatalog(const FitsImage& image)
+{
+  /* a background map keeps gradients from producing spurious detections */
+  BackgroundMap map;
+  map.build(image);
+  starfinder.setBackground(map.getBackground(),map.getRMS());
+  std::vector<AsterismMatcher::Point> catalog;
+  for (const Star& star : starfinder.findStars(image))
+  {
+    int x = std::clamp(static_cast<int>(star.getX()+0.5),0,image.getWidth()-1);
+    int y = std::clamp(static_cast<int>(star.getY()+0.5),0,image.getHeight()-1);
+    double flux = image.getConstPixelIterator(x,y).getAbs() - map.getBackground().getConstPixelIterator(x,y).getAbs();
+    catalog.push_back({star.getX(),star.getY(),flux});
+  }
+  return catalog;
+}
+
+std::vector<AsterismMatcher::Point> StarMatcher::toPoints(const StarCatalog::Catalog& catalog)
+{
+  std::vector<AsterismMatcher::Point> points;
+  points.reserve(catalog.size());
+  for (const StarCatalog::Entry& star : catalog) points.push_back({star.x,star.y,star.flux});
+  return points;
+}
+
 /*
  * calculate the rotation angle in degrees.
  * Returns a tuple with <angle,stddev>
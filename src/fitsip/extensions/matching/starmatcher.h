@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - plugin to match two images based on stars                           *
  *                                                                              *
- * modified: 2025-10-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -23,7 +23,9 @@
 #ifndef STARMATCHER_H
 #define STARMATCHER_H
 
+#include "asterismmatcher.h"
 #include "findstars.h"
+#include "starcatalog.h"
 #include <fitsip/core/fitstypes.h>
 #include <fitsip/core/opplugin.h>
 #include <QObject>
@@ -31,6 +33,13 @@
 
 class StarMatcherDialog;
 
+/**
+ * @brief Matches images by their stars.
+ *
+ * With selected stars, these are tracked from frame to frame in a search box
+ * around their last position. Without a selection the stars are detected
+ * in every image and matched to the reference by asterisms.
+ */
 class StarMatcher: public OpPlugin
 {
   Q_OBJECT
@@ -47,6 +56,39 @@ public:
 
   ResultType match(const FitsImage& image);
 
+  /**
+   * @brief Prepare the asterism matching with the catalog of the reference.
+   * @param catalog the stars of the reference (see StarCatalog)
+   * @param rotate true to fit the rotation
+   * @return the result of the operation
+   */
+  ResultType prepare(const StarCatalog::Catalog& catalog, bool rotate);
+
+  /**
+   * @brief Match a catalog by asterisms.
+   * @param catalog the stars of the frame
+   * @param width the width of the frame
+   * @param height the height of the frame
+   * @return the result of the operation
+   */
+  ResultType match(const StarCatalog::Catalog& catalog, int width, int height);
+
+  /**
+   * @brief Set the transformation model of the asterism matching.
+   *
+   * The images are aligned by a rotation and a shift, so only the
+   * similarity model is accepted; a std::invalid_argument is thrown for
+   * the others.
+   * @param model the model
+   */
+  void setModel(AsterismMatcher::Model model);
+
+  /**
+   * @brief Check if the images are matched by asterisms.
+   * @return true if no stars were selected in prepare
+   */
+  bool isAsterismMatch() const;
+
   double getAngle() const;
 
   double getAngleSigma() const;
@@ -60,6 +102,9 @@ public:
   double getSigmady() const;
 
 private:
+  ResultType matchAsterism(const std::vector<AsterismMatcher::Point>& catalog, int width, int height);
+  static std::vector<AsterismMatcher::Point> toPoints(const StarCatalog::Catalog& catalog);
+  std::vector<AsterismMatcher::Point> findCatalog(const FitsImage& image);
   std::tuple<double,double> getRotationAngle(const StarList& list1, const StarList& list2);
   std::tuple<double,double,double,double> getShift(const StarList& list1, const StarList& list2);
 
@@ -69,6 +114,8 @@ private:
   int starbox;
   double maxmove;
   bool rotate;
+  bool asterismMode;
+  AsterismMatcher asterism;
   FindStars starfinder;
   StarList starlist1;
   StarList starlist2;
@@ -0,0 +1,140 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - drizzle integration                                                 *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "drizzle.h"
+#include <fitsip/core/parallel.h>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+Drizzle::Drizzle(int width, int height, int depth, double scale, double pixfrac):
+  width(width),
+  height(height),
+  depth(depth),
+  scale(scale),
+  pixfrac(pixfrac),
+  frames(0)
+{
+  if (scale < 1 || scale > 4) throw std::invalid_argument("Drizzle: scale must be in the range 1..4");
+  if (pixfrac <= 0 || pixfrac > 1) throw std::invalid_argument("Drizzle: pixfrac must be in the range 0..1");
+  int w = static_cast<int>(ceil(width*scale));
+  int h = static_cast<int>(ceil(height*scale));
+  data = FitsImage("drizzle",w,h,depth);
+  weights = FitsImage("weights",w,h,1);
+}
+
+void Drizzle::add(const FitsImage& image, double dx, double dy, double angle, double weight)
+{
+  if (image.getWidth() != width || image.getHeight() != height || image.getDepth() != depth)
+  {
+    throw std::runtime_error("Drizzle: incompatible frame "+image.getName().toStdString());
+  }
+  ++frames;
+  if (weight <= 0) return;
+  int wout = data.getWidth();
+  int hout = data.getHeight();
+  double ca = cos(angle*M_PI/180);
+  double sa = sin(angle*M_PI/180);
+  int xc = width / 2;
+  int yc = height / 2;
+  /* output pixel j covers [j-0.5,j+0.5], so the center of input pixel (x,y)
+     lands at X = ax*x + bx*y + x0, Y = ay*x + by*y + y0 */
+  double ax = scale * ca;
+  double bx = -scale * sa;
+  double x0 = scale * (xc - xc * ca + yc * sa - dx + 0.5) - 0.5;
+  double ay = scale * sa;
+  double by = scale * ca;
+  double y0 = scale * (yc - xc * sa - yc * ca - dy + 0.5) - 0.5;
+  /* half size of a drop in output pixels */
+  double hd = pixfrac * scale / 2;
+  std::vector<const ValueType*> src;
+  std::vector<ValueType*> dst;
+  for (int d=0;d<depth;++d)
+  {
+    src.push_back(image.getLayer(d).getData());
+    dst.push_back(data.getLayer(d).getData());
+  }
+  ValueType* wmap = weights.getLayer(0).getData();
+  parallel::forRange(hout,[&](int j0, int j1){
+    /* drops centered in this band reach into the stripe of rows j0..j1-1 */
+    double top = j0 - 0.5 - hd;
+    double bottom = j1 - 0.5 + hd;
+    for (int y=0;y<height;++y)
+    {
+      /* Y is linear in x, so the range of a row is given by its ends */
+      double ya = by * y + y0;
+      double yb = ya + ay * (width - 1);
+      if (std::max(ya,yb) <= top || std::min(ya,yb) >= bottom) continue;
+      const int row = y * width;
+      for (int x=0;x<width;++x)
+      {
+        double Y = ay * x + ya;
+        if (Y <= top || Y >= bottom) continue;
+        double X = ax * x + bx * y + x0;
+        int jy0 = std::max(j0,static_cast<int>(floor(Y - hd + 0.5)));
+        int jy1 = std::min(j1-1,static_cast<int>(floor(Y + hd + 0.5)));
+        int jx0 = std::max(0,static_cast<int>(floor(X - hd + 0.5)));
+        int jx1 = std::min(wout-1,static_cast<int>(floor(X + hd + 0.5)));
+        for (int jy=jy0;jy<=jy1;++jy)
+        {
+          double oy = std::min(Y+hd,jy+0.5) - std::max(Y-hd,jy-0.5);
+          if (oy <= 0) continue;
+          for (int jx=jx0;jx<=jx1;++jx)
+          {
+            double ox = std::min(X+hd,jx+0.5) - std::max(X-hd,jx-0.5);
+            if (ox <= 0) continue;
+            ValueType a = static_cast<ValueType>(ox * oy * weight);
+            size_t i = static_cast<size_t>(jy) * wout + jx;
+            wmap[i] += a;
+            for (int d=0;d<depth;++d) dst[d][i] += a * src[d][row+x];
+          }
+        }
+      }
+    }
+  },8);
+}
+
+int Drizzle::getFrameCount() const
+{
+  return frames;
+}
+
+FitsImage Drizzle::getImage(const QString& name) const
+{
+  FitsImage img(name,data);
+  const ValueType* w = weights.getLayer(0).getData();
+  int wout = img.getWidth();
+  for (int d=0;d<depth;++d)
+  {
+    ValueType* p = img.getLayer(d).getData();
+    parallel::forRange(img.getHeight(),[=](int y0, int y1){
+      for (int i=y0*wout;i<y1*wout;++i) p[i] = w[i] > 0 ? p[i] / w[i] : 0;
+    },16);
+  }
+  return img;
+}
+
+FitsImage Drizzle::getWeights(const QString& name) const
+{
+  return FitsImage(name,weights);
+}
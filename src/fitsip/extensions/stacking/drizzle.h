@@ -0,0 +1,100 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - drizzle integration                                                 *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef DRIZZLE_H
+#define DRIZZLE_H
+
+#include <fitsip/core/fitsimage.h>
+#include <QString>
+
+/**
+ * @brief Combines undersampled frames on a finer output grid by drizzling.
+ *
+ * Every input pixel is shrunk to a square drop of pixfrac times its size,
+ * mapped into the reference frame and spread over the output pixels by
+ * the overlap area (the drops are kept aligned with the axes, which is
+ * accurate for the small rotations between frames). The output is the
+ * weighted mean of all drops and a weight map holds the total weight per
+ * output pixel.
+ *
+ * The output is split into stripes of rows which are filled in parallel;
+ * each stripe takes only the parts of the drops falling into it, so no
+ * per-thread copies of the output are needed and the result does not
+ * depend on the number of threads.
+ */
+class Drizzle
+{
+public:
+  /**
+   * @brief Constructor.
+   * @param width width of the input frames
+   * @param height height of the input frames
+   * @param depth depth of the input frames
+   * @param scale output pixels per input pixel
+   * @param pixfrac size of the drops relative to an input pixel
+   */
+  Drizzle(int width, int height, int depth, double scale, double pixfrac);
+
+  /**
+   * @brief Drizzle a frame onto the output.
+   *
+   * The transformation is the one of the stacking alignment: the frame is
+   * rotated by angle about its center (width/2,height/2) and then shifted
+   * by [-dx,-dy].
+   * @param image the frame
+   * @param dx the offset of the frame in x
+   * @param dy the offset of the frame in y
+   * @param angle the rotation in degree
+   * @param weight the weight of the frame
+   */
+  void add(const FitsImage& image, double dx, double dy, double angle, double weight=1);
+
+  int getFrameCount() const;
+
+  /**
+   * @brief Get the combined image.
+   *
+   * Output pixels not hit by any drop are 0.
+   * @param name name of the image
+   * @return the weighted mean of the drops
+   */
+  FitsImage getImage(const QString& name) const;
+
+  /**
+   * @brief Get the weight map.
+   * @param name name of the image
+   * @return the summed weight of the drops per output pixel
+   */
+  FitsImage getWeights(const QString& name) const;
+
+private:
+  int width;
+  int height;
+  int depth;
+  double scale;
+  double pixfrac;
+  int frames;
+  FitsImage data;
+  FitsImage weights;
+};
+
+#endif // DRIZZLE_H
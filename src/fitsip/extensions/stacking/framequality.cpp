@@ -0,0 +1,155 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - frame quality metrics                                               *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "framequality.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+
+struct Peak
+{
+  ValueType value;
+  int x;
+  int y;
+};
+
+}
+
+FrameQuality FrameQuality::measure(const FitsImage& image)
+{
+  FrameQuality q;
+  int w = image.getWidth();
+  int h = image.getHeight();
+  if (w < 16 || h < 16) return q;
+  /* gray values; single layer images are used directly */
+  std::vector<ValueType> buffer;
+  const ValueType* gray = image.getLayer(0).getData();
+  if (image.getDepth() > 1)
+  {
+    buffer.assign(image.getLayer(0).getData(),image.getLayer(0).getData()+static_cast<size_t>(w)*h);
+    for (int d=1;d<image.getDepth();++d)
+    {
+      const ValueType* p = image.getLayer(d).getData();
+      for (size_t i=0;i<buffer.size();++i) buffer[i] += p[i];
+    }
+    for (ValueType& v : buffer) v /= image.getDepth();
+    gray = buffer.data();
+  }
+  /* background and noise from a sample of about 65536 pixels */
+  int step = std::max(1,static_cast<int>(sqrt(static_cast<double>(w)*h/65536)));
+  std::vector<ValueType> sample;
+  sample.reserve((w/step+1)*(h/step+1));
+  for (int y=0;y<h;y+=step)
+  {
+    for (int x=0;x<w;x+=step) sample.push_back(gray[static_cast<size_t>(y)*w+x]);
+  }
+  size_t m = sample.size() / 2;
+  std::nth_element(sample.begin(),sample.begin()+m,sample.end());
+  q.background = sample[m];
+  for (ValueType& v : sample) v = static_cast<ValueType>(fabs(v-q.background));
+  std::nth_element(sample.begin(),sample.begin()+m,sample.end());
+  q.noise = 1.4826 * sample[m];
+  /* sharpness and local maxima in one pass, ignoring a border of 4 pixels */
+  const int border = 4;
+  double sum = 0;
+  double sum2 = 0;
+  size_t n = 0;
+  ValueType threshold = static_cast<ValueType>(q.background + 5*q.noise);
+  std::vector<Peak> peaks;
+  for (int y=border;y<h-border;++y)
+  {
+    const ValueType* p = gray + static_cast<size_t>(y)*w;
+    for (int x=border;x<w-border;++x)
+    {
+      double l = 4.0*p[x] - p[x-1] - p[x+1] - p[x-w] - p[x+w];
+      sum += l;
+      sum2 += l * l;
+      ValueType v = p[x];
+      if (q.noise > 0 && v > threshold && v > p[x-1] && v >= p[x+1] && v > p[x-w] && v >= p[x+w]
+          && v > p[x-w-1] && v > p[x-w+1] && v >= p[x+w-1] && v >= p[x+w+1])
+      {
+        peaks.push_back({v,x,y});
+      }
+    }
+    n += w - 2*border;
+  }
+  double mean = sum / n;
+  q.sharpness = sqrt(std::max(0.0,sum2/n-mean*mean));
+  q.stars = static_cast<int>(peaks.size());
+  /* FWHM from the second moments of the brightest stars */
+  size_t count = std::min<size_t>(peaks.size(),50);
+  std::partial_sort(peaks.begin(),peaks.begin()+count,peaks.end(),[](const Peak& p1, const Peak& p2){ return p1.value > p2.value; });
+  std::vector<double> widths;
+  for (size_t i=0;i<count;++i)
+  {
+    double s = 0;
+    double s2 = 0;
+    for (int dy=-border;dy<=border;++dy)
+    {
+      const ValueType* p = gray + static_cast<size_t>(peaks[i].y+dy)*w + peaks[i].x;
+      for (int dx=-border;dx<=border;++dx)
+      {
+        double v = p[dx] - q.background;
+        if (v <= 0) continue;
+        s += v;
+        s2 += v * (dx*dx + dy*dy);
+      }
+    }
+    if (s > 0) widths.push_back(2.3548*sqrt(s2/(2*s)));
+  }
+  if (!widths.empty())
+  {
+    std::nth_element(widths.begin(),widths.begin()+widths.size()/2,widths.end());
+    q.fwhm = widths[widths.size()/2];
+  }
+  return q;
+}
+
+FrameQuality::Metric FrameQuality::getMetric(const QString& name)
+{
+  QString s = name.toLower();
+  if (s == "sharpness") return Sharpness;
+  if (s == "fwhm") return FWHM;
+  if (s == "noise") return Noise;
+  if (s == "stars") return Stars;
+  throw std::invalid_argument(("unknown quality metric "+name).toStdString());
+}
+
+double FrameQuality::getScore(Metric metric) const
+{
+  switch (metric)
+  {
+    case Sharpness:
+      return sharpness;
+    case FWHM:
+      return fwhm > 0 ? 1 / (fwhm*fwhm) : 0;
+    case Noise:
+      return noise > 0 ? 1 / (noise*noise) : 0;
+    case Stars:
+      return stars;
+  }
+  return 0;
+}
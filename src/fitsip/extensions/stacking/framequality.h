@@ -0,0 +1,74 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - frame quality metrics                                               *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef FRAMEQUALITY_H
+#define FRAMEQUALITY_H
+
+#include <fitsip/core/fitsimage.h>
+#include <QString>
+
+/**
+ * @brief Fast quality metrics of a frame used to rank frames for stacking.
+ *
+ * All metrics are computed on the gray values in a few passes over the
+ * image:
+ * - the background is the median and the noise the robust standard
+ *   deviation (from the median absolute deviation) of a pixel sample,
+ * - the sharpness is the standard deviation of the Laplacian,
+ * - stars are local maxima 5 sigma above the background; the FWHM is the
+ *   median of the second moment widths of the brightest stars.
+ */
+struct FrameQuality
+{
+  enum Metric { Sharpness, FWHM, Noise, Stars };
+
+  double background = 0;
+  double noise = 0;
+  double sharpness = 0;
+  int stars = 0;
+  double fwhm = 0;                   // 0 if no stars were found
+
+  /**
+   * @brief Measure the quality of an image.
+   * @param image the image
+   * @return the metrics
+   */
+  static FrameQuality measure(const FitsImage& image);
+
+  /**
+   * @brief Get the metric for a name used in batch parameters.
+   *
+   * Throws a std::invalid_argument for unknown names.
+   * @param name sharpness, fwhm, noise or stars
+   * @return the metric
+   */
+  static Metric getMetric(const QString& name);
+
+  /**
+   * @brief Get a score of the frame, higher is better.
+   * @param metric the metric to use
+   * @return the score
+   */
+  double getScore(Metric metric) const;
+};
+
+#endif // FRAMEQUALITY_H
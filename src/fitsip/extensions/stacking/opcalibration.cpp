@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - image calibration with flatfield and dark image                     *
  *                                                                              *
- * modified: 2025-11-03                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -32,6 +32,18 @@
 #include <QDebug>
 #include <QDir>
 
+namespace
+{
+
+/* the image of an object, shared with the object instead of copied */
+std::shared_ptr<const FitsImage> imageOf(const std::shared_ptr<FitsObject>& obj)
+{
+  if (!obj) return std::shared_ptr<const FitsImage>();
+  return std::shared_ptr<const FitsImage>(obj,&obj->getImage());
+}
+
+}
+
 OpCalibration::OpCalibration():
   dlg(nullptr)
 {
@@ -67,22 +79,72 @@ OpPlugin::ResultType OpCalibration::execute(const std::vector<QFileInfo>& list,
     dir.mkpath(dlg->getOutputPath());
     dir = QDir(dlg->getOutputPath());
   }
-  IOHandler* handler = IOFactory::getInstance()->getHandler("tmp.fts");
   ProgressDialog* prog = list.size() > 2 ? new ProgressDialog() : nullptr;
   if (prog)
   {
     prog->setMaximum(list.size());
     prog->show();
   }
-  std::shared_ptr<FitsObject> darkframe = dlg->getDarkFrame();
-  std::shared_ptr<FitsObject> flatfield = dlg->getFlatField();
+  calibrateList(list,imageOf(dlg->getDarkFrame()),imageOf(dlg->getFlatField()),dir,dlg->getPrefix(),dlg->getSuffix(),prog);
+  if (prog) prog->deleteLater();
+  return OK;
+}
+
+bool OpCalibration::supportsBatch() const
+{
+  return true;
+}
+
+QStringList OpCalibration::getBatchParameters() const
+{
+  return {"dark  dark frame file",
+          "flat  flat field file",
+          "output  output directory (default: directory of the first file)",
+          "prefix  prefix for the output file names",
+          "suffix  suffix for the output file names"};
+}
+
+OpPlugin::ResultType OpCalibration::executeBatch(const std::vector<QFileInfo>& list, const QVariantMap& params)
+{
+  if (list.empty()) return CANCELLED;
+  std::shared_ptr<const FitsImage> darkframe;
+  std::shared_ptr<const FitsImage> flatfield;
+  try
+  {
+    /* the masters are only read, so they are shared with the image cache */
+    QString file = params.value("dark").toString();
+    if (!file.isEmpty()) darkframe = IOFactory::getInstance()->readImage(file);
+    file = params.value("flat").toString();
+    if (!file.isEmpty()) flatfield = IOFactory::getInstance()->readImage(file);
+  }
+  catch (const std::exception& ex)
+  {
+    setError(QString("OpCalibration: ")+ex.what());
+    return ERROR;
+  }
+  QString path = params.value("output",list[0].absolutePath()).toString();
+  QDir dir(path);
+  if (!dir.exists() && !dir.mkpath("."))
+  {
+    setError("OpCalibration: cannot create output directory "+path);
+    return ERROR;
+  }
+  calibrateList(list,darkframe,flatfield,dir,params.value("prefix").toString(),params.value("suffix").toString(),nullptr);
+  return OK;
+}
+
+void OpCalibration::calibrateList(const std::vector<QFileInfo>& list, std::shared_ptr<const FitsImage> darkframe, std::shared_ptr<const FitsImage> flatfield,
+                                  const QDir& dir, const QString& prefix, const QString& suffix, ProgressDialog* prog)
+{
+  IOHandler* handler = IOFactory::getInstance()->getHandler("tmp.fts");
+  filelist.clear();
   double mean = 1.0;
   if (flatfield)
   {
-    double w = flatfield->getImage().getWidth() / 5;
-    double h = flatfield->getImage().getHeight() / 5;
-    QRect r((flatfield->getImage().getWidth()-w)/2,(flatfield->getImage().getHeight()-h)/2,w,h);
-    ImageStatistics stat(flatfield->getImage(),r);
+    double w = flatfield->getWidth() / 5;
+    double h = flatfield->getHeight() / 5;
+    QRect r((flatfield->getWidth()-w)/2,(flatfield->getHeight()-h)/2,w,h);
+    ImageStatistics stat(*flatfield,r);
     mean = stat.getGlobalStatistics().meanValue;
   }
   int32_t n = 0;
@@ -100,8 +162,8 @@ OpPlugin::ResultType OpCalibration::execute(const std::vector<QFileInfo>& list,
       auto img = calibrate(info,darkframe,flatfield,mean);
       if (img)
       {
-        QString name = QString("%1%2%3.fts").arg(dlg->getPrefix(),img.getName(),dlg->getSuffix());
-        handler->write(dir.filePath(name),img);
+        QString name = QString("%1%2%3.fts").arg(prefix,img.getName(),suffix);
+        if (handler->write(dir.filePath(name),img)) filelist.push_back(QFileInfo(dir.filePath(name)));
       }
     }
     catch (const std::exception& ex)
@@ -109,27 +171,24 @@ OpPlugin::ResultType OpCalibration::execute(const std::vector<QFileInfo>& list,
       qWarning() << ex.what();
     }
   }
-  if (prog) prog->deleteLater();
-  return OK;
 }
 
 
 
-FitsImage OpCalibration::calibrate(const QFileInfo& info, std::shared_ptr<FitsObject> darkframe, std::shared_ptr<FitsObject> flatfield, double mean)
+FitsImage OpCalibration::calibrate(const QFileInfo& info, std::shared_ptr<const FitsImage> darkframe, std::shared_ptr<const FitsImage> flatfield, double mean)
 {
-  IOHandler* handler = IOFactory::getInstance()->getHandler(info.absoluteFilePath());
-  if (!handler) return FitsImage();
-  FitsImage img(handler->read(info.absoluteFilePath()).front()->getImage());
+  /* every frame is read once, so it must not evict the masters from the cache */
+  FitsImage img = IOFactory::getInstance()->loadImage(info.absoluteFilePath(),IOFactory::ReadOnce);
   if (darkframe)
   {
-    img -= darkframe->getImage();
-    log(&img,"Subtracted darkframe '"+darkframe->getImage().getName()+"'");
+    img -= *darkframe;
+    log(&img,"Subtracted darkframe '"+darkframe->getName()+"'");
   }
   if (flatfield)
   {
-    img /= flatfield->getImage();
+    img /= *flatfield;
     img *= mean;
-    log(&img,"Divided flatfield '"+flatfield->getImage().getName()+"'");
+    log(&img,"Divided flatfield '"+flatfield->getName()+"'");
   }
   return img;
 }
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - image calibration with flatfield and dark image                     *
  *                                                                              *
- * modified: 2022-12-01                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -29,6 +29,8 @@
 
 class FitsObject;
 class OpCalibrationDialog;
+class ProgressDialog;
+class QDir;
 
 class OpCalibration: public OpPlugin
 {
@@ -44,8 +46,16 @@ public:
 
   virtual ResultType execute(const std::vector<QFileInfo>& list, const OpPluginData& data=OpPluginData()) override;
 
+  virtual bool supportsBatch() const override;
+
+  virtual QStringList getBatchParameters() const override;
+
+  virtual ResultType executeBatch(const std::vector<QFileInfo>& list, const QVariantMap& params) override;
+
 private:
-  FitsImage calibrate(const QFileInfo& info, std::shared_ptr<FitsObject> darkframe, std::shared_ptr<FitsObject> flatfield, double mean);
+  void calibrateList(const std::vector<QFileInfo>& list, std::shared_ptr<const FitsImage> darkframe, std::shared_ptr<const FitsImage> flatfield,
+                     const QDir& dir, const QString& prefix, const QString& suffix, ProgressDialog* prog);
+  FitsImage calibrate(const QFileInfo& info, std::shared_ptr<const FitsImage> darkframe, std::shared_ptr<const FitsImage> flatfield, double mean);
 
   OpCalibrationDialog* dlg;
 };
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - stack images                                                        *
  *                                                                              *
- * modified: 2025-10-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -21,23 +21,77 @@
  ********************************************************************************/
 
 #include "opstack.h"
+#include "drizzle.h"
+#include "framequality.h"
 #include "opstackdialog.h"
+#include "rejectionstack.h"
 #include <fitsip/coreplugins/oprotate.h>
 #include <fitsip/coreplugins/opshift.h>
+#include <fitsip/core/backgroundmap.h>
 #include <fitsip/core/fitsimage.h>
 #include <fitsip/core/histogram.h>
+#include <fitsip/core/parallel.h>
+#include <fitsip/core/settings.h>
 #include <fitsip/core/dialogs/progressdialog.h>
-#include <fitsip/core/io/iofactory.h>
+#include <fitsip/core/io/framesequence.h>
 #include <QApplication>
 #include <QDebug>
+#include <QMutex>
+#include <QRunnable>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <stdexcept>
+
+namespace
+{
+
+class StackTask: public QRunnable
+{
+public:
+  explicit StackTask(std::function<void()> func):
+    func(func)
+  {
+  }
+
+  void run() override
+  {
+    func();
+  }
+
+private:
+  std::function<void()> func;
+};
+
+}
+
+/* a frame handed over from the workers to the accumulation */
+struct OpStack::PreparedFrame
+{
+  bool done = false;
+  OpPlugin::ResultType result = OpPlugin::ERROR;
+  FitsImage image;
+  QString message;
+  double dx = 0;      // alignment, applied to the image unless drizzling
+  double dy = 0;
+  double angle = 0;
+  const StarCatalog::Catalog* stars = nullptr;  // catalog of the frame if read from the sidecar
+};
 
 OpStack::OpStack():
   dlg(nullptr),
   subtractSky(true),
+  skyMap(false),
   // searchbox(100),
   // starbox(20),
   // maxmove(20),
-  rotate(false)
+  rotate(false),
+  drizzle(false),
+  drizzleScale(2),
+  drizzlePixfrac(0.7)
 {
   profiler = SimpleProfiler("OpStack");
 }
@@ -49,7 +103,9 @@ OpStack::~OpStack()
 
 std::vector<std::shared_ptr<FitsObject>> OpStack::getCreatedImages() const
 {
-  return std::vector<std::shared_ptr<FitsObject>>{std::make_shared<FitsObject>(img)};
+  std::vector<std::shared_ptr<FitsObject>> list{std::make_shared<FitsObject>(img)};
+  if (weightMap) list.push_back(std::make_shared<FitsObject>(weightMap));
+  return list;
 }
 
 QString OpStack::getMenuEntry() const
@@ -64,7 +120,13 @@ bool OpStack::requiresFileList() const
 
 OpPlugin::ResultType OpStack::execute(const std::vector<QFileInfo>& list, const OpPluginData& data)
 {
-  if (list.size() < 2)
+  FrameSequence sequence(list);
+  if (!sequence.getErrors().isEmpty())
+  {
+    setError("OpStack: "+sequence.getErrors().join("\n"));
+    return ERROR;
+  }
+  if (sequence.size() < 2)
   {
     qWarning() << "Not enough files in list for stacking";
     return ERROR;
@@ -73,6 +135,9 @@ OpPlugin::ResultType OpStack::execute(const std::vector<QFileInfo>& list, const
   if (dlg->exec())
   {
     Align mode = static_cast<Align>(dlg->getAlignment());
+    skyMap = dlg->isSkyMap();
+    catalog.reset();
+    catalogs.clear();
     QString msg = "";
     switch (mode)
     {
@@ -88,31 +153,56 @@ OpPlugin::ResultType OpStack::execute(const std::vector<QFileInfo>& list, const
         break;
     }
 
-    ProgressDialog* prog = list.size() > 2 ? new ProgressDialog() : nullptr;
+    ProgressDialog* prog = sequence.size() > 2 ? new ProgressDialog() : nullptr;
     if (prog)
     {
-      prog->setMaximum(list.size());
+      prog->setMaximum(sequence.size());
       prog->setProgress(0);
-      prog->appendMessage(list[0].fileName());
+      if (dlg->getQualityMetric() != "none") prog->appendMessage("ranking frames");
       prog->show();
       QApplication::processEvents();
     }
     else
       QApplication::setOverrideCursor(Qt::BusyCursor);
     profiler.start();
+    std::unique_ptr<FrameSequence> selected = selectFrames(sequence,dlg->getQualityMetric(),dlg->getKeepPercentage(),dlg->isWeightByQuality());
+    const FrameSequence& frames = selected ? *selected : sequence;
+    if (prog)
+    {
+      if (selected) prog->appendMessage(selectionMessage);
+      prog->setMaximum(frames.size());
+      prog->appendMessage(frames.getName(0));
+      QApplication::processEvents();
+    }
+    setCombination(dlg->getCombination(),frames.size());
+    if (rejection) rejection->setLimits(dlg->getRejectionLow(),dlg->getRejectionHigh());
+    if (drizzle)
+    {
+      try
+      {
+        setDrizzle(dlg->getDrizzleScale(),dlg->getDrizzlePixfrac());
+      }
+      catch (const std::exception& ex)
+      {
+        qWarning() << ex.what();
+        if (prog) prog->deleteLater();
+        QApplication::restoreOverrideCursor();
+        return ERROR;
+      }
+    }
     ResultType ret;
     switch (mode)
     {
       case Align::NoAlignment:
       default:
-        ret = prepare(list[0],dlg->isSubtractSky());
+        ret = prepare(frames,dlg->isSubtractSky());
         break;
       case Align::TemplateMatch:
-        ret = prepareTemplate(list[0],dlg->isSubtractSky(),data.aoi,dlg->isFullTemplateMatch(),dlg->getTemplateMatchRange());
+        ret = prepareTemplate(frames,dlg->isSubtractSky(),data.aoi,dlg->isFullTemplateMatch(),dlg->getTemplateMatchRange());
         break;
       case Align::StarMatch:
         rotate = dlg->isAllowRotation();
-        ret = prepareStarMatch(list[0],data.pixellist,dlg->isSubtractSky(),dlg->getSearchBoxSize(),dlg->getStarBoxSize(),dlg->isAllowRotation(),dlg->getStarMaxMovement());
+        ret = prepareStarMatch(frames,data.pixellist,dlg->isSubtractSky(),dlg->getSearchBoxSize(),dlg->getStarBoxSize(),dlg->isAllowRotation(),dlg->getStarMaxMovement());
         break;
     }
     if (ret != OK)
@@ -121,31 +211,7 @@ OpPlugin::ResultType OpStack::execute(const std::vector<QFileInfo>& list, const
       QApplication::restoreOverrideCursor();
       return ret;
     }
-    log(&img,list[0].baseName()+" loaded as base for stacking");
-    for (size_t i=1;i<list.size();++i)
-    {
-      const QFileInfo& file = list[i];
-      switch (mode)
-      {
-        case Align::NoAlignment:
-        default:
-          ret = stack(file);
-          break;
-        case Align::TemplateMatch:
-          ret = stackTemplate(file);
-          break;
-        case Align::StarMatch:
-          ret = stackStarMatch(file);
-          break;
-      }
-      if (prog)
-      {
-        prog->setProgress(i);
-        prog->appendMessage(file.fileName()+(ret==OK?" - Success":" - Error"));
-        QApplication::processEvents();
-        if (prog->isCancelled()) break;
-      }
-    }
+    stackFrames(frames,mode,prog);
     profiler.stop();
     if (img) logProfiler(img,msg);
     if (prog) prog->deleteLater();
@@ -155,110 +221,528 @@ OpPlugin::ResultType OpStack::execute(const std::vector<QFileInfo>& list, const
   return CANCELLED;
 }
 
-OpPlugin::ResultType OpStack::prepare(const QFileInfo& file, bool subsky)
+bool OpStack::supportsBatch() const
 {
-  subtractSky = subsky;
-  IOHandler* handler = IOFactory::getInstance()->getHandler(file.absoluteFilePath());
-  if (!handler)
+  return true;
+}
+
+QStringList OpStack::getBatchParameters() const
+{
+  return {"align=none  none, template or stars; stars are matched by asterisms",
+          "subtractsky=true  subtract the sky background before stacking",
+          "background=global  subtract a single sky value (global) or a background map (mesh)",
+          "rotate=false  correct the rotation when aligning by stars",
+          "aoi  template area x,y,w,h (default: whole image)",
+          "fullmatch=false  search the template in the whole image",
+          "range=20  template search range",
+          "matcher=phase  template matching by FFT phase correlation (phase) or spatial cross correlation (correlation)",
+          "combine=sum  sum, average, median, sigma, winsorized, percentile, linearfit or drizzle; all but sum average the frames",
+          "scale=2  output pixels per input pixel for drizzle",
+          "pixfrac=0.7  drop size relative to an input pixel for drizzle",
+          "low  lower rejection limit in sigma (default 3) or fraction for percentile (default 0.1)",
+          "high  upper rejection limit in sigma (default 3) or fraction for percentile (default 0.1)",
+          "iterations=5  maximum number of rejection iterations",
+          "quality=none  rank the frames by none, sharpness, fwhm, noise or stars",
+          "keep=100  percentage of the best ranked frames to stack",
+          "weight=false  weight the frames by their quality score",
+          "catalogs=false  read the stars for alignment and the fwhm and stars ranking from the catalog sidecar files (see CatalogStars)"};
+}
+
+OpPlugin::ResultType OpStack::executeBatch(const std::vector<QFileInfo>& list, const QVariantMap& params)
+{
+  return stackBatch(FrameSequence(list),params);
+}
+
+OpPlugin::ResultType OpStack::executeBatch(const std::vector<std::shared_ptr<FitsObject>>& list, const QVariantMap& params)
+{
+  return stackBatch(FrameSequence(list),params);
+}
+
+OpPlugin::ResultType OpStack::stackBatch(const FrameSequence& sequence, const QVariantMap& params)
+{
+  if (!sequence.getErrors().isEmpty())
   {
-    qCritical() << "No handler found for"  << file.absoluteFilePath();
+    setError("OpStack: "+sequence.getErrors().join("\n"));
     return ERROR;
   }
-  try
+  if (sequence.size() < 2)
   {
-    img = FitsImage("stack",handler->read(file.absoluteFilePath()).front()->getImage());
-    if (subtractSky)
+    setError("OpStack: not enough files in list for stacking");
+    return ERROR;
+  }
+  /* all parameters are checked before any frame is read */
+  QString align, background, quality, combine, method;
+  bool subsky, useCatalogs, weight, fullmatch, rotateFrames;
+  double keep, scale, pixfrac, low, high;
+  int iterations, range;
+  bool percentile = params.value("combine").toString().toLower() == "percentile";
+  if (!readBatchParameter(params,"align","none",{"none","template","stars"},align) ||
+      !readBatchParameter(params,"subtractsky",true,subsky) ||
+      !readBatchParameter(params,"background","global",{"global","mesh"},background) ||
+      !readBatchParameter(params,"catalogs",false,useCatalogs) ||
+      !readBatchParameter(params,"quality","none",{"none","sharpness","fwhm","noise","stars"},quality) ||
+      !readBatchParameter(params,"keep",100.0,keep,1,100) ||
+      !readBatchParameter(params,"weight",false,weight) ||
+      !readBatchParameter(params,"combine","sum",{"sum","average","median","sigma","winsorized","percentile","linearfit","drizzle"},combine) ||
+      !readBatchParameter(params,"scale",2.0,scale,1,4) ||
+      !readBatchParameter(params,"pixfrac",0.7,pixfrac,0.01,1) ||
+      !readBatchParameter(params,"iterations",5,iterations,1,100) ||
+      !readBatchParameter(params,"low",percentile ? 0.1 : 3.0,low,0,percentile ? 0.5 : 100) ||
+      !readBatchParameter(params,"high",percentile ? 0.1 : 3.0,high,0,percentile ? 0.5 : 100) ||
+      !readBatchParameter(params,"rotate",false,rotateFrames) ||
+      !readBatchParameter(params,"fullmatch",false,fullmatch) ||
+      !readBatchParameter(params,"range",20,range,1,10000) ||
+      !readBatchParameter(params,"matcher","phase",{"phase","correlation"},method))
+  {
+    return ERROR;
+  }
+  QRect aoi;
+  if (params.contains("aoi"))
+  {
+    QStringList l = params.value("aoi").toString().split(",");
+    bool ok = l.size() == 4;
+    int v[4] = {0,0,0,0};
+    for (int i=0;i<4 && ok;++i) v[i] = l[i].trimmed().toInt(&ok);
+    if (!ok || v[2] <= 0 || v[3] <= 0)
     {
-      Histogram hist;
-      hist.build(img);
-      AverageResult avg = hist.getAverage(0.75);
-      img -= avg.mean;
+      setError("OpStack: aoi must be x,y,w,h with a positive width and height");
+      return ERROR;
     }
+    aoi = QRect(v[0],v[1],v[2],v[3]);
   }
-  catch (std::exception& ex)
+  skyMap = background == "mesh";
+  if (useCatalogs)
+    catalog = std::make_unique<StarCatalog>();
+  else
+    catalog.reset();
+  catalogs.clear();
+  std::unique_ptr<FrameSequence> selected;
+  try
   {
-    qCritical() << ex.what();
+    selected = selectFrames(sequence,quality,keep,weight);
+  }
+  catch (const std::exception& ex)
+  {
+    setError(QString("OpStack: ")+ex.what());
+    return ERROR;
+  }
+  const FrameSequence& frames = selected ? *selected : sequence;
+  if (frames.size() < 2)
+  {
+    setError("OpStack: not enough frames left for stacking");
     return ERROR;
   }
+  try
+  {
+    setCombination(combine,frames.size());
+    if (drizzle) setDrizzle(scale,pixfrac);
+  }
+  catch (const std::exception& ex)
+  {
+    setError(QString("OpStack: ")+ex.what());
+    return ERROR;
+  }
+  if (rejection)
+  {
+    rejection->setIterations(iterations);
+    rejection->setLimits(low,high);
+  }
+  profiler.start();
+  ResultType ret;
+  Align mode;
+  if (align == "none")
+  {
+    mode = Align::NoAlignment;
+    ret = prepare(frames,subsky);
+  }
+  else if (align == "template")
+  {
+    mode = Align::TemplateMatch;
+    matcher.setMethod(method == "correlation" ? MeasureMatch::Spatial : MeasureMatch::Fourier);
+    ret = prepareTemplate(frames,subsky,aoi,fullmatch,range);
+  }
+  else
+  {
+    mode = Align::StarMatch;
+    rotate = rotateFrames;
+    /* the catalogs of all frames are read once, unless the selection already did */
+    if (catalog && catalogs.empty()) catalogs = catalog->catalogue(frames);
+    /* without a pixel list the box sizes and the maximum movement are not used */
+    ret = prepareStarMatch(frames,nullptr,subsky,100,20,rotate,20);
+  }
+  if (ret != OK)
+  {
+    setError(mode == Align::StarMatch ? "OpStack: no stars found in "+frames.getName(0) : "OpStack: failed to load "+frames.getName(0));
+    return ret;
+  }
+  stackFrames(frames,mode,nullptr);
+  catalogs.clear();
+  profiler.stop();
+  if (img) logProfiler(img,mode == Align::NoAlignment ? "no alignment" : mode == Align::TemplateMatch ? "template matching" : "star matching");
   return OK;
 }
 
-OpPlugin::ResultType OpStack::prepareTemplate(const QFileInfo &file, bool subsky, QRect aoi, bool full, int range)
+void OpStack::stackFrames(const FrameSequence& frames, Align mode, ProgressDialog* prog)
 {
-  OpPlugin::ResultType res = prepare(file,subsky);
-  if (res == OK)
+  log(&img,frames.getName(0)+" loaded as base for stacking");
+  if (!selectionMessage.isEmpty()) log(&img,selectionMessage);
+  weightMap = FitsImage();
+  std::unique_ptr<Drizzle> drizzled;
+  if (drizzle)
   {
-    matcher.setMatchFull(full);
-    matcher.setMatchRange(range);
-    matcher.setTemplate(img,aoi);
+    try
+    {
+      drizzled = std::make_unique<Drizzle>(img.getWidth(),img.getHeight(),img.getDepth(),drizzleScale,drizzlePixfrac);
+      drizzled->add(img,0,0,0,weights.empty() ? 1 : weights[0]);
+    }
+    catch (std::exception& ex)
+    {
+      qWarning() << ex.what() << "- stacking by sum";
+      drizzled.reset();
+      drizzle = false;
+    }
+  }
+  if (rejection)
+  {
+    try
+    {
+      rejection->add(img,weights.empty() ? 1 : weights[0]);
+    }
+    catch (std::exception& ex)
+    {
+      qWarning() << ex.what() << "- stacking by sum";
+      rejection.reset();
+    }
+  }
+  /* Frames are read, sky subtracted and (except for star matching, which
+     tracks the stars from frame to frame) aligned by a pool of workers.
+     They are accumulated in the order of the sequence, so the result does
+     not depend on the number of threads. */
+  int threads = std::max(1,std::min(parallel::getThreadCount(),static_cast<int>(frames.size())-1));
+  std::vector<std::unique_ptr<MeasureMatch>> matchers;
+  std::vector<MeasureMatch*> idleMatchers;
+  if (mode == Align::TemplateMatch)
+  {
+    for (int i=0;i<threads;++i)
+    {
+      matchers.push_back(std::make_unique<MeasureMatch>());
+      matchers.back()->setMethod(matcher.getMethod());
+      matchers.back()->setMatchFull(matcher.isMatchFull());
+      matchers.back()->setMatchRange(matcher.getMatchRange());
+      matchers.back()->setTemplate(img,templateAOI);
+      idleMatchers.push_back(matchers.back().get());
+    }
+  }
+  /* drizzling weights the drops and the rejection weights the mean of the
+     surviving values, so the frames are only scaled for the plain sum */
+  bool scale = !weights.empty() && !drizzle && !rejection;
+  if (scale) img *= static_cast<ValueType>(weights[0]);
+  std::vector<PreparedFrame> prepared(frames.size());
+  std::atomic<bool> cancelled(false);
+  QMutex mutex;
+  QWaitCondition ready;
+  QThreadPool pool;
+  pool.setMaxThreadCount(threads);
+  /* limits the number of frames held in memory */
+  size_t window = 2 * static_cast<size_t>(threads);
+  size_t next = 1;
+  for (size_t i=1;i<frames.size();++i)
+  {
+    for (;next<frames.size() && next<i+window;++next)
+    {
+      size_t index = next;
+      pool.start(new StackTask([&,index](){
+        PreparedFrame frame;
+        if (!cancelled)
+        {
+          MeasureMatch* m = nullptr;
+          if (mode == Align::TemplateMatch)
+          {
+            QMutexLocker lock(&mutex);
+            m = idleMatchers.back();
+            idleMatchers.pop_back();
+          }
+          ValueType weight = scale ? static_cast<ValueType>(weights[index]) : 1;
+          frame.result = prepareFrame(frames,index,mode,m,weight,frame);
+          if (m)
+          {
+            QMutexLocker lock(&mutex);
+            idleMatchers.push_back(m);
+          }
+        }
+        frame.done = true;
+        QMutexLocker lock(&mutex);
+        prepared[index] = std::move(frame);
+        ready.wakeAll();
+      }));
+    }
+    PreparedFrame frame;
+    {
+      QMutexLocker lock(&mutex);
+      while (!prepared[i].done)
+      {
+        ready.wait(&mutex,50);
+        if (prog)
+        {
+          lock.unlock();
+          QApplication::processEvents();
+          lock.relock();
+        }
+      }
+      frame = std::move(prepared[i]);
+    }
+    ResultType ret = frame.result;
+    if (ret == OK && mode == Align::StarMatch) ret = alignStarMatch(frame);
+    if (ret == OK)
+    {
+      try
+      {
+        if (drizzled)
+          drizzled->add(frame.image,frame.dx,frame.dy,frame.angle,weights.empty() ? 1 : weights[i]);
+        else if (rejection)
+          rejection->add(frame.image,weights.empty() ? 1 : weights[i]);
+        else
+          accumulate(frame.image);
+        log(&img,frame.message);
+        qInfo() << "Stacked: " << frame.image.getName();
+      }
+      catch (std::exception& ex)
+      {
+        qWarning() << ex.what();
+        ret = ERROR;
+      }
+    }
+    if (prog)
+    {
+      prog->setProgress(i);
+      prog->appendMessage(frames.getName(i)+(ret==OK?" - Success":" - Error"));
+      QApplication::processEvents();
+      if (prog->isCancelled()) break;
+    }
+  }
+  cancelled = true;
+  pool.waitForDone();
+  if (rejection)
+  {
+    if (prog)
+    {
+      prog->appendMessage("combining "+QString::number(rejection->getFrameCount())+" frames");
+      QApplication::processEvents();
+    }
+    try
+    {
+      FitsImage combined = rejection->combine("stack");
+      combined.setMetadata(img.getMetadata());
+      img = std::move(combined);
+      log(&img,QString::asprintf("combined %d frames by %s, rejected %.2f%% of the values",static_cast<int>(rejection->getFrameCount()),
+                                 RejectionStack::getName(rejection->getMethod()).toUtf8().data(),rejection->getRejectedFraction()*100));
+    }
+    catch (std::exception& ex)
+    {
+      qCritical() << ex.what();
+    }
+    rejection.reset();
+  }
+  if (drizzled)
+  {
+    FitsImage combined = drizzled->getImage("stack");
+    combined.setMetadata(img.getMetadata());
+    img = std::move(combined);
+    weightMap = drizzled->getWeights("stack_weights");
+    log(&img,QString::asprintf("drizzled %d frames with scale %.2f and pixfrac %.2f",drizzled->getFrameCount(),drizzleScale,drizzlePixfrac));
   }
-  return res;
 }
 
-OpPlugin::ResultType OpStack::prepareStarMatch(const QFileInfo &file, PixelList* pixellist, bool subsky, int searchbox, int starbox, bool rotate, double maxmove)
+std::unique_ptr<FrameSequence> OpStack::selectFrames(const FrameSequence& frames, const QString& metric, double keep, bool weight)
 {
-  OpPlugin::ResultType res = prepare(file,subsky);
-  if (res == OK)
+  weights.clear();
+  selectionMessage.clear();
+  if (metric == "none") return nullptr;
+  FrameQuality::Metric m = FrameQuality::getMetric(metric);
+  /* rank all frames first; frames which cannot be read are dropped */
+  std::vector<double> scores(frames.size(),-1);
+  std::vector<StarCatalog::Catalog> all;
+  if (catalog && (m == FrameQuality::FWHM || m == FrameQuality::Stars))
   {
-    res = starmatcher.prepare(img,pixellist,false,searchbox,starbox,rotate,maxmove);
+    /* the star metrics from the catalogs, detected only once per frame */
+    all = catalog->catalogue(frames);
+    for (size_t i=0;i<frames.size();++i)
+    {
+      FrameQuality q;
+      q.stars = static_cast<int>(all[i].size());
+      std::vector<float> fwhm;
+      for (const StarCatalog::Entry& star : all[i]) fwhm.push_back(star.fwhm);
+      if (!fwhm.empty())
+      {
+        std::nth_element(fwhm.begin(),fwhm.begin()+fwhm.size()/2,fwhm.end());
+        q.fwhm = fwhm[fwhm.size()/2];
+      }
+      scores[i] = q.getScore(m);
+    }
   }
-  return res;
+  else
+  {
+    parallel::forRange(static_cast<int>(frames.size()),[&](int i0, int i1){
+      for (int i=i0;i<i1;++i)
+      {
+        try
+        {
+          scores[i] = FrameQuality::measure(frames.getImage(i)).getScore(m);
+        }
+        catch (const std::exception& ex)
+        {
+          qWarning() << ex.what();
+        }
+      }
+    });
+  }
+  std::vector<size_t> order;
+  for (size_t i=0;i<frames.size();++i)
+  {
+    if (scores[i] >= 0) order.push_back(i);
+  }
+  std::stable_sort(order.begin(),order.end(),[&scores](size_t i1, size_t i2){ return scores[i1] > scores[i2]; });
+  size_t count = std::max<size_t>(2,static_cast<size_t>(ceil(order.size()*keep/100)));
+  if (count < order.size()) order.resize(count);
+  /* the best frame is the reference, the others are stacked in sequence order */
+  if (order.size() > 1) std::sort(order.begin()+1,order.end());
+  /* the catalogs are kept for the star matching of the selected frames */
+  if (!all.empty())
+  {
+    for (size_t i : order) catalogs.push_back(std::move(all[i]));
+  }
+  if (weight && !order.empty())
+  {
+    /* normalized to a mean weight of 1, so the sum keeps its scale */
+    double mean = 0;
+    for (size_t i : order) mean += scores[i];
+    mean /= order.size();
+    for (size_t i : order) weights.push_back(mean > 0 ? scores[i]/mean : 1);
+  }
+  selectionMessage = QString("selected %1 of %2 frames by %3%4").arg(order.size()).arg(frames.size()).arg(metric).arg(weight ? ", weighted" : "");
+  return std::make_unique<FrameSequence>(frames,order);
 }
 
-OpPlugin::ResultType OpStack::stack(const QFileInfo &file)
+void OpStack::setCombination(const QString& method, size_t frames)
 {
-  IOHandler* handler = IOFactory::getInstance()->getHandler(file.absoluteFilePath());
-  if (!handler)
-  {
-    qWarning() << "No handler found for"  << file.absoluteFilePath();
-    return ERROR;
-  }
+  rejection.reset();
+  drizzle = method == "drizzle";
+  if (method == "sum" || drizzle) return;
+  rejection = std::make_unique<RejectionStack>(RejectionStack::getMethod(method),frames,
+                                               static_cast<uint64_t>(Settings().getLoaderMemoryBudget())*1024*1024);
+}
+
+void OpStack::setDrizzle(double scale, double pixfrac)
+{
+  if (scale < 1 || scale > 4) throw std::invalid_argument("drizzle scale must be in the range 1..4");
+  if (pixfrac <= 0 || pixfrac > 1) throw std::invalid_argument("drizzle pixfrac must be in the range 0..1");
+  drizzleScale = scale;
+  drizzlePixfrac = pixfrac;
+}
+
+OpPlugin::ResultType OpStack::prepare(const FrameSequence& frames, bool subsky)
+{
+  subtractSky = subsky;
   try
   {
-    auto img1 = handler->read(file.absoluteFilePath()).front()->getImage();
-    if (subtractSky)
-    {
-      Histogram hist;
-      hist.build(img1);
-      AverageResult avg = hist.getAverage(0.75);
-      img1 -= avg.mean;
-    }
-    img += img1;
-    log(&img,"stacked  "+img1.getName());
-    qInfo() << "Stacked: " << img1.getName();
+    img = FitsImage("stack",frames.getImage(0));
+    if (subtractSky) subtractBackground(img);
   }
   catch (std::exception& ex)
   {
-    qWarning() << ex.what();
+    qCritical() << ex.what();
     return ERROR;
   }
   return OK;
 }
 
-OpPlugin::ResultType OpStack::stackTemplate(const QFileInfo &file)
+void OpStack::subtractBackground(FitsImage& image) const
 {
-  IOHandler* handler = IOFactory::getInstance()->getHandler(file.absoluteFilePath());
-  if (!handler)
+  if (skyMap)
   {
-    qWarning() << "No handler found for"  << file.absoluteFilePath();
-    return ERROR;
+    BackgroundMap map;
+    map.build(image);
+    map.subtract(image);
+  }
+  else
+  {
+    Histogram hist;
+    hist.build(image);
+    AverageResult avg = hist.getAverage(0.75);
+    image -= avg.mean;
+  }
+}
+
+OpPlugin::ResultType OpStack::prepareTemplate(const FrameSequence& frames, bool subsky, QRect aoi, bool full, int range)
+{
+  OpPlugin::ResultType res = prepare(frames,subsky);
+  if (res == OK)
+  {
+    matcher.setMatchFull(full);
+    matcher.setMatchRange(range);
+    try
+    {
+      matcher.setTemplate(img,aoi);
+    }
+    catch (std::exception& ex)
+    {
+      qCritical() << ex.what();
+      return ERROR;
+    }
+    templateAOI = aoi;
+  }
+  return res;
+}
+
+OpPlugin::ResultType OpStack::prepareStarMatch(const FrameSequence& frames, PixelList* pixellist, bool subsky, int searchbox, int starbox, bool rotate, double maxmove)
+{
+  OpPlugin::ResultType res = prepare(frames,subsky);
+  if (res == OK)
+  {
+    if (catalog && !pixellist)
+    {
+      try
+      {
+        res = starmatcher.prepare(catalogs.at(0),rotate);
+      }
+      catch (const std::exception& ex)
+      {
+        qWarning() << ex.what();
+        res = ERROR;
+      }
+    }
+    else
+      res = starmatcher.prepare(img,pixellist,false,searchbox,starbox,rotate,maxmove);
   }
+  return res;
+}
+
+OpPlugin::ResultType OpStack::prepareFrame(const FrameSequence& frames, size_t index, Align mode, MeasureMatch* m, ValueType weight, PreparedFrame& frame) const
+{
+  FitsImage& image = frame.image;
+  QString& msg = frame.message;
   try
   {
-    auto img1 = handler->read(file.absoluteFilePath()).front()->getImage();
-    if (subtractSky)
+    image = frames.getImage(index);
+    if (mode == Align::StarMatch && catalog) frame.stars = &catalogs.at(index);
+    if (subtractSky) subtractBackground(image);
+    if (weight != 1) image *= weight;
+    if (mode == Align::TemplateMatch)
     {
-      Histogram hist;
-      hist.build(img1);
-      AverageResult avg = hist.getAverage(0.75);
-      img1 -= avg.mean;
+      m->computeMatch(image);
+      frame.dx = m->getDx();
+      frame.dy = m->getDy();
+      if (!drizzle)
+      {
+        OpShift shift;
+        shift.shift(&image,-frame.dx,-frame.dy);
+      }
+      msg = QString::asprintf("stacked %s shifted by [%.1f,%.1f]",image.getName().toUtf8().data(),-m->getDx(),-m->getDy());
+    }
+    else
+    {
+      msg = "stacked  "+image.getName();
     }
-    matcher.computeMatch(img1);
-    OpShift shift;
-    shift.shift(&img1,-matcher.getDx(),-matcher.getDy());
-    img += img1;
-    log(&img,QString::asprintf("stacked %s shifted by [%.1f,%.1f]",img1.getName().toUtf8().data(),-matcher.getDx(),-matcher.getDy()));
-    qInfo() << "Stacked: " << img1.getName();
   }
   catch (std::exception& ex)
   {
@@ -268,52 +752,44 @@ OpPlugin::ResultType OpStack::stackTemplate(const QFileInfo &file)
   return OK;
 }
 
-OpPlugin::ResultType OpStack::stackStarMatch(const QFileInfo &file)
+OpPlugin::ResultType OpStack::alignStarMatch(PreparedFrame& frame)
 {
-  IOHandler* handler = IOFactory::getInstance()->getHandler(file.absoluteFilePath());
-  if (!handler)
-  {
-    qWarning() << "No handler found for"  << file.absoluteFilePath();
-    return ERROR;
-  }
+  FitsImage& image = frame.image;
+  QString& msg = frame.message;
   try
   {
-    auto img1 = handler->read(file.absoluteFilePath()).front()->getImage();
-    if (subtractSky)
+    ResultType res = catalog ? starmatcher.match(*frame.stars,image.getWidth(),image.getHeight()) : starmatcher.match(image);
+    if (res != OK)
+    {
+      if (catalog) qWarning() << image.getName() << "could not be matched by asterisms";
+      return res;
+    }
+    if (rotate)
     {
-      Histogram hist;
-      hist.build(img1);
-      AverageResult avg = hist.getAverage(0.75);
-      img1 -= avg.mean;
+      double angle = starmatcher.getAngle();
+      /* the angle fitted to the asterisms is always used */
+      if (fabs(angle) > 0.001 && (starmatcher.isAsterismMatch() || fabs(angle) < starmatcher.getAngleSigma()/2)) frame.angle = angle;
     }
-    ResultType res = starmatcher.match(img1);
-    if (res == OK)
+    frame.dx = starmatcher.getDx();
+    frame.dy = starmatcher.getDy();
+    /* a drizzle takes the alignment with the frame, otherwise it is applied here */
+    if (!drizzle)
     {
-      if (rotate)
+      if (frame.angle != 0)
       {
-        double angle = starmatcher.getAngle();
-        if (fabs(angle) > 0.001 && fabs(angle) < starmatcher.getAngleSigma()/2)
-        {
-          OpRotate rot;
-          rot.rotate(&img1,angle,true);
-        }
+        OpRotate rot;
+        rot.rotate(&image,frame.angle,true);
       }
       OpShift shift;
-      shift.shift(&img1,-starmatcher.getDx(),-starmatcher.getDy());
-      img += img1;
-      if (rotate)
-        log(&img,QString::asprintf("stacked %s rotated by %.3f°+-%.3f° shifted by [%.1f+-%.2f,%.1f+-%.2f]",img1.getName().toUtf8().data(),
-                                   starmatcher.getAngle(),starmatcher.getAngleSigma(),
-                                   -starmatcher.getDx(),starmatcher.getSigmadx(),-starmatcher.getDy(),starmatcher.getSigmady()));
-      else
-        log(&img,QString::asprintf("stacked %s shifted by [%.1f+-%.2f,%.1f+-%.2f]",img1.getName().toUtf8().data(),
-                                   -starmatcher.getDx(),starmatcher.getSigmadx(),-starmatcher.getDy(),starmatcher.getSigmady()));
-      qInfo() << "Stacked: " << img1.getName();
+      shift.shift(&image,-frame.dx,-frame.dy);
     }
+    if (rotate)
+      msg = QString::asprintf("stacked %s rotated by %.3f°+-%.3f° shifted by [%.1f+-%.2f,%.1f+-%.2f]",image.getName().toUtf8().data(),
+                              starmatcher.getAngle(),starmatcher.getAngleSigma(),
+                              -starmatcher.getDx(),starmatcher.getSigmadx(),-starmatcher.getDy(),starmatcher.getSigmady());
     else
-    {
-      return res;
-    }
+      msg = QString::asprintf("stacked %s shifted by [%.1f+-%.2f,%.1f+-%.2f]",image.getName().toUtf8().data(),
+                              -starmatcher.getDx(),starmatcher.getSigmadx(),-starmatcher.getDy(),starmatcher.getSigmady());
   }
   catch (std::exception& ex)
   {
@@ -323,3 +799,17 @@ OpPlugin::ResultType OpStack::stackStarMatch(const QFileInfo &file)
   return OK;
 }
 
+void OpStack::accumulate(const FitsImage& image)
+{
+  if (!img.isCompatible(image)) throw std::runtime_error("Incompatible fits image");
+  /* the pixels are independent, so the stripes can be added in parallel */
+  for (int d=0;d<img.getDepth();d++)
+  {
+    ValueType* p = img.getLayer(d).getData();
+    const ValueType* p1 = image.getLayer(d).getData();
+    int w = img.getWidth();
+    parallel::forRange(img.getHeight(),[=](int y0, int y1){
+      for (int i=y0*w;i<y1*w;++i) p[i] += p1[i];
+    },16);
+  }
+}
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - stack images                                                        *
  *                                                                              *
- * modified: 2025-10-26                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -25,13 +25,18 @@
 
 #include <fitsip/extensions/matching/measurematch.h>
 #include <fitsip/extensions/matching/findstars.h>
+#include <fitsip/extensions/matching/starcatalog.h>
 #include <fitsip/extensions/matching/starmatcher.h>
 #include <fitsip/core/opplugin.h>
 #include <fitsip/core/pixellist.h>
 #include <fitsip/core/starlist.h>
 #include <QObject>
+#include <memory>
 #include <vector>
 
+class FrameSequence;
+class RejectionStack;
+class ProgressDialog;
 class OpStackDialog;
 
 class OpStack: public OpPlugin
@@ -52,19 +57,45 @@ public:
 
   virtual ResultType execute(const std::vector<QFileInfo>& list, const OpPluginData& data=OpPluginData()) override;
 
+  virtual bool supportsBatch() const override;
+
+  virtual QStringList getBatchParameters() const override;
+
+  virtual ResultType executeBatch(const std::vector<QFileInfo>& list, const QVariantMap& params) override;
+
+  virtual ResultType executeBatch(const std::vector<std::shared_ptr<FitsObject>>& list, const QVariantMap& params) override;
+
 private:
-  ResultType prepare(const QFileInfo& file, bool subsky);
-  ResultType prepareTemplate(const QFileInfo& file, bool subsky, QRect aoi, bool full, int range);
-  ResultType prepareStarMatch(const QFileInfo& file, PixelList* pixellist, bool subsky, int searchbox, int starbox, bool rotate, double maxmove);
-  ResultType stack(const QFileInfo& file);
-  ResultType stackTemplate(const QFileInfo& file);
-  ResultType stackStarMatch(const QFileInfo& file);
+  ResultType stackBatch(const FrameSequence& sequence, const QVariantMap& params);
+  void stackFrames(const FrameSequence& frames, Align mode, ProgressDialog* prog);
+  ResultType prepare(const FrameSequence& frames, bool subsky);
+  ResultType prepareTemplate(const FrameSequence& frames, bool subsky, QRect aoi, bool full, int range);
+  ResultType prepareStarMatch(const FrameSequence& frames, PixelList* pixellist, bool subsky, int searchbox, int starbox, bool rotate, double maxmove);
+  std::unique_ptr<FrameSequence> selectFrames(const FrameSequence& frames, const QString& metric, double keep, bool weight);
+  struct PreparedFrame;
+  ResultType prepareFrame(const FrameSequence& frames, size_t index, Align mode, MeasureMatch* m, ValueType weight, PreparedFrame& frame) const;
+  ResultType alignStarMatch(PreparedFrame& frame);
+  void accumulate(const FitsImage& image);
+  void subtractBackground(FitsImage& image) const;
+  void setCombination(const QString& method, size_t frames);
+  void setDrizzle(double scale, double pixfrac);
 
   OpStackDialog* dlg;
   FitsImage img;
   bool subtractSky;
+  bool skyMap;                       // subtract a background map instead of a single sky value
   MeasureMatch matcher;
+  QRect templateAOI;
+  std::unique_ptr<RejectionStack> rejection;
+  bool drizzle;                      // frames are drizzled instead of shifted and rotated
+  double drizzleScale;
+  double drizzlePixfrac;
+  FitsImage weightMap;               // weight map of a drizzled stack
+  std::vector<double> weights;       // quality weights of the selected frames
+  QString selectionMessage;
   StarMatcher starmatcher;
+  std::unique_ptr<StarCatalog> catalog;  // star catalogs read from sidecar files (batch only)
+  std::vector<StarCatalog::Catalog> catalogs;  // catalogs of the frames in stacking order
   bool rotate;
 };
 
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - dialog to stack images                                              *
  *                                                                              *
- * modified: 2022-12-01                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -28,6 +28,16 @@ OpStackDialog::OpStackDialog(QWidget *parent) :
   ui(new Ui::OpStackDialog)
 {
   ui->setupUi(this);
+  connect(ui->combineBox,QOverload<int>::of(&QComboBox::currentIndexChanged),this,[this](int index){
+    /* percentile clipping uses fractions, the other methods sigmas */
+    QString limit = index == 5 ? "0.1" : "3";
+    ui->lowField->setText(limit);
+    ui->highField->setText(limit);
+    ui->lowField->setEnabled(index > 2 && index < 7);
+    ui->highField->setEnabled(index > 2 && index < 7);
+    ui->scaleField->setEnabled(index == 7);
+    ui->pixfracField->setEnabled(index == 7);
+  });
 }
 
 OpStackDialog::~OpStackDialog()
@@ -45,6 +55,11 @@ bool OpStackDialog::isSubtractSky() const
   return ui->subtractSkyBox->isChecked();
 }
 
+bool OpStackDialog::isSkyMap() const
+{
+  return ui->skyMapBox->isChecked();
+}
+
 bool OpStackDialog::isFullTemplateMatch() const
 {
   return ui->matchFullBox->isChecked();
@@ -75,3 +90,45 @@ int OpStackDialog::getStarMaxMovement() const
   return ui->maxMovementField->text().toInt();
 }
 
+QString OpStackDialog::getCombination() const
+{
+  static const char* methods[] = {"sum","average","median","sigma","winsorized","percentile","linearfit","drizzle"};
+  return methods[ui->combineBox->currentIndex()];
+}
+
+double OpStackDialog::getRejectionLow() const
+{
+  return ui->lowField->text().toDouble();
+}
+
+double OpStackDialog::getRejectionHigh() const
+{
+  return ui->highField->text().toDouble();
+}
+
+double OpStackDialog::getDrizzleScale() const
+{
+  return ui->scaleField->text().toDouble();
+}
+
+double OpStackDialog::getDrizzlePixfrac() const
+{
+  return ui->pixfracField->text().toDouble();
+}
+
+QString OpStackDialog::getQualityMetric() const
+{
+  static const char* metrics[] = {"none","sharpness","fwhm","noise","stars"};
+  return metrics[ui->qualityBox->currentIndex()];
+}
+
+double OpStackDialog::getKeepPercentage() const
+{
+  return ui->keepField->text().toDouble();
+}
+
+bool OpStackDialog::isWeightByQuality() const
+{
+  return ui->weightBox->isChecked();
+}
+
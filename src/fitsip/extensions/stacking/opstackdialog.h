@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - dialog to stack images                                              *
  *                                                                              *
- * modified: 2022-12-01                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -41,6 +41,8 @@ public:
 
   bool isSubtractSky() const;
 
+  bool isSkyMap() const;
+
   bool isFullTemplateMatch() const;
 
   int getTemplateMatchRange() const;
@@ -53,6 +55,22 @@ public:
 
   int getStarMaxMovement() const;
 
+  QString getCombination() const;
+
+  double getRejectionLow() const;
+
+  double getRejectionHigh() const;
+
+  double getDrizzleScale() const;
+
+  double getDrizzlePixfrac() const;
+
+  QString getQualityMetric() const;
+
+  double getKeepPercentage() const;
+
+  bool isWeightByQuality() const;
+
 private:
   Ui::OpStackDialog *ui;
 };
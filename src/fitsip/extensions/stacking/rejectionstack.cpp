@@ -0,0 +1,417 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - rejection stacking                                                  *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#include "rejectionstack.h"
+#include <fitsip/core/parallel.h>
+#include <QDir>
+#include <QFile>
+#include <QTemporaryDir>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+namespace
+{
+
+/* a value of a weighted frame; the weight moves with the value when the values are reordered */
+struct Sample
+{
+  ValueType value;
+  ValueType weight;
+};
+
+bool operator<(const Sample& a, const Sample& b)
+{
+  return a.value < b.value;
+}
+
+inline ValueType value(ValueType v)
+{
+  return v;
+}
+
+inline ValueType value(const Sample& s)
+{
+  return s.value;
+}
+
+/* the loops over contiguous values are kept simple, so they are vectorized by the compiler */
+
+template <class T>
+double mean(const T* v, int n)
+{
+  double sum = 0;
+  for (int i=0;i<n;++i) sum += value(v[i]);
+  return sum / n;
+}
+
+double weightedMean(const ValueType* v, int n)
+{
+  return mean(v,n);
+}
+
+double weightedMean(const Sample* v, int n)
+{
+  double sum = 0;
+  double weights = 0;
+  for (int i=0;i<n;++i)
+  {
+    sum += static_cast<double>(v[i].weight) * v[i].value;
+    weights += v[i].weight;
+  }
+  return weights > 0 ? sum / weights : mean(v,n);
+}
+
+template <class T>
+double stddev(const T* v, int n, double m)
+{
+  double sum = 0;
+  for (int i=0;i<n;++i) sum += (value(v[i]) - m) * (value(v[i]) - m);
+  return n > 1 ? sqrt(sum/(n-1)) : 0;
+}
+
+/* reorders the values */
+template <class T>
+double median(T* v, int n)
+{
+  int m = n / 2;
+  std::nth_element(v,v+m,v+n);
+  double med = value(v[m]);
+  if (n % 2 == 0) med = (med + value(*std::max_element(v,v+m))) / 2;
+  return med;
+}
+
+/* moves the values within [lo,hi] to the front and returns their count */
+template <class T>
+int keep(T* v, int n, double lo, double hi)
+{
+  int k = 0;
+  for (int i=0;i<n;++i)
+  {
+    if (value(v[i]) >= lo && value(v[i]) <= hi) v[k++] = v[i];
+  }
+  return k;
+}
+
+}
+
+RejectionStack::RejectionStack(Method method, size_t frames, uint64_t budget):
+  method(method),
+  expectedFrames(std::max<size_t>(1,frames)),
+  budget(budget),
+  low(method == PercentileClip ? 0.1 : 3),
+  high(method == PercentileClip ? 0.1 : 3),
+  iterations(5),
+  width(0),
+  height(0),
+  depth(0),
+  bandRows(0),
+  frameCount(0),
+  rejectedFraction(0)
+{
+}
+
+RejectionStack::~RejectionStack()
+{
+}
+
+RejectionStack::Method RejectionStack::getMethod(const QString& name)
+{
+  QString s = name.toLower();
+  if (s == "average") return Average;
+  if (s == "median") return Median;
+  if (s == "sigma") return SigmaClip;
+  if (s == "winsorized") return WinsorizedSigmaClip;
+  if (s == "percentile") return PercentileClip;
+  if (s == "linearfit") return LinearFitClip;
+  throw std::invalid_argument(("unknown combination method "+name).toStdString());
+}
+
+QString RejectionStack::getName(Method method)
+{
+  switch (method)
+  {
+    case Average:
+      return "average";
+    case Median:
+      return "median";
+    case SigmaClip:
+      return "kappa-sigma clipping";
+    case WinsorizedSigmaClip:
+      return "winsorized sigma clipping";
+    case PercentileClip:
+      return "percentile clipping";
+    case LinearFitClip:
+      return "linear fit clipping";
+  }
+  return QString();
+}
+
+RejectionStack::Method RejectionStack::getMethod() const
+{
+  return method;
+}
+
+void RejectionStack::setLimits(double low, double high)
+{
+  this->low = low;
+  this->high = high;
+}
+
+void RejectionStack::setIterations(int n)
+{
+  iterations = std::max(1,n);
+}
+
+void RejectionStack::add(const FitsImage& image, double weight)
+{
+  if (frameCount == 0)
+  {
+    width = image.getWidth();
+    height = image.getHeight();
+    depth = image.getDepth();
+    uint64_t rowBytes = static_cast<uint64_t>(width) * depth * sizeof(ValueType);
+    uint64_t rows = budget / 2 / (expectedFrames * rowBytes);
+    bandRows = static_cast<int>(std::max<uint64_t>(1,std::min<uint64_t>(height,rows)));
+    size_t count = (height + bandRows - 1) / bandRows;
+    if (expectedFrames * rowBytes * height > budget)
+    {
+      scratchDir = std::make_unique<QTemporaryDir>();
+      if (!scratchDir->isValid()) throw std::runtime_error("cannot create scratch directory");
+    }
+    else
+    {
+      bands.resize(count);
+    }
+  }
+  else if (image.getWidth() != width || image.getHeight() != height || image.getDepth() != depth)
+  {
+    throw std::runtime_error("Incompatible fits image");
+  }
+  size_t count = (height + bandRows - 1) / bandRows;
+  for (size_t b=0;b<count;++b)
+  {
+    int y0 = static_cast<int>(b) * bandRows;
+    size_t n = static_cast<size_t>(std::min(bandRows,height-y0)) * width;
+    if (scratchDir)
+    {
+      QFile file(bandFile(b));
+      if (!file.open(QFile::WriteOnly|QFile::Append)) throw std::runtime_error("cannot write "+file.fileName().toStdString());
+      for (int d=0;d<depth;++d)
+      {
+        const char* p = reinterpret_cast<const char*>(image.getLayer(d).getData()+static_cast<size_t>(y0)*width);
+        qint64 bytes = static_cast<qint64>(n*sizeof(ValueType));
+        if (file.write(p,bytes) != bytes) throw std::runtime_error("cannot write "+file.fileName().toStdString());
+      }
+    }
+    else
+    {
+      std::vector<ValueType>& band = bands[b];
+      for (int d=0;d<depth;++d)
+      {
+        const ValueType* p = image.getLayer(d).getData()+static_cast<size_t>(y0)*width;
+        band.insert(band.end(),p,p+n);
+      }
+    }
+  }
+  weights.push_back(static_cast<ValueType>(weight));
+  ++frameCount;
+}
+
+size_t RejectionStack::getFrameCount() const
+{
+  return frameCount;
+}
+
+FitsImage RejectionStack::combine(const QString& name)
+{
+  if (frameCount == 0) return FitsImage();
+  FitsImage result(name,width,height,depth);
+  int frames = static_cast<int>(frameCount);
+  size_t count = (height + bandRows - 1) / bandRows;
+  std::atomic<uint64_t> rejected(0);
+  bool weighted = std::any_of(weights.begin(),weights.end(),[](ValueType w){ return w != 1; });
+  std::vector<ValueType> buffer;
+  for (size_t b=0;b<count;++b)
+  {
+    int y0 = static_cast<int>(b) * bandRows;
+    int rows = std::min(bandRows,height-y0);
+    /* values of one frame in the band: all layers of the rows */
+    size_t size = bandSize(b);
+    const ValueType* values;
+    if (scratchDir)
+    {
+      buffer.resize(size*frameCount);
+      QFile file(bandFile(b));
+      qint64 bytes = static_cast<qint64>(buffer.size()*sizeof(ValueType));
+      if (!file.open(QFile::ReadOnly) || file.read(reinterpret_cast<char*>(buffer.data()),bytes) != bytes)
+      {
+        throw std::runtime_error("cannot read "+file.fileName().toStdString());
+      }
+      file.close();
+      file.remove();
+      values = buffer.data();
+    }
+    else
+    {
+      values = bands[b].data();
+    }
+    size_t layerSize = static_cast<size_t>(rows) * width;
+    parallel::forRange(static_cast<int>(size),[&](int p0, int p1){
+      std::vector<ValueType> column(2*frames);
+      std::vector<Sample> samples(weighted ? frames : 0);
+      uint64_t n = 0;
+      for (int p=p0;p<p1;++p)
+      {
+        int r = 0;
+        ValueType v;
+        if (weighted)
+        {
+          for (int f=0;f<frames;++f) samples[f] = { values[static_cast<size_t>(f)*size+p], weights[f] };
+          v = combinePixel(samples.data(),column.data(),frames,r);
+        }
+        else
+        {
+          for (int f=0;f<frames;++f) column[f] = values[static_cast<size_t>(f)*size+p];
+          v = combinePixel(column.data(),column.data()+frames,frames,r);
+        }
+        n += r;
+        size_t d = p / layerSize;
+        result.getLayer(static_cast<int>(d)).getData()[static_cast<size_t>(y0)*width+p%layerSize] = v;
+      }
+      rejected += n;
+    },1024);
+    if (!scratchDir) std::vector<ValueType>().swap(bands[b]);
+  }
+  bands.clear();
+  weights.clear();
+  rejectedFraction = static_cast<double>(rejected) / (static_cast<double>(frameCount)*width*height*depth);
+  return result;
+}
+
+double RejectionStack::getRejectedFraction() const
+{
+  return rejectedFraction;
+}
+
+template <class T>
+ValueType RejectionStack::combinePixel(T* v, ValueType* w, int n, int& rejected) const
+{
+  int count = n;
+  switch (method)
+  {
+    case Average:
+      break;
+    case Median:
+      return static_cast<ValueType>(median(v,n));
+    case SigmaClip:
+      for (int it=0;it<iterations && n>2;++it)
+      {
+        double m = mean(v,n);
+        double s = stddev(v,n,m);
+        if (s <= 0) break;
+        double med = median(v,n);
+        int k = keep(v,n,med-low*s,med+high*s);
+        if (k == n || k == 0) break;
+        n = k;
+      }
+      break;
+    case WinsorizedSigmaClip:
+    {
+      /* the sigma is estimated from values clamped to 1.5 sigma around the median */
+      for (int it=0;it<iterations && n>2;++it)
+      {
+        for (int i=0;i<n;++i) w[i] = value(v[i]);
+        double med = median(w,n);
+        double s = stddev(w,n,mean(w,n));
+        for (int j=0;j<10 && s>0;++j)
+        {
+          ValueType lo = static_cast<ValueType>(med-1.5*s);
+          ValueType hi = static_cast<ValueType>(med+1.5*s);
+          for (int i=0;i<n;++i) w[i] = std::min(std::max(w[i],lo),hi);
+          double s1 = 1.134 * stddev(w,n,mean(w,n));
+          bool converged = fabs(s1-s) < 0.0005*s;
+          s = s1;
+          if (converged) break;
+        }
+        if (s <= 0) break;
+        int k = keep(v,n,med-low*s,med+high*s);
+        if (k == n || k == 0) break;
+        n = k;
+      }
+      break;
+    }
+    case PercentileClip:
+    {
+      std::sort(v,v+n);
+      int lo = static_cast<int>(n*low);
+      int hi = static_cast<int>(n*high);
+      if (lo + hi >= n) lo = hi = (n - 1) / 2;
+      v += lo;
+      n -= lo + hi;
+      break;
+    }
+    case LinearFitClip:
+      /* fit a line to the sorted values and reject by the distance to the line */
+      for (int it=0;it<iterations && n>3;++it)
+      {
+        std::sort(v,v+n);
+        double sx = 0, sy = 0, sxx = 0, sxy = 0;
+        for (int i=0;i<n;++i)
+        {
+          sx += i;
+          sy += value(v[i]);
+          sxx += static_cast<double>(i) * i;
+          sxy += i * static_cast<double>(value(v[i]));
+        }
+        double b = (n*sxy - sx*sy) / (n*sxx - sx*sx);
+        double a = (sy - b*sx) / n;
+        double s = 0;
+        for (int i=0;i<n;++i) s += fabs(value(v[i]) - a - b*i);
+        s /= n;
+        if (s <= 0) break;
+        int k = 0;
+        for (int i=0;i<n;++i)
+        {
+          double d = value(v[i]) - a - b*i;
+          if (d >= -low*s && d <= high*s) v[k++] = v[i];
+        }
+        if (k == n || k == 0) break;
+        n = k;
+      }
+      break;
+  }
+  rejected += count - n;
+  return static_cast<ValueType>(weightedMean(v,n));
+}
+
+size_t RejectionStack::bandSize(size_t band) const
+{
+  int y0 = static_cast<int>(band) * bandRows;
+  return static_cast<size_t>(std::min(bandRows,height-y0)) * width * depth;
+}
+
+QString RejectionStack::bandFile(size_t band) const
+{
+  return QDir(scratchDir->path()).filePath(QString("band%1.raw").arg(band,5,10,QChar('0')));
+}
@@ -0,0 +1,134 @@
+/********************************************************************************
+ *                                                                              *
+ * FitsIP - rejection stacking                                                  *
+ *                                                                              *
+ * modified: 2026-10-19                                                         *
+ *                                                                              *
+ ********************************************************************************
+ * Copyright (C) Harald Braeuning                                               *
+ ********************************************************************************
+ * This file is part of FitsIP.                                                 *
+ * FitsIP is free software: you can redistribute it and/or modify it            *
+ * under the terms of the GNU General Public License as published by the Free   *
+ * Software Foundation, either version 3 of the License, or (at your option)    *
+ * any later version.                                                           *
+ * FitsIP is distributed in the hope that it will be useful, but                *
+ * WITHOUT ANY WARRANTY; without even the implied warranty of MERCHANTABILITY   *
+ * or FITNESS FOR A PARTICULAR PURPOSE. See the GNU General Public License for  *
+ * more details.                                                                *
+ * You should have received a copy of the GNU General Public License along with *
+ * FitsIP. If not, see <https://www.gnu.org/licenses/>.                         *
+ ********************************************************************************/
+
+#ifndef REJECTIONSTACK_H
+#define REJECTIONSTACK_H
+
+#include <fitsip/core/fitsimage.h>
+#include <QString>
+#include <memory>
+#include <vector>
+
+class QTemporaryDir;
+
+/**
+ * @brief Combines a stack of frames pixel by pixel with outlier rejection.
+ *
+ * The frames are added one after the other and split into bands of rows.
+ * The bands are kept in memory as long as the whole stack fits into the
+ * memory budget, otherwise every band is appended to a scratch file. The
+ * combination processes one band at a time, so only the column of all
+ * frames for that band is held in memory. The band height is chosen from
+ * the expected number of frames to fit half of the budget.
+ */
+class RejectionStack
+{
+public:
+  enum Method { Average, Median, SigmaClip, WinsorizedSigmaClip, PercentileClip, LinearFitClip };
+
+  /**
+   * @brief Constructor.
+   * @param method the combination method
+   * @param frames the expected number of frames
+   * @param budget the memory budget in bytes
+   */
+  RejectionStack(Method method, size_t frames, uint64_t budget);
+  ~RejectionStack();
+
+  /**
+   * @brief Get the method for a name used in batch parameters.
+   *
+   * Throws a std::invalid_argument for unknown names.
+   * @param name average, median, sigma, winsorized, percentile or linearfit
+   * @return the method
+   */
+  static Method getMethod(const QString& name);
+
+  static QString getName(Method method);
+
+  Method getMethod() const;
+
+  /**
+   * @brief Set the rejection limits.
+   *
+   * For the sigma and linear fit methods the limits are multiples of the
+   * standard deviation (default 3); for percentile clipping they are the
+   * fractions of the lowest and highest values removed (default 0.1).
+   * @param low the lower limit
+   * @param high the upper limit
+   */
+  void setLimits(double low, double high);
+
+  void setIterations(int n);
+
+  /**
+   * @brief Add a frame.
+   *
+   * The frames are clipped at their own scale; the weight is only applied
+   * to the mean of the values that survived the rejection. The median
+   * method ignores the weights.
+   * Throws a std::runtime_error if the frame does not fit the first one or
+   * the scratch file cannot be written.
+   * @param image the frame
+   * @param weight the weight of the frame
+   */
+  void add(const FitsImage& image, double weight=1);
+
+  size_t getFrameCount() const;
+
+  /**
+   * @brief Combine the frames.
+   * @param name the name of the resulting image
+   * @return the combined image
+   */
+  FitsImage combine(const QString& name);
+
+  /**
+   * @brief Get the fraction of values rejected by the last combination.
+   * @return the fraction
+   */
+  double getRejectedFraction() const;
+
+private:
+  template <class T>
+  ValueType combinePixel(T* v, ValueType* work, int n, int& rejected) const;
+  size_t bandSize(size_t band) const;
+  QString bandFile(size_t band) const;
+
+  Method method;
+  size_t expectedFrames;
+  uint64_t budget;
+  double low;
+  double high;
+  int iterations;
+  int width;
+  int height;
+  int depth;
+  int bandRows;
+  size_t frameCount;
+  double rejectedFraction;
+  std::vector<std::vector<ValueType>> bands;
+  std::vector<ValueType> weights;
+  std::unique_ptr<QTemporaryDir> scratchDir;
+};
+
+#endif // REJECTIONSTACK_H
@@ -2,7 +2,7 @@
  *                                                                              *
  * FitsIP - vanCittert deconvolution                                            *
  *                                                                              *
- * modified: 2025-11-03                                                         *
+ * modified: 2026-10-19                                                         *
  *                                                                              *
  ********************************************************************************
  * Copyright (C) Harald Braeuning                                               *
@@ -26,10 +26,12 @@
 #include <fitsip/core/fitsimage.h>
 #include <fitsip/core/dialogs/progressdialog.h>
 #include <fitsip/core/io/iofactory.h>
+#include <fitsip/core/parallel.h>
 #include <fitsip/core/psf/psf.h>
 #include <fitsip/core/psf/psffactory.h>
 #include <QApplication>
 #include <QDebug>
+#include <QMutexLocker>
 
 VanCittertDeconvolution::VanCittertDeconvolution():
   cutImage(false),
@@ -125,8 +127,11 @@ void VanCittertDeconvolution::deconvolve(FitsImage* image, const PSF* psf, const
   data.fftsize = (w0 / 2 + 1) * h0;
   data.cinout = new fftw_complex[data.fftsize];
   data.rinout = new double[h0*w0];
-  data.r2c = fftw_plan_dft_r2c_2d(h0,w0,data.rinout,data.cinout,FFTW_ESTIMATE);
-  data.c2r = fftw_plan_dft_c2r_2d(h0,w0,data.cinout,data.rinout,FFTW_ESTIMATE);
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    data.r2c = fftw_plan_dft_r2c_2d(h0,w0,data.rinout,data.cinout,FFTW_ESTIMATE);
+    data.c2r = fftw_plan_dft_c2r_2d(h0,w0,data.cinout,data.rinout,FFTW_ESTIMATE);
+  }
   fft(data,h,0);
   fftw_complex* hfft = new fftw_complex[data.fftsize];
   memcpy(hfft,data.cinout,data.fftsize*sizeof(fftw_complex));
@@ -177,12 +182,13 @@ void VanCittertDeconvolution::deconvolve(FitsImage* image, const PSF* psf, const
     }
     if (storeintermediate)
     {
-      QString fnc = path + "/c_" + QString::number(niter-remain) + ".fts";
+      /* intermediate results are written in the fast scratch format */
+      QString fnc = path + "/c_" + QString::number(niter-remain) + ".fsc";
       IOHandler *io = IOFactory::getInstance()->getHandler(fnc);
       io->write(fnc,c);
-      QString fns = path + "/s_" + QString::number(niter-remain) + ".fts";
+      QString fns = path + "/s_" + QString::number(niter-remain) + ".fsc";
       io->write(fns,s);
-      QString fno = path + "/o_" + QString::number(niter-remain) + ".fts";
+      QString fno = path + "/o_" + QString::number(niter-remain) + ".fsc";
       io->write(fno,o);
     }
     qInfo() << "remaining" << remain << " stddev=" << stat.getGlobalStatistics().stddev;
@@ -194,8 +200,11 @@ void VanCittertDeconvolution::deconvolve(FitsImage* image, const PSF* psf, const
       if (prog->isCancelled()) break;
     }
   }
-  fftw_destroy_plan(data.r2c);
-  fftw_destroy_plan(data.c2r);
+  {
+    QMutexLocker lock(&parallel::getPlannerMutex());
+    fftw_destroy_plan(data.r2c);
+    fftw_destroy_plan(data.c2r);
+  }
   delete [] data.rinout;
   delete [] data.cinout;
   delete [] offt1;
@@ -0,0 +1,63 @@
+
+#include <fitsip/extensions/matching/asterismmatcher.h>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*
+ * Matches a synthetic catalog of 1500 stars to a rotated and shifted copy
+ * with 15% of the stars dropped, 100 spurious stars and noisy positions,
+ * once as it is and once flipped by 180 degree (meridian flip). The fitted
+ * transformation must map the frame stars onto their reference stars.
+ */
+int main(int argc, char* argv[])
+{
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<double> uniform(0,1);
+  std::normal_distribution<double> noise(0,0.2);
+  std::vector<AsterismMatcher::Point> reference;
+  for (int i=0;i<1500;i++) reference.push_back({uniform(rng)*4000,uniform(rng)*3000,pow(uniform(rng),4)*1000});
+  double angle = 1.3 * M_PI / 180;
+  double tx = 150.5;
+  double ty = -80.2;
+  int failed = 0;
+  for (int flip=0;flip<2;flip++)
+  {
+    double a = flip ? angle + M_PI : angle;
+    std::vector<AsterismMatcher::Point> frame;
+    std::vector<size_t> source;
+    for (size_t i=0;i<reference.size();i++)
+    {
+      if (uniform(rng) < 0.15) continue;
+      /* the reference position is the rotated frame position plus the shift */
+      double qx = reference[i].x - tx;
+      double qy = reference[i].y - ty;
+      frame.push_back({cos(a)*qx+sin(a)*qy+noise(rng),-sin(a)*qx+cos(a)*qy+noise(rng),reference[i].flux*(0.8+0.4*uniform(rng))});
+      source.push_back(i);
+    }
+    size_t stars = frame.size();
+    for (int i=0;i<100;i++) frame.push_back({uniform(rng)*4000-2000,uniform(rng)*3000,uniform(rng)*500});
+    for (AsterismMatcher::Model model : {AsterismMatcher::Similarity,AsterismMatcher::Affine,AsterismMatcher::Homography})
+    {
+      AsterismMatcher matcher;
+      matcher.setModel(model);
+      matcher.setReference(reference);
+      bool ok = matcher.match(frame);
+      const Eigen::Matrix3d& h = matcher.getTransform();
+      double sum = 0;
+      for (size_t i=0;i<stars;i++)
+      {
+        Eigen::Vector3d p = h * Eigen::Vector3d(frame[i].x,frame[i].y,1);
+        sum += pow(p(0)/p(2)-reference[source[i]].x,2) + pow(p(1)/p(2)-reference[source[i]].y,2);
+      }
+      double rms = sqrt(sum/stars);
+      double fitted = atan2(h(1,0)-h(0,1),h(0,0)+h(1,1));
+      double error = std::remainder(fitted-a,2*M_PI) * 180 / M_PI;
+      std::cout << "Asterism flip " << flip << " model " << model << ": matched " << matcher.getMatchCount() << " of " << stars
+                << " stars, rms " << rms << ", angle error " << error << std::endl;
+      if (!ok || matcher.getMatchCount() < static_cast<int>(stars*0.9) || rms > 0.5 || fabs(error) > 0.01) failed++;
+    }
+  }
+  return failed > 0 ? 1 : 0;
+}
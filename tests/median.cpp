@@ -0,0 +1,86 @@
+
+#include <fitsip/extensions/filter/opmedian.h>
+#include <fitsip/core/fitsimage.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+/*
+ * Compares OpMedian::filter with a brute force median filter, which sorts
+ * every window (NaN sorted as +inf) and takes sigma = (q3 - q1) / 2 with
+ * q1 = w[n/4] and q3 = w[3n/4] of the sorted window.
+ */
+static void bruteForce(FitsImage* image, ValueType threshold, int size)
+{
+  FitsImage src(*image);
+  int w = image->getWidth();
+  int h = image->getHeight();
+  int s2 = size / 2;
+  for (int d=0;d<image->getDepth();d++)
+  {
+    const ValueType* p = src.getLayer(d).getData();
+    ValueType* q = image->getLayer(d).getData();
+    for (int y0=s2;y0<h-s2;y0++)
+    {
+      for (int x0=s2;x0<w-s2;x0++)
+      {
+        std::vector<ValueType> window;
+        for (int y=y0-s2;y<y0-s2+size;y++)
+        {
+          for (int x=x0-s2;x<x0-s2+size;x++)
+          {
+            ValueType v = p[y*w+x];
+            window.push_back(std::isnan(v) ? INFINITY : v);
+          }
+        }
+        std::sort(window.begin(),window.end());
+        size_t n = window.size();
+        ValueType median = window[n/2];
+        ValueType sigma = (window[3*n/4] - window[n/4]) / 2;
+        ValueType& v = q[y0*w+x0];
+        if (v > median + threshold * sigma || v < median - threshold * sigma) v = median;
+      }
+    }
+  }
+}
+
+int main(int argc, char* argv[])
+{
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> uniform(0,100);
+  int failed = 0;
+  for (int size : {2,3,4,5,7,9})
+  {
+    for (ValueType threshold : {0.0f,1.5f})
+    {
+      FitsImage a("median",57,43,2);
+      for (int d=0;d<a.getDepth();d++)
+      {
+        ValueType* p = a.getLayer(d).getData();
+        /* few distinct values, so the windows are full of duplicates */
+        for (int i=0;i<a.getWidth()*a.getHeight();i++) p[i] = std::floor(uniform(rng)/5);
+      }
+      a.getLayer(0).getData()[100] = NAN;
+      a.getLayer(0).getData()[101] = NAN;
+      a.getLayer(1).getData()[500] = -0.0f;
+      FitsImage b(a);
+      OpMedian().filter(&a,threshold,size);
+      bruteForce(&b,threshold,size);
+      int diff = 0;
+      for (int d=0;d<a.getDepth();d++)
+      {
+        const ValueType* p = a.getLayer(d).getData();
+        const ValueType* q = b.getLayer(d).getData();
+        for (int i=0;i<a.getWidth()*a.getHeight();i++)
+        {
+          if (!(p[i] == q[i] || (std::isnan(p[i]) && std::isnan(q[i])))) diff++;
+        }
+      }
+      std::cout << "Median size " << size << " threshold " << threshold << ": " << diff << " differences" << std::endl;
+      if (diff > 0) failed++;
+    }
+  }
+  return failed > 0 ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+
+#include <fitsip/core/spatialindex.h>
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <random>
+#include <vector>
+
+/*
+ * Compares the queries of SpatialIndex with brute force searches over a
+ * point set with duplicates and many equal distances (points on a grid).
+ */
+
+static double distance2(const QPointF& a, const QPointF& b)
+{
+  double dx = a.x() - b.x();
+  double dy = a.y() - b.y();
+  return dx * dx + dy * dy;
+}
+
+static int check(const std::vector<QPointF>& points, const std::vector<QPointF>& queries)
+{
+  SpatialIndex index(points);
+  int errors = 0;
+  for (const QPointF& q : queries)
+  {
+    std::vector<double> d(points.size());
+    for (size_t i=0;i<points.size();i++) d[i] = distance2(points[i],q);
+    std::vector<double> sorted(d);
+    std::sort(sorted.begin(),sorted.end());
+    for (double r : {0.0,1.0,2.5,40.0})
+    {
+      std::vector<size_t> found = index.findInRadius(q,r);
+      std::vector<size_t> expected;
+      for (size_t i=0;i<points.size();i++) if (d[i] <= r * r) expected.push_back(i);
+      std::sort(found.begin(),found.end());
+      if (found != expected) errors++;
+      long closest = index.findClosest(q,r);
+      if (expected.empty() ? closest != -1 : closest < 0 || d[closest] != sorted[0]) errors++;
+    }
+    for (size_t k : {static_cast<size_t>(1),static_cast<size_t>(4),points.size(),points.size()+5})
+    {
+      for (double maxdist : {3.0,std::numeric_limits<double>::infinity()})
+      {
+        std::vector<size_t> found = index.findNearest(q,k,maxdist);
+        size_t within = std::count_if(sorted.begin(),sorted.end(),[maxdist](double v){ return v <= maxdist * maxdist; });
+        if (found.size() != std::min(k,within))
+        {
+          errors++;
+          continue;
+        }
+        /* nearest first; with ties any of the equally distant points will do */
+        for (size_t j=0;j<found.size();j++) if (d[found[j]] != sorted[j]) errors++;
+        std::vector<size_t> unique(found);
+        std::sort(unique.begin(),unique.end());
+        if (std::unique(unique.begin(),unique.end()) != unique.end()) errors++;
+      }
+    }
+    QRectF rect(q.x()-3,q.y()-2,6,4);
+    std::vector<size_t> found = index.findInRect(rect);
+    std::vector<size_t> expected;
+    for (size_t i=0;i<points.size();i++)
+    {
+      const QPointF& p = points[i];
+      if (p.x() >= rect.left() && p.x() <= rect.right() && p.y() >= rect.top() && p.y() <= rect.bottom()) expected.push_back(i);
+    }
+    std::sort(found.begin(),found.end());
+    if (found != expected) errors++;
+  }
+  return errors;
+}
+
+int main(int argc, char* argv[])
+{
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> uniform(0,50);
+  std::vector<QPointF> points;
+  for (int y=0;y<20;y++)
+  {
+    for (int x=0;x<20;x++) points.push_back(QPointF(x*2,y*2));
+  }
+  for (int i=0;i<600;i++) points.push_back(QPointF(uniform(rng),uniform(rng)));
+  /* duplicates of grid and random points */
+  for (size_t i=0;i<points.size();i+=37) points.push_back(points[i]);
+  points.push_back(points[0]);
+  std::vector<QPointF> queries;
+  for (int i=0;i<100;i++) queries.push_back(QPointF(uniform(rng),uniform(rng)));
+  /* on and between grid points, so many points are equally distant */
+  for (int i=0;i<30;i++) queries.push_back(QPointF(std::floor(uniform(rng)),std::floor(uniform(rng))));
+  queries.push_back(QPointF(-100,-100));
+  int errors = check(points,queries);
+  std::cout << "SpatialIndex with " << points.size() << " points: " << errors << " errors" << std::endl;
+  /* fewer points than a leaf and than k */
+  std::vector<QPointF> few = {QPointF(1,1),QPointF(1,1),QPointF(3,1)};
+  int e = check(few,queries);
+  std::cout << "SpatialIndex with " << few.size() << " points: " << e << " errors" << std::endl;
+  errors += e;
+  SpatialIndex empty;
+  if (!empty.findNearest(QPointF(1,1),3).empty() || empty.findClosest(QPointF(1,1)) != -1 ||
+      !empty.findInRadius(QPointF(1,1),10).empty() || !empty.findInRect(QRectF(0,0,10,10)).empty())
+  {
+    std::cout << "SpatialIndex: queries on an empty index failed" << std::endl;
+    errors++;
+  }
+  return errors > 0 ? 1 : 0;
+}